@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+/**
+ * @brief Stands in for the compiler, moc and uic, so benchmarks only measure kole itself.
+ *
+ * Writes a tiny file to the path given with '-o' and, if a dependency file is requested
+ * ('-MD', '-MMD' or '-MF'), lists the headers the source includes in it, like gcc would.
+ * Nothing is compiled, so a build takes as long as kole needs to scan, generate commands and spawn them.
+ */
+namespace FakeCompiler
+{
+    /**
+     * @brief Checks if the benchmark binary was called as one of the fake tools (through a symlink).
+     */
+    bool IsFakeTool(const std::string& name);
+
+    /**
+     * @brief Runs the fake tool with the command-line arguments it was given.
+     *
+     * @return The exit code of the tool.
+     */
+    int Run(int argc, char** argv);
+}
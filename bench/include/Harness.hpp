@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include <filesystem>
+
+#include "ProjectGenerator.hpp"
+
+namespace fs = std::filesystem;
+
+struct HarnessOptions
+{
+    // The kole binary being measured
+    fs::path kole;
+
+    // Number of times every scenario is run
+    std::size_t runs = 5;
+
+    // Passed to kole as '--jobs', 0 leaves it to kole
+    std::size_t jobs = 0;
+};
+
+/**
+ * @brief Times kole on a generated project in the situations that matter day to day.
+ *
+ * Scenarios:
+ * - cold: nothing was built yet
+ * - noop: everything is up to date
+ * - source: a single source file changed
+ * - header: a single header changed
+ * - rebuild: everything is built again with '--rebuild'
+ */
+class Harness
+{
+public:
+    Harness(const ProjectGenerator& generator, const HarnessOptions& options) : m_generator(generator), m_options(options) {}
+
+    /**
+     * @brief Runs every scenario and prints a table of the results.
+     *
+     * @return False if kole failed in any of the runs.
+     */
+    bool Run();
+
+private:
+    struct Sample
+    {
+        // Wall time of the kole process, in milliseconds
+        double wallTime;
+
+        // CPU time of kole and everything it ran, in milliseconds
+        double cpuTime;
+    };
+
+    /**
+     * @brief Runs a scenario the configured number of times.
+     *
+     * @param name The name shown in the results.
+     * @param prepare Called before every run, to put the project in the state the scenario needs.
+     * @param arguments Extra arguments passed to kole.
+     */
+    bool RunScenario(const std::string& name, const std::function<void()>& prepare, const std::vector<std::string>& arguments);
+
+    /**
+     * @brief Runs kole once in the project directory, with its output discarded.
+     *
+     * @return False if kole couldn't be started or failed.
+     */
+    bool RunKole(const std::vector<std::string>& arguments, Sample& sample);
+
+    /**
+     * @brief Removes everything earlier builds left behind.
+     */
+    void Clean();
+
+    /**
+     * @brief Marks a file as changed by moving its modification time to now.
+     */
+    void Touch(const fs::path& path);
+
+    void PrintResult(const std::string& name, std::vector<Sample> samples);
+
+private:
+    const ProjectGenerator& m_generator;
+    HarnessOptions m_options;
+};
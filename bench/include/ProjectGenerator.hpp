@@ -0,0 +1,88 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+struct GeneratorOptions
+{
+    // Number of source files, every one of them gets a header of its own
+    std::size_t files = 1000;
+
+    // Number of other headers every source file includes
+    std::size_t fanout = 8;
+
+    // Number of nested directories the files are spread over
+    std::size_t depth = 2;
+
+    // Adds UI files and compiles the headers with moc
+    bool qt = false;
+
+    // Number of excluded directories (and exclude patterns in the config)
+    std::size_t excludes = 0;
+
+    // The compiler written to the config
+    std::string compiler = "fake-cc";
+};
+
+/**
+ * @brief Generates a synthetic kole project.
+ *
+ * The project is deterministic for the same options, so numbers from different runs can be compared.
+ */
+class ProjectGenerator
+{
+public:
+    ProjectGenerator(fs::path root, const GeneratorOptions& options) : m_root(root), m_options(options) {}
+
+    /**
+     * @brief Writes the project, replacing one generated earlier.
+     *
+     * Refuses to touch a directory that wasn't created by the generator.
+     *
+     * @return False if the project couldn't be written.
+     */
+    bool Generate();
+
+    /**
+     * @brief Gets the path of a source file, relative to the project root.
+     */
+    fs::path GetSourcePath(std::size_t unit) const;
+
+    /**
+     * @brief Gets the path of a header, relative to the include directory.
+     */
+    fs::path GetHeaderPath(std::size_t unit) const;
+
+    const fs::path& GetRoot() const { return m_root; }
+
+private:
+    /**
+     * @brief Gets the nested directory a unit is placed in (e.g. 'd1/d3').
+     */
+    fs::path GetUnitDirectory(std::size_t unit) const;
+
+    void WriteConfig();
+    void WriteUnit(std::size_t unit);
+    void WriteForm(std::size_t form);
+    void WriteExcludedDirectory(std::size_t index);
+
+    void WriteFile(const fs::path& path, const std::string& content);
+
+private:
+    fs::path m_root;
+    GeneratorOptions m_options;
+
+    // Written to the root, so a directory is only ever removed if the generator created it
+    static constexpr const char* m_markerFile = ".kole-bench";
+
+    // Number of subdirectories on every level of nesting
+    static constexpr std::size_t m_branching = 4;
+
+    // Every tenth unit uses Qt (a Q_OBJECT header and a form) if Qt is enabled
+    static constexpr std::size_t m_qtInterval = 10;
+
+    static constexpr std::size_t m_filesPerExcludedDirectory = 10;
+};
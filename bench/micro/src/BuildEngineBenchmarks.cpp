@@ -0,0 +1,29 @@
+#include <benchmark/benchmark.h>
+
+#include "Core/BuildEngine.hpp"
+
+static void BM_GetOutputPath(benchmark::State& state)
+{
+    BuildEngine buildEngine(std::make_shared<BuildConfig>());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buildEngine.GetOutputPath("d1/d2/unit42", "cpp"));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetOutputPath);
+
+static void BM_GetCompileCommandForFile(benchmark::State& state)
+{
+    BuildEngine buildEngine(std::make_shared<BuildConfig>());
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(buildEngine.GetCompileCommandForFile("cpp", "src/d1/d2/unit42.cpp", "./obj/d1/d2/unit42.o"));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetCompileCommandForFile);
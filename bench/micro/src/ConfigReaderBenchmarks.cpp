@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <filesystem>
+
+#include "Core/ConfigReader.hpp"
+
+namespace fs = std::filesystem;
+
+static void BM_ReadConfig(benchmark::State& state)
+{
+    const fs::path configPath = fs::temp_directory_path() / "kole-micro-config.kole";
+
+    std::ofstream(configPath) <<
+        "output: app\n"
+        "extension: none\n"
+        "directories:\n"
+        "  src: [ src, lib ]\n"
+        "  obj: obj\n"
+        "  bin: bin\n"
+        "  include: [ include, lib/include ]\n"
+        "exclude: [ src/generated/*, \"*_test.cpp\" ]\n"
+        "flags:\n"
+        "  common: -Wall -Wextra\n"
+        "  linux: -lpthread -lfmt\n"
+        "qt_support:\n"
+        "  compile_ui: false\n"
+        "compiler: g++\n"
+        "language_version: c++20\n"
+        "optimization: release\n";
+
+    ConfigReader configReader(configPath.string());
+
+    for (auto _ : state)
+    {
+        configReader.ReadConfig();
+        benchmark::DoNotOptimize(configReader.GetBuildConfig());
+    }
+
+    fs::remove(configPath);
+}
+BENCHMARK(BM_ReadConfig);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include "Utils/FlagManager.hpp"
+
+// NOTE: The flags are generated once and cached, so every file after the first one takes the cached path.
+// The cold benchmarks measure the first call, with a new manager for every iteration.
+
+static void BM_GetFlags(benchmark::State& state)
+{
+    FlagManager flagManager(std::make_shared<BuildConfig>(), std::make_shared<Toolchain>("g++", ToolKind::Compiler));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(flagManager.GetFlags());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetFlags);
+
+static void BM_GetFlagsCold(benchmark::State& state)
+{
+    std::shared_ptr<BuildConfig> config = std::make_shared<BuildConfig>();
+    std::shared_ptr<Toolchain> compiler = std::make_shared<Toolchain>("g++", ToolKind::Compiler);
+
+    for (auto _ : state)
+    {
+        FlagManager flagManager(config, compiler);
+        benchmark::DoNotOptimize(flagManager.GetFlags());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetFlagsCold);
+
+static void BM_GetIncludePaths(benchmark::State& state)
+{
+    FlagManager flagManager(std::make_shared<BuildConfig>(), std::make_shared<Toolchain>("g++", ToolKind::Compiler));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(flagManager.GetIncludePaths());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetIncludePaths);
+
+static void BM_GetIncludePathsCold(benchmark::State& state)
+{
+    std::shared_ptr<BuildConfig> config = std::make_shared<BuildConfig>();
+    std::shared_ptr<Toolchain> compiler = std::make_shared<Toolchain>("g++", ToolKind::Compiler);
+
+    for (auto _ : state)
+    {
+        FlagManager flagManager(config, compiler);
+        benchmark::DoNotOptimize(flagManager.GetIncludePaths());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetIncludePathsCold);
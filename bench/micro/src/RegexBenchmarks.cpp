@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include <fmt/core.h>
+
+#include "Utils/RegexHelper.hpp"
+
+namespace
+{
+    const std::vector<std::string> excludePatterns = {
+        "src/generated/*",
+        "*_test.cpp",
+        "src/third_party",
+        "build/*/cache",
+    };
+
+    std::vector<std::string> GetPaths(std::size_t count)
+    {
+        std::vector<std::string> paths;
+
+        for (std::size_t i = 0; i < count; i++)
+            paths.push_back(fmt::format("src/d{}/d{}/unit{}.cpp", i % 4, i / 4 % 4, i));
+
+        return paths;
+    }
+}
+
+// One call per scanned file and directory, with every exclude pattern checked
+static void BM_MatchesRegex(benchmark::State& state)
+{
+    const std::vector<std::string> paths = GetPaths(256);
+
+    const std::vector<std::string> patterns(excludePatterns.begin(), excludePatterns.begin() + state.range(0));
+
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(RegexHelper::MatchesRegex(paths[i++ % paths.size()], patterns));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchesRegex)->Arg(1)->Arg(4);
+
+static void BM_MatchesRegexPath(benchmark::State& state)
+{
+    const fs::path path = "src/d1/d2/unit42.cpp";
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(RegexHelper::MatchesRegex(path, excludePatterns));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MatchesRegexPath);
+
+static void BM_ConvertPatternToRegex(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(RegexHelper::ConvertPatternToRegex("src/generated/*_moc.cpp"));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConvertPatternToRegex);
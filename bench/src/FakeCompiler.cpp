@@ -0,0 +1,127 @@
+#include "FakeCompiler.hpp"
+
+#include <set>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <fmt/core.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const std::set<std::string> fakeTools = { "fake-cc", "moc", "uic" };
+
+    /**
+     * @brief Collects every header a file includes with quotes, recursively.
+     *
+     * Headers are looked up next to the including file first, then in the include directories.
+     * Headers that can't be found (e.g. generated ones) are skipped, just like with '-MG' missing.
+     */
+    void CollectIncludes(const fs::path& file, const std::vector<fs::path>& includeDirectories, std::set<std::string>& headers)
+    {
+        std::ifstream stream(file);
+        std::string line;
+
+        while (std::getline(stream, line))
+        {
+            if (!line.starts_with("#include \"")) continue;
+
+            const std::size_t start = line.find('"') + 1;
+            const std::size_t end = line.find('"', start);
+
+            if (end == std::string::npos) continue;
+
+            const std::string name = line.substr(start, end - start);
+
+            std::vector<fs::path> candidates = { file.parent_path() / name };
+
+            for (const fs::path& directory : includeDirectories)
+                candidates.push_back(directory / name);
+
+            for (const fs::path& candidate : candidates)
+            {
+                if (!fs::exists(candidate)) continue;
+
+                const std::string header = candidate.lexically_normal().generic_string();
+
+                if (headers.insert(header).second)
+                    CollectIncludes(candidate, includeDirectories, headers);
+
+                break;
+            }
+        }
+    }
+}
+
+bool FakeCompiler::IsFakeTool(const std::string& name)
+{
+    return fakeTools.contains(name);
+}
+
+int FakeCompiler::Run(int argc, char** argv)
+{
+    std::string output;
+    std::string dependencyFile;
+    bool writeDependencies = false;
+
+    std::vector<fs::path> includeDirectories;
+    std::vector<fs::path> sources;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+
+        if (argument == "-o" && i + 1 < argc)
+            output = argv[++i];
+        else if (argument == "-MF" && i + 1 < argc)
+            dependencyFile = argv[++i];
+        else if (argument == "-MD" || argument == "-MMD")
+            writeDependencies = true;
+        else if (argument == "-I" && i + 1 < argc)
+            includeDirectories.push_back(argv[++i]);
+        else if (argument.starts_with("-I"))
+            includeDirectories.push_back(argument.substr(2));
+        else if (!argument.starts_with("-") && fs::path(argument).extension() != ".o")
+            sources.push_back(argument);
+    }
+
+    if (output.empty())
+    {
+        fmt::print(stderr, "{}: no output file given\n", fs::path(argv[0]).filename().string());
+        return 1;
+    }
+
+    std::ofstream outputFile(output, std::ios::trunc);
+    if (!outputFile.is_open())
+    {
+        fmt::print(stderr, "{}: can't open '{}'\n", fs::path(argv[0]).filename().string(), output);
+        return 1;
+    }
+
+    outputFile << "kole-bench\n";
+
+    if (!writeDependencies && dependencyFile.empty())
+        return 0;
+
+    if (dependencyFile.empty())
+        dependencyFile = fs::path(output).replace_extension(".d").string();
+
+    std::set<std::string> headers;
+
+    for (const fs::path& source : sources)
+        CollectIncludes(source, includeDirectories, headers);
+
+    std::ofstream stream(dependencyFile, std::ios::trunc);
+    stream << output << ":";
+
+    for (const fs::path& source : sources)
+        stream << " " << source.generic_string();
+
+    for (const std::string& header : headers)
+        stream << " \\\n  " << header;
+
+    stream << "\n";
+
+    return 0;
+}
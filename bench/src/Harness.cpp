@@ -0,0 +1,141 @@
+#include "Harness.hpp"
+
+#include <chrono>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <fmt/core.h>
+
+bool Harness::Run()
+{
+    fmt::print("{:<10} {:>5} {:>12} {:>12} {:>12} {:>12}\n", "scenario", "runs", "min", "median", "mean", "cpu (mean)");
+
+    // A header that's included from other units, so changing it rebuilds more than one file
+    const fs::path header = fs::path("include") / m_generator.GetHeaderPath(0);
+    const fs::path source = m_generator.GetSourcePath(0);
+
+    // NOTE: Every scenario except the cold one starts from a complete build,
+    // which the previous scenario always leaves behind
+    const bool success =
+        RunScenario("cold", [this]() { Clean(); }, {})
+        && RunScenario("noop", []() {}, {})
+        && RunScenario("source", [this, &source]() { Touch(source); }, {})
+        && RunScenario("header", [this, &header]() { Touch(header); }, {})
+        && RunScenario("rebuild", []() {}, { "--rebuild" });
+
+    return success;
+}
+
+bool Harness::RunScenario(const std::string& name, const std::function<void()>& prepare, const std::vector<std::string>& arguments)
+{
+    std::vector<Sample> samples;
+
+    for (std::size_t i = 0; i < m_options.runs; i++)
+    {
+        prepare();
+
+        Sample sample;
+        if (!RunKole(arguments, sample))
+        {
+            fmt::print(stderr, "error: kole failed in the '{}' scenario, run it in '{}' to see why\n", name, m_generator.GetRoot().string());
+            return false;
+        }
+
+        samples.push_back(sample);
+    }
+
+    PrintResult(name, samples);
+    return true;
+}
+
+bool Harness::RunKole(const std::vector<std::string>& arguments, Sample& sample)
+{
+    std::vector<std::string> commandLine = { m_options.kole.string() };
+    commandLine.insert(commandLine.end(), arguments.begin(), arguments.end());
+
+    if (m_options.jobs != 0)
+        commandLine.push_back(fmt::format("--jobs={}", m_options.jobs));
+
+    std::vector<char*> argv;
+
+    for (std::string& argument : commandLine)
+        argv.push_back(argument.data());
+
+    argv.push_back(nullptr);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    const pid_t pid = fork();
+
+    if (pid < 0) return false;
+
+    if (pid == 0)
+    {
+        // NOTE: Only async-signal-safe calls from here on, the child is a copy of the harness
+        const int devNull = open("/dev/null", O_WRONLY);
+
+        dup2(devNull, STDOUT_FILENO);
+        dup2(devNull, STDERR_FILENO);
+
+        if (chdir(m_generator.GetRoot().c_str()) != 0)
+            _exit(127);
+
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+
+    int status;
+    struct rusage usage = {};
+
+    if (wait4(pid, &status, 0, &usage) < 0)
+        return false;
+
+    const auto end = std::chrono::steady_clock::now();
+
+    sample.wallTime = std::chrono::duration<double, std::milli>(end - start).count();
+    sample.cpuTime = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0
+        + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+void Harness::Clean()
+{
+    for (const char* directory : { "obj", "bin", "ui", ".kole" })
+        fs::remove_all(m_generator.GetRoot() / directory);
+}
+
+void Harness::Touch(const fs::path& path)
+{
+    fs::last_write_time(m_generator.GetRoot() / path, fs::file_time_type::clock::now());
+}
+
+void Harness::PrintResult(const std::string& name, std::vector<Sample> samples)
+{
+    std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) { return a.wallTime < b.wallTime; });
+
+    double wallTotal = 0;
+    double cpuTotal = 0;
+
+    for (const Sample& sample : samples)
+    {
+        wallTotal += sample.wallTime;
+        cpuTotal += sample.cpuTime;
+    }
+
+    const double median = samples.size() % 2 == 1
+        ? samples[samples.size() / 2].wallTime
+        : (samples[samples.size() / 2 - 1].wallTime + samples[samples.size() / 2].wallTime) / 2;
+
+    fmt::print(
+        "{:<10} {:>5} {:>10.1f}ms {:>10.1f}ms {:>10.1f}ms {:>10.1f}ms\n",
+        name,
+        samples.size(),
+        samples.front().wallTime,
+        median,
+        wallTotal / samples.size(),
+        cpuTotal / samples.size()
+    );
+}
@@ -0,0 +1,185 @@
+#include "ProjectGenerator.hpp"
+
+#include <fstream>
+#include <fmt/core.h>
+
+bool ProjectGenerator::Generate()
+{
+    try
+    {
+        if (fs::exists(m_root))
+        {
+            if (!fs::is_empty(m_root) && !fs::exists(m_root / m_markerFile))
+            {
+                fmt::print(stderr, "error: '{}' isn't empty and wasn't generated by kole-bench\n", m_root.string());
+                return false;
+            }
+
+            fs::remove_all(m_root);
+        }
+
+        fs::create_directories(m_root);
+        WriteFile(m_markerFile, "");
+
+        WriteConfig();
+
+        for (std::size_t unit = 0; unit < m_options.files; unit++)
+            WriteUnit(unit);
+
+        if (m_options.qt)
+        {
+            for (std::size_t form = 0; form < m_options.files; form += m_qtInterval)
+                WriteForm(form);
+        }
+
+        for (std::size_t i = 0; i < m_options.excludes; i++)
+            WriteExcludedDirectory(i);
+    }
+    catch (const std::exception& e)
+    {
+        fmt::print(stderr, "error: failed to generate the project: {}\n", e.what());
+        return false;
+    }
+
+    return true;
+}
+
+fs::path ProjectGenerator::GetSourcePath(std::size_t unit) const
+{
+    return fs::path("src") / GetUnitDirectory(unit) / fmt::format("unit{}.cpp", unit);
+}
+
+fs::path ProjectGenerator::GetHeaderPath(std::size_t unit) const
+{
+    return GetUnitDirectory(unit) / fmt::format("unit{}.hpp", unit);
+}
+
+fs::path ProjectGenerator::GetUnitDirectory(std::size_t unit) const
+{
+    fs::path directory;
+    std::size_t index = unit;
+
+    for (std::size_t level = 0; level < m_options.depth; level++)
+    {
+        directory /= fmt::format("d{}", index % m_branching);
+        index /= m_branching;
+    }
+
+    return directory;
+}
+
+void ProjectGenerator::WriteConfig()
+{
+    std::string config;
+
+    config += "output: app\n";
+    config += "extension: none\n\n";
+
+    config += "directories:\n";
+    config += "  src: src\n";
+    config += "  obj: obj\n";
+    config += "  bin: bin\n";
+    config += "  include: include\n";
+
+    if (m_options.qt)
+        config += "  ui: forms\n";
+
+    config += "\n";
+
+    if (m_options.excludes > 0)
+    {
+        config += "exclude:\n";
+
+        for (std::size_t i = 0; i < m_options.excludes; i++)
+            config += fmt::format("  - src/excluded{}\n", i);
+
+        config += "\n";
+    }
+
+    config += "flags:\n";
+    config += "  common: -Wall\n";
+    config += "  linux: none\n\n";
+
+    if (m_options.qt)
+    {
+        config += "qt_support:\n";
+        config += "  compile_ui: true\n";
+        config += "  compile_moc: true\n\n";
+    }
+
+    config += fmt::format("compiler: {}\n", m_options.compiler);
+    config += "language_version: c++17\n";
+    config += "optimization: debug\n";
+
+    WriteFile("config.kole", config);
+}
+
+void ProjectGenerator::WriteUnit(std::size_t unit)
+{
+    const bool usesQt = m_options.qt && unit % m_qtInterval == 0;
+
+    std::string header = "#pragma once\n\n";
+
+    if (usesQt)
+        header += fmt::format("class Unit{}\n{{\n    Q_OBJECT\n}};\n\n", unit);
+
+    header += fmt::format("int unit{}();\n", unit);
+
+    WriteFile(fs::path("include") / GetHeaderPath(unit), header);
+
+    std::string source = fmt::format("#include \"{}\"\n", GetHeaderPath(unit).generic_string());
+
+    if (usesQt)
+        source += fmt::format("#include \"ui_form{}.h\"\n", unit);
+
+    // Spread the includes over the whole project, the same header is included from many places
+    for (std::size_t i = 1; i <= m_options.fanout && i < m_options.files; i++)
+    {
+        const std::size_t included = (unit + i * 7919) % m_options.files;
+
+        if (included != unit)
+            source += fmt::format("#include \"{}\"\n", GetHeaderPath(included).generic_string());
+    }
+
+    source += fmt::format("\nint unit{}()\n{{\n    return {};\n}}\n", unit, unit);
+
+    WriteFile(GetSourcePath(unit), source);
+}
+
+void ProjectGenerator::WriteForm(std::size_t form)
+{
+    const std::string content = fmt::format(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<ui version=\"4.0\">\n"
+        " <class>Form{}</class>\n"
+        " <widget class=\"QWidget\" name=\"Form{}\"/>\n"
+        "</ui>\n",
+        form,
+        form
+    );
+
+    WriteFile(fs::path("forms") / fmt::format("form{}.ui", form), content);
+}
+
+void ProjectGenerator::WriteExcludedDirectory(std::size_t index)
+{
+    for (std::size_t i = 0; i < m_filesPerExcludedDirectory; i++)
+    {
+        const fs::path path = fs::path("src") / fmt::format("excluded{}", index) / fmt::format("skipped{}.cpp", i);
+        WriteFile(path, "#error \"Excluded files should never be compiled\"\n");
+    }
+}
+
+void ProjectGenerator::WriteFile(const fs::path& path, const std::string& content)
+{
+    const fs::path fullPath = m_root / path;
+
+    if (fullPath.has_parent_path())
+        fs::create_directories(fullPath.parent_path());
+
+    std::ofstream file(fullPath, std::ios::trunc);
+    if (!file.is_open())
+        throw std::runtime_error(fmt::format("can't open '{}'", fullPath.string()));
+
+    file << content;
+}
@@ -0,0 +1,183 @@
+#include "FakeCompiler.hpp"
+#include "Harness.hpp"
+#include "ProjectGenerator.hpp"
+
+#include <map>
+#include <cstdlib>
+#include <fmt/core.h>
+
+namespace
+{
+    void PrintUsage()
+    {
+        fmt::print(
+            "usage: kole-bench [--kole PATH] [--directory DIR] [--files N] [--fanout N] [--depth N]\n"
+            "                  [--excludes N] [--qt] [--runs N] [--jobs N] [--generate-only]\n"
+            "\n"
+            "Generates a synthetic project and times kole on it, using a fake compiler\n"
+            "so only the time kole itself spends is measured.\n"
+            "\n"
+            "options:\n"
+            "  --kole PATH        kole binary to measure (default: ../bin/kole)\n"
+            "  --directory DIR    where the project is generated (default: <tmp>/kole-bench)\n"
+            "  --files N          number of source files (default: 1000)\n"
+            "  --fanout N         headers included by every source file (default: 8)\n"
+            "  --depth N          levels of nested directories (default: 2)\n"
+            "  --excludes N       excluded directories and patterns (default: 0)\n"
+            "  --qt               add UI files and compile headers with moc\n"
+            "  --runs N           runs per scenario (default: 5)\n"
+            "  --jobs N           passed to kole as '--jobs'\n"
+            "  --generate-only    only generate the project\n"
+        );
+    }
+
+    std::size_t ParseNumber(const std::string& option, const std::string& value)
+    {
+        if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos || value.length() > 9)
+        {
+            fmt::print(stderr, "error: '{}' expects a number, got '{}'\n", option, value);
+            exit(1);
+        }
+
+        return std::stoul(value);
+    }
+
+    /**
+     * @brief Links the fake tools to the benchmark binary and puts them first in the PATH.
+     */
+    bool SetupFakeTools(const fs::path& directory)
+    {
+        try
+        {
+            const fs::path executable = fs::read_symlink("/proc/self/exe");
+
+            fs::create_directories(directory);
+
+            for (const char* tool : { "fake-cc", "moc", "uic" })
+            {
+                fs::remove(directory / tool);
+                fs::create_symlink(executable, directory / tool);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            fmt::print(stderr, "error: failed to set up the fake tools: {}\n", e.what());
+            return false;
+        }
+
+        const char* path = getenv("PATH");
+        const std::string newPath = path != nullptr ? fmt::format("{}:{}", directory.string(), path) : directory.string();
+
+        setenv("PATH", newPath.c_str(), 1);
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (FakeCompiler::IsFakeTool(fs::path(argv[0]).filename().string()))
+        return FakeCompiler::Run(argc, argv);
+
+    GeneratorOptions generatorOptions;
+    HarnessOptions harnessOptions;
+
+    fs::path directory = fs::temp_directory_path() / "kole-bench";
+    harnessOptions.kole = "../bin/kole";
+
+    bool generateOnly = false;
+
+    const std::map<std::string, std::size_t*> numberOptions = {
+        { "--files",    &generatorOptions.files    },
+        { "--fanout",   &generatorOptions.fanout   },
+        { "--depth",    &generatorOptions.depth    },
+        { "--excludes", &generatorOptions.excludes },
+        { "--runs",     &harnessOptions.runs       },
+        { "--jobs",     &harnessOptions.jobs       },
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+
+        if (argument == "-h" || argument == "--help")
+        {
+            PrintUsage();
+            return 0;
+        }
+
+        if (argument == "--qt")
+        {
+            generatorOptions.qt = true;
+            continue;
+        }
+
+        if (argument == "--generate-only")
+        {
+            generateOnly = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            fmt::print(stderr, "error: unrecognized argument '{}' (or it's missing a value)\n", argument);
+            return 1;
+        }
+
+        const std::string value = argv[++i];
+
+        if (argument == "--kole")
+            harnessOptions.kole = value;
+        else if (argument == "--directory")
+            directory = value;
+        else if (numberOptions.contains(argument))
+            *numberOptions.at(argument) = ParseNumber(argument, value);
+        else
+        {
+            fmt::print(stderr, "error: unrecognized argument '{}'\n", argument);
+            return 1;
+        }
+    }
+
+    if (generatorOptions.files == 0 || harnessOptions.runs == 0)
+    {
+        fmt::print(stderr, "error: '--files' and '--runs' have to be at least 1\n");
+        return 1;
+    }
+
+    // kole runs in the project directory, so a relative path would point somewhere else
+    directory = fs::absolute(directory);
+    harnessOptions.kole = fs::absolute(harnessOptions.kole);
+
+    ProjectGenerator generator(directory, generatorOptions);
+
+    if (!generator.Generate())
+        return 1;
+
+    fmt::print(
+        "Generated {} file(s) in '{}' (fanout {}, depth {}, {} exclude(s){})\n",
+        generatorOptions.files,
+        directory.string(),
+        generatorOptions.fanout,
+        generatorOptions.depth,
+        generatorOptions.excludes,
+        generatorOptions.qt ? ", Qt" : ""
+    );
+
+    if (!SetupFakeTools(directory / "tools"))
+        return 1;
+
+    if (generateOnly)
+    {
+        fmt::print("Add '{}' to the PATH to build it with the fake tools\n", (directory / "tools").string());
+        return 0;
+    }
+
+    if (!fs::exists(harnessOptions.kole))
+    {
+        fmt::print(stderr, "error: kole wasn't found at '{}', build it first or pass '--kole'\n", harnessOptions.kole.string());
+        return 1;
+    }
+
+    Harness harness(generator, harnessOptions);
+    return harness.Run() ? 0 : 1;
+}
@@ -14,6 +14,20 @@ enum class Argument
     Debug,
     Config,
     Initialize,
+    Jobs,
+    MetricsJson,
+    Test,
+    BenchRun,
+    BenchWarmup,
+    BenchCpu,
+    Variant,
+    Explain,
+    KeepGoing,
+    MaxFailures,
+    Top,
+    Rdeps,
+    Includes,
+    Headers,
 };
 
 struct ArgumentInfo
@@ -53,6 +67,13 @@ public:
      */
     void PrintUnrecognizedArgument(const std::string& argument);
 
+    /**
+     * @brief Prints an error message for an unrecognized command.
+     *
+     * @param command The unrecognized command.
+     */
+    void PrintUnrecognizedCommand(const std::string& command);
+
     /**
      * @brief Prints an error message for unspecified argument.
      * 
@@ -60,6 +81,13 @@ public:
      */
     void PrintUnspecifiedArgument(bool longhand);
 
+    /**
+     * @brief Prints an error message for an argument that is missing its value.
+     *
+     * @param argument The argument missing a value.
+     */
+    void PrintMissingValue(const std::string& argument);
+
     /**
      * @brief Retrieves the collected arguments for autorun.
      *
@@ -67,6 +95,13 @@ public:
      */
     std::string GetAutorunArguments();
 
+    /**
+     * @brief Retrieves the command given before the arguments (e.g. 'cache stats').
+     *
+     * @return The words of the command joined by spaces, or an empty string if kole was run to build.
+     */
+    std::string GetCommand();
+
     /**
      * @brief Checks the boolean state of a specific argument.
      *
@@ -75,6 +110,35 @@ public:
      */
     bool GetArgumentState(const Argument& argument);
 
+    /**
+     * @brief Retrieves the value passed to an argument (e.g. '-j 8' or '--jobs=8').
+     *
+     * @param argument The argument to get the value of.
+     * @return The value of the argument, or an empty string if it wasn't provided.
+     */
+    std::string GetArgumentValue(const Argument& argument);
+
+    /**
+     * @brief Retrieves the value of an argument as a positive number.
+     *
+     * Exits the program if the value isn't a valid number.
+     *
+     * @param argument The argument to get the value of.
+     * @param defaultValue The value returned if the argument wasn't provided.
+     */
+    std::size_t GetArgumentNumber(const Argument& argument, std::size_t defaultValue);
+
+private:
+    /**
+     * @brief Marks an argument as provided, reading its value if it takes one.
+     *
+     * @param argument The argument that was found.
+     * @param identifier The identifier the argument was given with, used in error messages.
+     * @param value The value attached to the identifier (e.g. '8' in '-j8'), if any.
+     * @param index The index of the current command-line argument, advanced if the value is the next one.
+     */
+    void SetArgument(const Argument& argument, const std::string& identifier, const std::string& value, int& index);
+
 private:
     int m_argc;
     char** m_argv;
@@ -83,11 +147,21 @@ private:
 
     std::string m_autorunArguments = "";
 
+    std::string m_command = "";
+
+    // Commands doing something else than building, and their descriptions
+    const std::map<std::string, std::string> m_commands = {
+        { "cache stats",       "Show the size and hit rate of the local object cache" },
+        { "stats",             "Show the commands that used the most CPU, memory or I/O" },
+        { "query",             "Show what includes what, from the dependency files of the last build" },
+    };
+
     // NOTE: I tried making argumentIdentifiers and argumentDescriptions to be inline static constexpr and replace std::string with const char*
     // because that would make them get evaluated at compile time which is never bad and actually faster
     // but because of its absance of methods, it's not worth enough to use it, so I just reverted to std::string
 
-    // Map of arguments and their possible identifiers (flags)
+    // Map of arguments and their possible identifiers (flags).
+    // Arguments without a short-hand have an empty first identifier.
     const std::map<Argument, std::array<std::string, 2>> m_argumentIdentifiers = {
         { Argument::Help,              { "h", "help" }    },
         { Argument::Rebuild,           { "r", "rebuild" } },
@@ -95,6 +169,20 @@ private:
         { Argument::Debug,             { "d", "debug" }   },
         { Argument::Config,            { "c", "config" }  },
         { Argument::Initialize,        { "i", "init" }    },
+        { Argument::Jobs,              { "j", "jobs" }    },
+        { Argument::MetricsJson,       { "", "metrics-json" } },
+        { Argument::Test,              { "t", "test" }    },
+        { Argument::BenchRun,          { "", "bench-run" }    },
+        { Argument::BenchWarmup,       { "", "bench-warmup" } },
+        { Argument::BenchCpu,          { "", "bench-cpu" }    },
+        { Argument::Variant,           { "", "variant" }      },
+        { Argument::Explain,           { "", "explain" }      },
+        { Argument::KeepGoing,         { "", "keep-going" }   },
+        { Argument::MaxFailures,       { "k", "max-failures" } },
+        { Argument::Top,               { "", "top" }          },
+        { Argument::Rdeps,             { "", "rdeps" }        },
+        { Argument::Includes,          { "", "includes" }     },
+        { Argument::Headers,           { "", "headers" }      },
     };
 
     // Map of arguments and their descriptions
@@ -105,8 +193,39 @@ private:
         { Argument::Debug,             "Enable debugging logs"                 },
         { Argument::Config,            "Generate a default config if missing"  },
         { Argument::Initialize,        "Sets up an empty project"              },
+        { Argument::Jobs,              "Number of jobs to run in parallel"     },
+        { Argument::MetricsJson,       "Write build metrics to a JSON file"    },
+        { Argument::Test,              "Build and run the test binaries"       },
+        { Argument::BenchRun,          "Run the compiled binary N times and report its timings" },
+        { Argument::BenchWarmup,       "Unmeasured runs before the benchmark (default: 1)"     },
+        { Argument::BenchCpu,          "Pin the benchmarked binary to a CPU"                    },
+        { Argument::Variant,           "Run (or benchmark) this variant instead of the best one" },
+        { Argument::Explain,           "Print why every compile and link runs"                  },
+        { Argument::KeepGoing,         "Run every job that doesn't depend on a failed one"      },
+        { Argument::MaxFailures,       "Stop starting jobs after N failures (0: keep going)"    },
+        { Argument::Top,               "What 'kole stats' sorts by: cpu, rss or io (default: cpu)" },
+        { Argument::Rdeps,             "Show the objects rebuilt when a header changes ('kole query')" },
+        { Argument::Includes,          "Show the headers a source includes ('kole query')"            },
+        { Argument::Headers,           "Rank headers by what changing them costs ('kole query')"      },
+    };
+
+    // Map of arguments that take a value and the name of the value shown in the help menu
+    const std::map<Argument, std::string> m_argumentValueNames = {
+        { Argument::Jobs,              "N" },
+        { Argument::MetricsJson,       "FILE" },
+        { Argument::BenchRun,          "N" },
+        { Argument::BenchWarmup,       "N" },
+        { Argument::BenchCpu,          "CPU" },
+        { Argument::Variant,           "NAME" },
+        { Argument::MaxFailures,       "N" },
+        { Argument::Top,               "KIND" },
+        { Argument::Rdeps,             "FILE" },
+        { Argument::Includes,          "FILE" },
     };
 
+    // Map of the values passed to arguments
+    std::map<Argument, std::string> m_argumentValues;
+
     // Map to track the state (whether the argument was provided or not)
     std::map<Argument, bool> m_argumentStates = {
         { Argument::Help,              false },
@@ -115,5 +234,19 @@ private:
         { Argument::Debug,             false },
         { Argument::Config,            false },
         { Argument::Initialize,        false },
+        { Argument::Jobs,              false },
+        { Argument::MetricsJson,       false },
+        { Argument::Test,              false },
+        { Argument::BenchRun,          false },
+        { Argument::BenchWarmup,       false },
+        { Argument::BenchCpu,          false },
+        { Argument::Variant,           false },
+        { Argument::Explain,           false },
+        { Argument::KeepGoing,         false },
+        { Argument::MaxFailures,       false },
+        { Argument::Top,               false },
+        { Argument::Rdeps,             false },
+        { Argument::Includes,          false },
+        { Argument::Headers,           false },
     };
 };
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Core/BuildOptions.hpp"
+#include "Utils/Process.hpp"
+
+// Summary of the measured runs of a binary. Times are in microseconds.
+struct BenchmarkResult
+{
+    std::size_t runs = 0;
+
+    // Wall time of the runs
+    std::uint64_t minimum = 0;
+    std::uint64_t median = 0;
+    std::uint64_t p95 = 0;
+
+    // Median CPU time of the runs
+    std::uint64_t userTime = 0;
+    std::uint64_t systemTime = 0;
+
+    // Largest peak resident memory of the runs, in bytes
+    std::uint64_t peakMemory = 0;
+};
+
+class BenchmarkRunner
+{
+public:
+    /**
+     * @param resultsPath The file the results of every benchmark are kept in.
+     * @param options The options with the number of runs, warm-up runs and the CPU to pin to.
+     */
+    BenchmarkRunner(std::string resultsPath, const BuildOptions& options)
+        : m_resultsPath(resultsPath), m_options(options) {}
+
+    /**
+     * @brief Runs a binary repeatedly and reports how long it took.
+     *
+     * The warm-up runs are run first and not measured. The measured runs are timed one after another,
+     * with their CPU time and peak memory taken from wait4. The output of the binary is only shown if a run fails.
+     * The result is compared with the previous one for the same binary and arguments, and a slowdown is warned about.
+     *
+     * @param binary The path to the binary.
+     * @param arguments The arguments passed to the binary, separated by spaces.
+     *
+     * @return False if a run of the binary failed.
+     */
+    bool Run(const std::string& binary, const std::string& arguments);
+
+private:
+    /**
+     * @brief Runs the binary once.
+     *
+     * @param command The command running the binary.
+     * @param wallTime Set to the wall time of the run, in microseconds.
+     * @param result Set to the exit code and resource usage of the run.
+     * @param output Set to everything the binary wrote.
+     */
+    void RunOnce(const std::string& command, std::uint64_t& wallTime, Process::ProcessResult& result, std::string& output);
+
+    /**
+     * @brief Pins kole to the CPU given in the options, so the binary inherits it.
+     *
+     * @return False if the CPU couldn't be used.
+     */
+    bool PinToCpu();
+
+    /**
+     * @brief Prints the result, compared with the previous one if there is one.
+     */
+    void PrintResult(const std::string& binary, const BenchmarkResult& result, const BenchmarkResult* previous);
+
+    /**
+     * @brief Reads the last result of a binary and its arguments from the results file.
+     *
+     * @return False if there's no earlier result.
+     */
+    bool LoadPrevious(const std::string& key, BenchmarkResult& result);
+
+    /**
+     * @brief Appends a result to the results file, keeping only the most recent ones.
+     */
+    void Save(const std::string& key, const BenchmarkResult& result);
+
+private:
+    std::string m_resultsPath;
+    BuildOptions m_options;
+
+    // Results file format version, bumped whenever the format changes
+    static constexpr int m_version = 1;
+
+    // Number of results kept in the file, across all binaries
+    static constexpr std::size_t m_maxResults = 200;
+
+    // NOTE: Runs of the same binary vary by a few percent, so only a larger slowdown is warned about
+    static constexpr double m_slowdownThreshold = 0.05;
+};
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <map>
 #include <memory>
 
 #include "Core/ConfigReader.hpp"
 #include "Utils/FlagManager.hpp"
+#include "Utils/Toolchain.hpp"
 
 class BuildEngine
 {
@@ -41,14 +43,209 @@ public:
      * @brief Generates the command to link object files into a final binary.
      *
      * Constructs the link command using the compiler version, flags, object files,
-     * and output binary name.
+     * and output binary name. The inputs are written to a response file ('.kole/link/<output>.rsp'),
+     * so the command stays short no matter how many objects the project has.
      *
      * @param files Vector of object files to link.
+     * @param archives Vector of archives to link as a whole (see GetArchiveCommand).
+     * @param sharedLibraries Vector of shared libraries the binary loads from its own directory (see GetSharedLibraryCommand).
      * @param output The output binary name.
+     * @param extraFlags Flags added after the project flags (e.g. the test libraries).
+     * @param inputsChanged If given, set to whether the inputs differ from the ones of the previous command.
      *
      * @return The formatted link command.
      */
-    std::string GetLinkCommandForProject(const std::vector<std::string>& files, const std::string& output);
+    std::string GetLinkCommandForProject(
+        const std::vector<std::string>& files,
+        const std::vector<std::string>& archives,
+        const std::vector<std::string>& sharedLibraries,
+        const std::string& output,
+        const std::string& extraFlags = "",
+        bool* inputsChanged = nullptr
+    );
+
+    /**
+     * @brief Generates the command to link object files into a shared library ('dev_shared' in the 'link' section).
+     *
+     * The objects have to be compiled with '-fPIC', which the flags then include (see FlagManager::GetFlags).
+     * The members are written to a response file, like the inputs of the binary.
+     *
+     * @param library The library path.
+     * @param members Vector of object files in the library.
+     * @param membersChanged Set to whether the members differ from the ones of the previous command.
+     *
+     * @return The formatted link command.
+     */
+    std::string GetSharedLibraryCommand(const std::string& library, const std::vector<std::string>& members, bool& membersChanged);
+
+    /**
+     * @brief Generates the command to run one shard of a test binary.
+     *
+     * The shard is passed the way GoogleTest expects it (GTEST_SHARD_INDEX and GTEST_TOTAL_SHARDS).
+     *
+     * @param binary The path to the test binary.
+     * @param shard The index of the shard, starting from 0.
+     * @param shards The number of shards the tests are split into.
+     *
+     * @return The formatted test command.
+     */
+    std::string GetTestCommand(const std::string& binary, std::size_t shard, std::size_t shards);
+
+    /**
+     * @brief Generates the command to (re)create an archive of object files.
+     *
+     * A thin archive only references its members, so creating it doesn't copy any objects.
+     * The members are written to a response file next to the archive.
+     *
+     * @param archive The archive path.
+     * @param members Vector of object files in the archive.
+     * @param membersChanged Set to whether the members differ from the ones of the previous command.
+     * @param isThin Whether the archive only references its members instead of holding them.
+     * @param isShared Whether other kole processes may build the same archive at the same time (see GetTemporaryPath).
+     *
+     * @return The formatted archive command.
+     */
+    std::string GetArchiveCommand(const std::string& archive, const std::vector<std::string>& members, bool& membersChanged, bool isThin = true, bool isShared = false);
+
+    /**
+     * @brief Generates the command to compile a source of a dependency (see DependencyConfig).
+     *
+     * The command is run from the dependency's directory, so it's the same in every project vendoring the package.
+     * Only the language version is taken from the project, the flags and include paths are the dependency's own.
+     *
+     * @param dependency The dependency the source belongs to.
+     * @param source The source file path, relative to the dependency's directory.
+     * @param output The path the command writes the object to. Objects go to the shared store,
+     * so the caller passes the temporary path of the process (see GetTemporaryPath) and moves the object into place.
+     *
+     * @return The formatted compile command.
+     */
+    std::string GetCompileCommandForDependency(const DependencyConfig& dependency, const std::string& source, const std::string& output);
+
+    /**
+     * @brief Generates the signature of a command, recorded with its output.
+     *
+     * The signature changes with the command and with the tool running it (see Toolchain::GetFingerprint),
+     * so an output built with different flags or by a different compiler is rebuilt even if it's newer than its source.
+     *
+     * @param command The command generated for the file.
+     * @param sourceExtension The extension of the source file, which decides the tool. Empty for the link.
+     *
+     * @return The signature, as a hexadecimal string.
+     */
+    std::string GetCommandSignature(const std::string& command, const std::string& sourceExtension);
+
+    /**
+     * @brief Generates the template of a command, which outputs built the same way share.
+     *
+     * The paths of the source, the output and the dependency file are replaced by '$in', '$out' and '$depfile',
+     * and the diagnostic flags are left out like in the signature.
+     *
+     * @param command The command generated for the file.
+     * @param source The source file of the command.
+     * @param output The output file of the command.
+     * @param depfile The dependency file the command writes, empty if it doesn't write one.
+     *
+     * @return The command template.
+     */
+    std::string GetCommandTemplate(const std::string& command, const std::string& source, const std::string& output, const std::string& depfile);
+
+    /**
+     * @brief Gets the dependency file the compile command of a file writes (see Depfile).
+     *
+     * @param sourceExtension The source file extension.
+     * @param outputPath The output file path.
+     *
+     * @return The path next to the output, or an empty string if no dependency file is written
+     * (the file isn't a source file, or the compiler doesn't support '-MMD').
+     */
+    std::string GetDepfilePath(const std::string& sourceExtension, const std::string& outputPath);
+
+    /**
+     * @brief Gets the path a command writes its output to, before the output is renamed into place.
+     *
+     * Every compile, archive and link command writes there, and the output is only replaced once the command
+     * succeeds (see JobScheduler), so a killed command never leaves a partial output that looks up to date.
+     *
+     * @param output The output file path.
+     * @param isShared Whether other kole processes may build the same output at the same time
+     * (the dependency store). The path is then one of this process only, so they never write into each other's file.
+     *
+     * @return The temporary path next to the output.
+     */
+    static std::string GetTemporaryPath(const std::string& output, bool isShared = false);
+
+    /**
+     * @brief Checks if the compiler was found, so its version is part of the command signatures (see Toolchain::GetFingerprint).
+     */
+    bool IsCompilerFound() const { return m_compiler->IsFound(); }
+
+    /**
+     * @brief Checks if sources are compiled as C++20 modules ('modules' is set and the compiler supports '-fmodules-ts').
+     */
+    bool UsesModules();
+
+    /**
+     * @brief Gets the directory the module interfaces (BMIs) are kept in.
+     *
+     * Every set of flags gets its own directory, since a BMI can only be imported with the flags it was built with.
+     * Switching back to an earlier set of flags finds its BMIs still there.
+     */
+    const std::string& GetModuleDirectory();
+
+    /**
+     * @brief Gets the path of the BMI of a module, in the module directory.
+     */
+    std::string GetModuleInterfacePath(const std::string& moduleName);
+
+    /**
+     * @brief Gets the module mapper file, which tells the compiler the path of every BMI (see ModuleGraph::WriteMapper).
+     */
+    std::string GetModuleMapperPath();
+
+    /**
+     * @brief Generates the command writing the P1689 module dependencies of a source file.
+     *
+     * @param sourcePath The source file path.
+     * @param outputPath The object file the source is compiled to.
+     * @param scanOutput The file the dependencies are written to.
+     *
+     * @return The formatted command, or an empty string if the compiler can't scan sources
+     * (it doesn't support '-fdeps-format=p1689r5').
+     */
+    std::string GetScanCommandForFile(const std::string& sourcePath, const std::string& outputPath, const std::string& scanOutput);
+
+    /**
+     * @brief Sets the variant the next outputs and commands are for ('variants' in the config).
+     *
+     * A variant compiles and links with its '-march' into objects and BMIs of its own,
+     * an empty variant is the project itself.
+     */
+    void SetVariant(const std::string& variant);
+
+    const std::string& GetVariant() const { return m_variant; }
+
+    /**
+     * @brief Checks if the compiler can build for a variant (it accepts its '-march').
+     */
+    bool SupportsVariant(const std::string& variant);
+
+    /**
+     * @brief Gets the object directory of the current variant, the configured one ('obj') or the variant's next to it ('obj-x86-64-v3').
+     *
+     * Objects are placed under it (GetOutputPath) and looked for there when linking.
+     */
+    std::string GetObjectDirectory();
+
+    /**
+     * @brief Generates the command building the launcher of the variants (see VariantLauncher) in one go.
+     *
+     * @param source The generated source of the launcher.
+     * @param output The launcher binary, which is the project's binary.
+     *
+     * @return The formatted compile command.
+     */
+    std::string GetLauncherCommand(const std::string& source, const std::string& output);
 
 private:
     /**
@@ -66,8 +263,53 @@ private:
      */
     std::string GetCompileCommandForUIFile(const std::string& source, const std::string& output);
 
+    /**
+     * @brief Gets the response file with the inputs of a link ('.kole/link/<output>.rsp').
+     */
+    std::string GetResponseFilePath(const std::string& output);
+
+    /**
+     * @brief Writes arguments to a response file ('@file'), one per line and quoted where needed.
+     *
+     * The file is only replaced if its contents change.
+     *
+     * @return True if the file was written, false if it was already up to date.
+     */
+    bool WriteResponseFile(const std::string& path, const std::vector<std::string>& arguments);
+
+    /**
+     * @brief Gets the part of a command that is signed, everything but the diagnostic flags.
+     */
+    std::string_view GetSignedCommand(std::string_view command);
+
+    /**
+     * @brief Appends the diagnostic flags to the end of a command, where GetCommandSignature expects them.
+     */
+    std::string AddDiagnosticFlags(const std::string& command);
+
+    /**
+     * @brief Gets the tool that runs the commands for a source extension, probing it the first time.
+     */
+    const Toolchain& GetToolchain(const std::string& sourceExtension);
+
+    /**
+     * @brief Gets the '-march' of the current variant, with a space in front. Empty without a variant.
+     */
+    std::string GetVariantFlags();
+
 private:
     std::shared_ptr<BuildConfig> m_config;
 
+    std::shared_ptr<Toolchain> m_compiler;
+
+    // NOTE: moc and uic are only probed once a file needs them, most projects don't use Qt
+    std::map<std::string, std::unique_ptr<Toolchain>> m_qtTools;
+
     std::unique_ptr<FlagManager> m_flagManager;
+
+    // NOTE: Generated from the flags the first time it's needed, see GetModuleDirectory
+    std::string m_moduleDirectory;
+
+    // The variant being built, empty for the project itself (see SetVariant)
+    std::string m_variant;
 };
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <map>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+enum class BuildPhase
+{
+    Config,     // Reading and checking the config
+    Scan,       // Walking the source directories and checking what's out of date
+    Codegen,    // UI and moc files
+    Compile,    // Source files
+    Link,       // The binary
+    Test,       // Runs of the test binaries
+};
+
+// A single command run during the build
+struct CommandMetrics
+{
+    BuildPhase phase;
+
+    std::string source;
+    std::string output;
+    std::string command;
+
+    // Milliseconds since the build started
+    std::uint64_t start = 0;
+    std::uint64_t duration = 0;
+
+    int exitCode = -1;
+
+    // Resource usage of the command, see Process::ProcessResult
+    std::uint64_t peakMemory = 0;
+    std::uint64_t userTime = 0;
+    std::uint64_t systemTime = 0;
+    std::uint64_t blockInputs = 0;
+    std::uint64_t blockOutputs = 0;
+    std::uint64_t voluntarySwitches = 0;
+    std::uint64_t involuntarySwitches = 0;
+};
+
+/**
+ * @brief Collects timings and counts of a build, so they can be written out for CI.
+ *
+ * Everything is collected on every run, since it's only a few numbers per command.
+ * The file is only written if it was asked for with '--metrics-json'.
+ */
+class BuildMetrics
+{
+public:
+    BuildMetrics() : m_startTime(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Gets the time since the build started, in milliseconds.
+     */
+    std::uint64_t GetElapsed() const;
+
+    /**
+     * @brief Adds time spent in a phase that isn't made of commands (config and scan).
+     */
+    void AddPhaseTime(BuildPhase phase, std::uint64_t duration);
+
+    /**
+     * @brief Records a finished command.
+     *
+     * The time of the codegen, compile and link phases is the span from the first of their commands
+     * starting to the last one finishing, since their commands run in parallel.
+     */
+    void AddCommand(CommandMetrics command);
+
+    void AddSkippedUnit() { m_skippedUnits++; }
+    void AddCachedUnit() { m_cachedUnits++; }
+
+    /**
+     * @brief Updates the peak concurrency with the number of currently running commands.
+     */
+    void UpdateConcurrency(std::size_t runningCommands);
+
+    void SetSuccess(bool success) { m_success = success; }
+
+    /**
+     * @brief Writes the metrics to a JSON file.
+     *
+     * @param path The path of the file, which is replaced if it exists.
+     * @return False if the file couldn't be written.
+     */
+    bool Write(const std::string& path);
+
+    /**
+     * @brief Checks if the metrics were written, so a build that exits early knows it still has to.
+     */
+    bool IsWritten() const { return m_isWritten; }
+
+private:
+    std::chrono::steady_clock::time_point m_startTime;
+
+    std::map<BuildPhase, std::uint64_t> m_phaseTimes;
+
+    // First start and last end of the commands of every phase
+    std::map<BuildPhase, std::pair<std::uint64_t, std::uint64_t>> m_phaseSpans;
+
+    std::vector<CommandMetrics> m_commands;
+
+    std::size_t m_skippedUnits = 0;
+    std::size_t m_cachedUnits = 0;
+
+    std::size_t m_peakConcurrency = 0;
+
+    bool m_success = true;
+    bool m_isWritten = false;
+
+    // NOTE: Bumped whenever a field is renamed or removed, so dashboards can tell the formats apart
+    static constexpr int m_version = 1;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+// NOTE: Unlike BuildConfig, these options come from the command line
+// and only live for the current run, so they're never written to the config
+struct BuildOptions
+{
+    bool rebuild = false;
+
+    // Whether the test binaries are built and run after the project (see the 'tests' section of the config)
+    bool test = false;
+
+    // Whether the reason every compile and link runs for is printed
+    bool explain = false;
+
+    // Maximum number of jobs running at once.
+    // 0 leaves the limit to an inherited jobserver, or to the number of cores if there is none.
+    std::size_t jobs = 0;
+
+    // Number of failed jobs after which the build stops starting new ones.
+    // 0 keeps going until every job that doesn't depend on a failed one ran ('--keep-going').
+    std::size_t maxFailures = 1;
+
+    // File the build metrics are written to, nothing is written if it's empty
+    std::string metricsPath;
+
+    // Number of measured runs of the binary after the build (see BenchmarkRunner).
+    // 0 runs it once without measuring, if autorun was asked for.
+    std::size_t benchmarkRuns = 0;
+
+    // Runs before the measured ones, which aren't measured
+    std::size_t benchmarkWarmups = 1;
+
+    // CPU the benchmarked binary is pinned to, -1 leaves it unpinned
+    int benchmarkCpu = -1;
+
+    // Variant run (or benchmarked) instead of the launcher picking one, empty lets the launcher pick
+    std::string variant;
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <unordered_map>
+
+// Everything kole remembers about an output from earlier builds
+struct BuildRecord
+{
+    // Wall time of the command that produced the output, in milliseconds
+    std::uint64_t duration = 0;
+
+    // Peak resident memory of the command that produced the output, in bytes
+    std::uint64_t peakMemory = 0;
+
+    // The rest of the resource usage of the command, see Process::ProcessResult
+    std::uint64_t userTime = 0;
+    std::uint64_t systemTime = 0;
+    std::uint64_t blockInputs = 0;
+    std::uint64_t blockOutputs = 0;
+    std::uint64_t voluntarySwitches = 0;
+    std::uint64_t involuntarySwitches = 0;
+
+    // Signature of the last command that produced the output successfully (see BuildEngine::GetCommandSignature)
+    std::string signature;
+
+    // Whether the last command for the output failed
+    bool failed = false;
+
+    // Key of the last command that produced the output successfully (see BuildState::AddCommand)
+    std::string command;
+
+    // Hash of the source's contents when the output was produced, empty for outputs without a source
+    std::string sourceHash;
+
+    // When the output was placed from the object cache (ticks of the file clock), 0 if a command here built it.
+    // A hard link keeps the modification time of the cache entry, which can be older than the sources that match it.
+    std::int64_t placedTime = 0;
+};
+
+class BuildState
+{
+public:
+    BuildState(std::string statePath) : m_statePath(statePath) {}
+
+    /**
+     * @brief Reads the state saved by earlier builds.
+     *
+     * A missing or unreadable state isn't an error, the build just has no history to use.
+     */
+    void Load();
+
+    /**
+     * @brief Writes the state to disk, replacing the previous one.
+     *
+     * Changes made since the state was loaded are journaled as they're made (see SetRecord),
+     * so a build that's killed before it saves still keeps the outputs it finished. The journal is removed here.
+     */
+    void Save();
+
+    /**
+     * @brief Retrieves the record of an output.
+     *
+     * @param output The output path.
+     * @return The record, or nullptr if the output wasn't built before.
+     */
+    const BuildRecord* GetRecord(const std::string& output) const;
+
+    /**
+     * @brief Stores the record of an output, replacing the old one, and appends it to the journal.
+     */
+    void SetRecord(const std::string& output, const BuildRecord& record);
+
+    /**
+     * @brief Retrieves the records of all outputs.
+     */
+    const std::unordered_map<std::string, BuildRecord>& GetRecords() const { return m_records; }
+
+    /**
+     * @brief Retrieves the average peak memory of all recorded outputs.
+     *
+     * @return The average in bytes, or 0 if nothing was recorded.
+     */
+    std::uint64_t GetAveragePeakMemory() const;
+
+    /**
+     * @brief Retrieves the average duration of all recorded outputs.
+     *
+     * @return The average in milliseconds, or 0 if nothing was recorded.
+     */
+    std::uint64_t GetAverageDuration() const;
+
+    /**
+     * @brief Stores a command, so the one an output was last built with can be compared to the current one.
+     *
+     * Commands are stored once no matter how many outputs share them, so the sources and outputs
+     * should be replaced by placeholders first (see BuildEngine::GetCommandTemplate).
+     *
+     * @param command The command to store.
+     * @return The key of the command, which is recorded with an output in its record.
+     */
+    std::string AddCommand(const std::string& command);
+
+    /**
+     * @brief Retrieves a command stored by this build or an earlier one.
+     *
+     * @param key The key of the command (see AddCommand).
+     * @return The command, or nullptr if it isn't known.
+     */
+    const std::string* GetCommand(const std::string& key) const;
+
+private:
+    /**
+     * @brief Reads the commands saved by earlier builds, in a file next to the state.
+     */
+    void LoadCommands();
+
+    /**
+     * @brief Writes the commands the records still refer to.
+     *
+     * @return False if they couldn't be written.
+     */
+    bool SaveCommands();
+
+    std::string GetJournalPath() const;
+
+    /**
+     * @brief Applies the changes journaled by a build that didn't save the state (see Save).
+     */
+    void ReplayJournal();
+
+    /**
+     * @brief Appends a change to the journal, opening it first if needed.
+     *
+     * @param kind What changed, 'record' or 'command'.
+     * @param entry The line the change has in the state (or the commands).
+     */
+    void AppendJournal(const std::string& kind, const std::string& entry);
+
+private:
+    std::string m_statePath;
+
+    std::unordered_map<std::string, BuildRecord> m_records;
+
+    // NOTE: Most outputs are built by the same command (apart from their paths),
+    // so the commands are kept apart from the records and looked up by their key
+    std::unordered_map<std::string, std::string> m_commands;
+
+    // Opened by the first change, see AppendJournal
+    std::ofstream m_journal;
+
+    // NOTE: Bumped whenever the format changes, older states are then ignored
+    static constexpr int m_version = 1;
+};
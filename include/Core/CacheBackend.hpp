@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+/**
+ * @brief Storage of a shared object cache, holding entries by key.
+ *
+ * Keys look like relative paths ('objects/<hash>'), which every backend maps to its own location.
+ * Backends are called from several threads at once.
+ */
+class CacheBackend
+{
+public:
+    virtual ~CacheBackend() = default;
+
+    /**
+     * @brief Reads an entry.
+     *
+     * @return False if there's no such entry, or the storage couldn't be reached.
+     */
+    virtual bool Get(const std::string& key, std::string& data) = 0;
+
+    /**
+     * @brief Writes an entry, replacing the previous one.
+     *
+     * Readers never see a partially written entry.
+     *
+     * @return False if the entry couldn't be written.
+     */
+    virtual bool Put(const std::string& key, const std::string& data) = 0;
+
+    /**
+     * @brief Describes where the entries are stored, for log messages.
+     */
+    virtual std::string GetDescription() const = 0;
+
+    /**
+     * @brief Creates the backend for a location from the config.
+     *
+     * @param location A directory (e.g. on a network filesystem), or an 'http://' URL of a server
+     * answering GET and PUT requests.
+     * @return The backend, or nullptr if the location isn't supported.
+     */
+    static std::unique_ptr<CacheBackend> Create(const std::string& location);
+};
+
+/**
+ * @brief Stores entries as files in a directory, which can be shared over a network filesystem.
+ */
+class DirectoryCacheBackend : public CacheBackend
+{
+public:
+    DirectoryCacheBackend(std::string directory) : m_directory(directory) {}
+
+    bool Get(const std::string& key, std::string& data) override;
+    bool Put(const std::string& key, const std::string& data) override;
+
+    std::string GetDescription() const override { return m_directory; }
+
+private:
+    std::string m_directory;
+};
+
+/**
+ * @brief Stores entries on an HTTP server, reading them with GET and writing them with PUT requests.
+ *
+ * Entries are at '<url>/<key>'. A missing entry has to be answered with 404.
+ */
+class HttpCacheBackend : public CacheBackend
+{
+public:
+    HttpCacheBackend(std::string url);
+
+    bool Get(const std::string& key, std::string& data) override;
+    bool Put(const std::string& key, const std::string& data) override;
+
+    std::string GetDescription() const override { return m_url; }
+
+private:
+    /**
+     * @brief Stops using the server once it can't be reached, instead of waiting for every request to time out.
+     */
+    void Disable();
+
+private:
+    std::string m_url;
+
+    std::atomic<bool> m_isDisabled = false;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "Core/ArgumentManager.hpp"
+#include "Core/ConfigReader.hpp"
+
+/**
+ * @brief Runs the commands that do something else than building (see ArgumentManager).
+ */
+namespace Commands
+{
+    /**
+     * @brief Runs a command.
+     *
+     * @param command The command, as returned by ArgumentManager::GetCommand.
+     * @param config The config of the project the command is run in.
+     * @param arguments The arguments the command was given with.
+     * @return The exit code of kole.
+     */
+    int Run(const std::string& command, std::shared_ptr<BuildConfig> config, std::shared_ptr<ArgumentManager> arguments);
+}
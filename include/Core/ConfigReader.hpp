@@ -18,8 +18,41 @@ namespace ConfigConstants
     inline constexpr const char* AUTO = "auto";
     inline constexpr const char* FALSE = "false";
     inline constexpr const char* TRUE = "true";
+
+    // Directory holding everything kole keeps between builds (build state, caches)
+    inline constexpr const char* STATE_DIRECTORY = ".kole";
 }
 
+// A vendored source package, built once per toolchain and set of flags into a directory every project shares
+struct DependencyConfig
+{
+    // Directory holding the package, the other paths are relative to it
+    std::string path;
+
+    // Source directories (or files) compiled into the package's archive
+    std::vector<std::string> sources = { "." };
+
+    // Include directories, used by the package's sources and the project's
+    std::vector<std::string> include;
+
+    // Flags the sources are compiled with, instead of the project's
+    std::string flags = "-O2";
+};
+
+// Compile flags for the sources matching some patterns, on top of (or instead of) the project's
+struct FlagOverride
+{
+    // Patterns like the ones in 'exclude', a directory matches everything in it
+    std::vector<std::string> match;
+
+    // Optimization level of the sources, the project's if empty
+    std::string optimization;
+
+    // Flags added after the project's common flags, or replacing them
+    std::string flags;
+    bool replaceFlags = false;
+};
+
 struct BuildConfig
 {
     std::string output = "main";
@@ -60,10 +93,57 @@ struct BuildConfig
         { "moc_prefix",         "moc_"                 },
     };
 
+    // NOTE: Memory sizes can be given with a unit (e.g. '512M' or '2G')
+    std::map<std::string, std::string> scheduler = {
+        { "memory_headroom",    "512M" },
+    };
+
+    // NOTE: The remote is a directory or an 'http://' URL, objects compiled by others are fetched from it.
+    // The local cache is a directory as well, or 'auto' for one in the user's cache directory.
+    // So are the dependencies, which are built into the same directory by every project.
+    std::map<std::string, std::string> cache = {
+        { "remote",             ""                    },
+        { "upload",             ConfigConstants::TRUE },
+        { "local",              ""                    },
+        { "max_size",           "5G"                  },
+        { "compression_level",  "3"                   },
+        { "dependencies",       ConfigConstants::AUTO },
+    };
+
+    // NOTE: Thin archives only reference the objects, they're never copied.
+    // With 'dev_shared', every top-level source directory is linked into a shared library of its own.
+    std::map<std::string, std::string> link = {
+        { "thin_archives",      ConfigConstants::FALSE },
+        { "dev_shared",         ConfigConstants::FALSE },
+    };
+
+    // NOTE: Every source file in the test directory is a test binary, linked with the project's objects
+    // except the one with 'main' in it. The timeout is in seconds, 'none' lets tests run as long as they need.
+    std::map<std::string, std::string> tests = {
+        { "directory",          ""             },
+        { "main",               "src/main.cpp" },
+        { "flags",              ""             },
+        { "shards",             "1"            },
+        { "timeout",            ""             },
+    };
+
+    // NOTE: The sources of a dependency aren't part of the project's build, its archive is linked instead
+    std::map<std::string, DependencyConfig> dependencies;
+
+    // NOTE: Applied in order, so a later override wins over an earlier one matching the same source
+    std::vector<FlagOverride> overrides;
+
     std::string compiler = "g++";
     std::string languageVersion = "c++17";
 
     std::string optimization = "debug";
+
+    // NOTE: Modules need C++20 and a compiler supporting '-fmodules-ts' (GCC 11 or newer)
+    std::string modules = ConfigConstants::FALSE;
+
+    // x86-64 levels the project is built for in addition, each with its own objects and binary ('x86-64-v3').
+    // The binary is then a launcher running the best variant the CPU supports (see VariantLauncher).
+    std::vector<std::string> variants;
 };
 
 class ConfigReader
@@ -122,7 +202,7 @@ private:
     std::string m_defaultConfigPath = "./assets/KoleConfig.default.yaml";
 
     std::string m_configPath;
-    std::array<std::string, 11> m_recognizedKeys = {
+    std::array<std::string, 19> m_recognizedKeys = {
         "output",
         "extension",
         "platform",
@@ -131,8 +211,16 @@ private:
         "exclude",
         "flags",
         "qt_support",
+        "scheduler",
+        "cache",
+        "link",
+        "tests",
+        "dependencies",
+        "overrides",
         "compiler",
         "language_version",
-        "optimization"
+        "optimization",
+        "modules",
+        "variants"
     };
 };
@@ -1,21 +1,26 @@
 #pragma once
 
+#include <map>
+#include <set>
+#include <optional>
 #include <filesystem>
 
+#include "Core/BenchmarkRunner.hpp"
 #include "Core/BuildEngine.hpp"
+#include "Core/BuildMetrics.hpp"
+#include "Core/BuildOptions.hpp"
+#include "Core/BuildState.hpp"
 #include "Core/ConfigReader.hpp"
+#include "Core/JobScheduler.hpp"
+#include "Core/ModuleGraph.hpp"
+#include "Core/ObjectCache.hpp"
 
 namespace fs = std::filesystem;
 
 class FileCompiler
 {
 public:
-    FileCompiler(std::shared_ptr<BuildConfig> config)
-        : m_config(config)
-    {
-        m_buildEngine = std::make_shared<BuildEngine>(m_config);
-        this->SetupDirectories();
-    }
+    FileCompiler(std::shared_ptr<BuildConfig> config, const BuildOptions& options, std::shared_ptr<BuildMetrics> metrics);
 
     /**
      * @brief Adds relevant directories to an array for compilation.
@@ -26,31 +31,70 @@ public:
     void SetupDirectories();
 
     /**
-     * @brief Compiles source files to object files.
+     * @brief Queues the compilation of source files to object files.
      *
      * Iterates through configured directories (e.g., 'src')
-     * and calls the compile object file function for each one.
-     *
-     * @param rebuild Whether to rebuild all files.
+     * and queues a job for every file that is out of date.
+     * The jobs are run together with the link, in LinkObjectFiles.
      */
-    void CompileObjectFiles(bool rebuild);
+    void CompileObjectFiles();
 
     /**
-     * @brief Compiles a source file to an object file.
+     * @brief Queues the compilation of a source file to an object file.
      *
-     * Compiles source files into object files.
      * Includes UI and header files if QT support is enabled.
+     * Source files wait for all UI files, since they may include the generated headers.
+     *
+     * @param parentDirectory The directory being compiled.
+     * @param childPath The path to the source file, relative to the parent directory.
+     */
+    void CompileObjectFile(fs::path parentDirectory, fs::path childPath);
+
+    /**
+     * @brief Queues the job building an output from a source file, unless the output is up to date.
      *
      * @param sourcePath The path to the source file.
-     * @param rebuild Whether to rebuild the file.
+     * @param extension The source file extension, without the dot.
+     * @param outputPath The output file path.
+     * @param dependencies Jobs the job waits for, next to the ones generating headers.
+     * @param outdatedReason Why the output has to be built again even if it looks up to date, empty if it doesn't.
+     * @param isCacheable Whether the object can be looked up in the object cache.
+     *
+     * @return The index of the queued job, or nothing if the output is up to date.
      */
-    void CompileObjectFile(fs::path parentDirectory, fs::path childPath, bool rebuild);
+    std::optional<std::size_t> QueueFileJob(
+        const fs::path& sourcePath,
+        const std::string& extension,
+        const fs::path& outputPath,
+        const std::vector<std::size_t>& dependencies = {},
+        const std::string& outdatedReason = "",
+        bool isCacheable = true
+    );
+
+    /**
+     * @brief Queues the sources collected while modules are used, interfaces ahead of their importers.
+     *
+     * The sources are scanned for their module declarations (see ModuleGraph) and queued in the order they import each other.
+     * Every importer waits for the jobs building the interfaces it imports, and is built again when one of them is.
+     * Sources that don't depend on each other still compile in parallel.
+     */
+    void QueueModuleSources();
+
+    /**
+     * @brief Queues the build of every dependency that isn't built yet (see DependencyConfig).
+     *
+     * Every dependency is built once per toolchain, set of flags and contents of the package
+     * into a directory of its own under the dependencies directory ('dependencies' in the 'cache' section),
+     * which every project vendoring the same package shares. The archives are linked into the binary and the tests.
+     */
+    void QueueDependencies();
 
     /**
      * @brief Links object files into a binary executable.
      *
-     * Links compiled object files into an executable binary, applying platform-specific
-     * flags. Saves the output path for optional execution.
+     * Queues the link of all object files (existing and queued ones) into an executable binary,
+     * applying platform-specific flags, and runs every queued job in parallel.
+     * Saves the output path for optional execution.
      */
     void LinkObjectFiles();
 
@@ -58,21 +102,212 @@ public:
      * @brief Runs the compiled binary executable with optional arguments.
      *
      * Adjusts path separators for compatibility with the target platform (Linux/MacOS/Windows).
+     * With '--variant', the binary of that variant is run instead of the launcher.
      *
      * @param arguments Arguments to pass to the executable.
      */
     void RunBinaryExecutable(const std::string& arguments);
 
+    /**
+     * @brief Runs the compiled binary repeatedly and reports its timings (see BenchmarkRunner).
+     *
+     * With '--variant', the binary of that variant is benchmarked, so variants can be compared with each other.
+     * The results are kept in '.kole/benchmarks', so a slowdown since the previous benchmark is warned about.
+     *
+     * @param arguments Arguments to pass to the executable.
+     */
+    void BenchmarkBinaryExecutable(const std::string& arguments);
+
+private:
+    /**
+     * @brief Queues the module units of the current variant in the order they import each other (see QueueModuleSources).
+     *
+     * @param units The scanned declarations of every module source.
+     * @param order The order the sources can be compiled in (see ModuleGraph::Sort).
+     */
+    void QueueModuleUnits(const std::vector<const ModuleUnit*>& units, const std::vector<std::size_t>& order);
+
+    /**
+     * @brief Queues the link of the objects of the current variant into a binary, unless it's up to date.
+     *
+     * @param binary The binary path.
+     * @param compileJobs The jobs the link waits for.
+     * @param objects Set to the objects in the object directory of the variant, existing and queued ones.
+     *
+     * @return False if there are no objects to link.
+     */
+    bool QueueLink(const std::string& binary, const std::vector<std::size_t>& compileJobs, std::set<std::string>& objects);
+
+    /**
+     * @brief Queues the build of the launcher running the best variant (see VariantLauncher), unless it's up to date.
+     *
+     * The source is generated in '.kole/variants' and compiled straight into the project's binary.
+     *
+     * @param variants The variants that are linked, sorted with VariantLauncher::SortLevels.
+     */
+    void QueueLauncher(const std::vector<std::string>& variants);
+
+    /**
+     * @brief Gets the binary to run or benchmark, the one of the variant given with '--variant' if there is one.
+     */
+    std::string GetRunBinary();
+
+    /**
+     * @brief Stops with an error if '--variant' names a variant that isn't built, before anything is queued.
+     */
+    void CheckRunVariant();
+
+    /**
+     * @brief Queues an archive job for every directory of objects whose archive is out of date.
+     *
+     * Every directory in the object directory gets its own thin archive in '.kole/archives',
+     * which is only created again once one of its objects is compiled, added or removed.
+     *
+     * @param objPath The object directory.
+     * @param files The files to link. The archived objects are removed from it.
+     *
+     * @return The archives to link, including the ones that are up to date.
+     */
+    std::vector<std::string> QueueArchives(const fs::path& objPath, std::vector<std::string>& files);
+
+    /**
+     * @brief Queues a link job for every top-level object directory whose shared library is out of date ('dev_shared').
+     *
+     * The objects of every top-level source directory are linked into their own library in the binary directory
+     * ('src/net/a.cpp' into 'bin/libnet.so'), which is only linked again once one of its objects is compiled, added or removed.
+     *
+     * @param objPath The object directory.
+     * @param files The files to link. The objects linked into libraries are removed from it.
+     * @param commandsChanged Set to whether the link command of any library changed since it was last linked.
+     *
+     * @return The libraries the binary loads, including the ones that are up to date.
+     */
+    std::vector<std::string> QueueSharedLibraries(const fs::path& objPath, std::vector<std::string>& files, bool& commandsChanged);
+
+    /**
+     * @brief Gets the job of every queued output, by its normalized path.
+     */
+    std::map<std::string, std::size_t> GetQueuedJobs();
+
+    /**
+     * @brief Checks if an output built from several files (an archive or a library) is older than them.
+     *
+     * @param output The output path.
+     * @param members The files the output is built from.
+     * @param queuedJobs The jobs of the queued outputs (see GetQueuedJobs).
+     * @param dependencies If given, the jobs building any of the members are added to it.
+     * @param reason If given, set to why the output is out of date.
+     *
+     * @return True if the output is missing, or a member is newer or about to be built.
+     */
+    bool IsGroupOutdated(
+        const std::string& output,
+        const std::vector<std::string>& members,
+        const std::map<std::string, std::size_t>& queuedJobs,
+        std::vector<std::size_t>* dependencies = nullptr,
+        std::string* reason = nullptr
+    );
+
+    /**
+     * @brief Queues the compile, link and run of every test binary.
+     *
+     * Every source file in the test directory is linked with the project's objects (except the one with 'main')
+     * into a binary in 'bin/tests', which is run once per shard after it's linked.
+     *
+     * @param objects The project's objects.
+     * @param projectJobs The jobs building the project's objects, which every test link waits for.
+     */
+    void QueueTests(const std::vector<std::string>& objects, const std::vector<std::size_t>& projectJobs);
+
+    /**
+     * @brief Prints which test runs failed, and exits if any did.
+     */
+    void ReportTests();
+
+    /**
+     * @brief Gets when an output was produced: its modification time, or when it was placed from the cache
+     * if that's later (see BuildRecord::placedTime).
+     *
+     * @param output The output path.
+     * @param error Set if the output doesn't exist.
+     */
+    fs::file_time_type GetOutputTime(const std::string& output, std::error_code& error);
+
+    /**
+     * @brief Checks if a header listed in the dependency file of an object changed after it was built.
+     *
+     * @param depfile The dependency file of the object, empty if the compiler doesn't write one.
+     * @param outputLastModified When the object was built.
+     *
+     * @return Why the object is out of date, or an empty string if none of its headers changed.
+     */
+    std::string FindNewerDependency(const std::string& depfile, fs::file_time_type outputLastModified);
+
+    /**
+     * @brief Describes how a source that is newer than its output changed.
+     *
+     * With '--explain', the contents are compared to the ones the output was built from,
+     * so a source that was only touched is told apart from one that was edited.
+     *
+     * @param source The path to the source file.
+     * @param sourceHash The hash of the source's current contents.
+     * @param record The record of the output, nullptr if there is none.
+     */
+    std::string DescribeSourceChange(const std::string& source, const std::string& sourceHash, const BuildRecord* record);
+
+    /**
+     * @brief Prints why a job runs, if '--explain' was given.
+     *
+     * @param name The source or output the job is run for.
+     * @param reason Why the job runs.
+     */
+    void Explain(const std::string& name, const std::string& reason);
+
+    /**
+     * @brief Writes the build metrics, if '--metrics-json' was given.
+     */
+    void WriteMetrics(bool success);
+
 private:
     std::shared_ptr<BuildConfig> m_config;
     std::shared_ptr<BuildEngine> m_buildEngine;
 
+    BuildOptions m_options;
+    std::shared_ptr<BuildMetrics> m_metrics;
+
+    std::shared_ptr<BuildState> m_buildState;
+    std::shared_ptr<ObjectCache> m_cache;
+    std::unique_ptr<JobScheduler> m_scheduler;
+
+    // Jobs generating headers (UI files), which every source file job depends on
+    std::vector<std::size_t> m_generatedHeaderJobs;
+
+    // NOTE: Only set if modules are used. C++ sources (and the names their objects are made from)
+    // are then collected while scanning the directories, and queued once all of them are known (see QueueModuleSources).
+    std::unique_ptr<ModuleGraph> m_moduleGraph;
+    std::vector<std::pair<fs::path, std::string>> m_moduleSources;
+
+    // Number of queued test runs (one per shard of every test binary)
+    std::size_t m_testJobCount = 0;
+
+    // Outputs of all queued jobs and their job indices, so the link knows about objects that don't exist yet
+    std::vector<std::pair<std::string, std::size_t>> m_queuedOutputs;
+
+    // Normalized outputs of every source, queued or up to date. Objects that aren't one of them are orphaned.
+    std::set<std::string> m_knownOutputs;
+
+    // Archives of the dependencies in the shared directory, built or about to be (see QueueDependencies)
+    std::vector<std::string> m_dependencyArchives;
+
     // NOTE: Usually, only files in the src directories are compiled.
     // But if the user is using Qt, UI & header files also need to be compiled.
     // So instead of checking 3 different arrays of directories,
     // just add the UI, include & src directories to one array
     std::vector<std::string> m_directoriesForCompilation;
 
+    // Variants every source is built for, just the project itself ('') if there are none
+    std::vector<std::string> m_variants;
+
     // NOTE: The output of the LinkObjectFiles is saved, so that it can be ran later by RunBinaryExecutable if needed
     std::string m_output;
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Core/BuildState.hpp"
+
+// An object and the files it was built from, as listed in its dependency file
+struct TranslationUnit
+{
+    std::string source;
+    std::string object;
+
+    // Every header the source includes, directly or not (the compiler lists all of them)
+    std::vector<std::string> headers;
+
+    // Wall time of the last compile of the object in milliseconds, 0 if it wasn't recorded
+    std::uint64_t duration = 0;
+};
+
+// A header and the translation units that include it
+struct HeaderUsage
+{
+    std::string header;
+    std::vector<const TranslationUnit*> units;
+
+    // Summed compile time of the units, which is what touching the header costs
+    std::uint64_t cost = 0;
+};
+
+/**
+ * @brief Answers questions about which sources include which headers, without compiling anything.
+ *
+ * The graph is read from the dependency files the compiler wrote next to the objects (see Depfile),
+ * the same ones incremental builds use, so it's as recent as the last build.
+ */
+class IncludeGraph
+{
+public:
+    /**
+     * @brief Reads the dependency files in the given directories (and their subdirectories).
+     *
+     * @param directories The directories holding objects.
+     * @param buildState The state holding the compile time of every object.
+     */
+    void Load(const std::vector<std::string>& directories, const BuildState& buildState);
+
+    const std::vector<TranslationUnit>& GetUnits() const { return m_units; }
+
+    /**
+     * @brief Finds the unit of a source or an object.
+     *
+     * @return The unit, or nullptr if no dependency file lists the path.
+     */
+    const TranslationUnit* FindUnit(const std::string& path) const;
+
+    /**
+     * @brief Finds the units that include a header, which are rebuilt once it changes.
+     */
+    std::vector<const TranslationUnit*> GetDependents(const std::string& header) const;
+
+    /**
+     * @brief Gets every header with the units including it, the most expensive ones first.
+     */
+    std::vector<HeaderUsage> GetHeaderUsages() const;
+
+private:
+    /**
+     * @brief Makes a path absolute and normal, so the same file is always compared the same way.
+     */
+    static std::string GetKey(const std::string& path);
+
+private:
+    std::vector<TranslationUnit> m_units;
+
+    // Units by the key of every file they were built from
+    std::map<std::string, std::vector<std::size_t>> m_dependents;
+};
@@ -0,0 +1,341 @@
+#pragma once
+
+#include <set>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include "Core/BuildMetrics.hpp"
+#include "Core/BuildOptions.hpp"
+#include "Core/BuildState.hpp"
+#include "Core/ConfigReader.hpp"
+#include "Core/ObjectCache.hpp"
+#include "Utils/Jobserver.hpp"
+
+enum class JobType
+{
+    Codegen,    // UI and moc files, generating sources or headers
+    Compile,    // Source files, compiled to object files
+    Archive,    // Object files of a directory, collected in a thin archive
+    Link,       // Object files, linked to a binary
+    Test,       // A test binary (or one shard of it), run after it's linked
+};
+
+struct Job
+{
+    JobType type;
+
+    std::string command;
+
+    // The file the job is run for, used in log messages
+    std::string source;
+    std::string output;
+
+    // Indices of the jobs that need to finish before this one can start
+    std::vector<std::size_t> dependencies;
+
+    // Recorded with the output once the job succeeds, see BuildEngine::GetCommandSignature
+    std::string signature;
+
+    // Dependency file the command writes, empty if it doesn't write one.
+    // Only compile jobs with one are looked up in the object cache, the cache needs to know their headers.
+    std::string depfile;
+
+    // Milliseconds the job may run before it's killed, 0 if it may run as long as it needs
+    std::uint64_t timeout = 0;
+
+    // Path the command writes to instead of the output (see BuildEngine::GetTemporaryPath), renamed over the output
+    // once the job succeeds and removed otherwise. Empty if the command doesn't write the output (tests).
+    std::string temporaryOutput = "";
+
+    // NOTE: Module units aren't cached, the BMIs they write and read aren't part of the cache entry
+    bool isCacheable = true;
+
+    // Recorded with the output once the job succeeds, so '--explain' can tell what changed in the next build.
+    // The key of the command's template (see BuildState::AddCommand) and the hash of the source's contents.
+    std::string commandKey = "";
+    std::string sourceHash = "";
+};
+
+class JobScheduler
+{
+public:
+    /**
+     * @brief Creates a scheduler and connects it to a jobserver.
+     *
+     * Joins the jobserver inherited from make if there is one,
+     * otherwise starts a new one so that child processes share the same limit.
+     * If no job limit was given, an inherited jobserver is the only limit,
+     * and a new one is started with one job per CPU kole is allowed to use.
+     *
+     * @param config The build config, holding the scheduler settings.
+     * @param options The options of this run, holding the job limit.
+     * @param buildState The state used to predict and record the duration and memory of every job.
+     * @param metrics The metrics every finished job is recorded in.
+     * @param cache The object cache compile jobs are looked up in, nullptr if there is none.
+     */
+    JobScheduler(
+        std::shared_ptr<BuildConfig> config,
+        const BuildOptions& options,
+        std::shared_ptr<BuildState> buildState,
+        std::shared_ptr<BuildMetrics> metrics,
+        std::shared_ptr<ObjectCache> cache
+    );
+
+    /**
+     * @brief Adds a job to the queue.
+     *
+     * Dependencies have to be added before the jobs depending on them.
+     *
+     * @return The index of the job, which other jobs can use as a dependency.
+     */
+    std::size_t AddJob(Job job);
+
+    /**
+     * @brief Runs all queued jobs in parallel, respecting their dependencies.
+     *
+     * Ready jobs are started in order of their longest remaining path (their own duration
+     * plus the longest chain of jobs waiting on them), using the durations of earlier builds,
+     * so the slowest chain starts first instead of whatever the directory order gives.
+     *
+     * A token is acquired from the jobserver for every job past the first one and returned once it finishes.
+     * Jobs are also held back while their predicted memory doesn't fit next to the running ones,
+     * or while the free memory is below the configured headroom.
+     * Once as many jobs failed as the options allow (one by default), no new jobs are started,
+     * but the running ones are waited for. Until then, every job that doesn't depend on a failed one still runs,
+     * and the failures are summed up at the end.
+     * Failed tests are the exception, they're only counted (see GetFailedTests).
+     * Jobs that failed in the previous build are started before all others, so a fix is confirmed quickly.
+     * Jobs running longer than their timeout are killed and fail.
+     * The output of every job is captured and printed once it finishes, together with its result.
+     *
+     * With an object cache, ready compile jobs are looked up first, next to the jobs that are running
+     * (unless everything is rebuilt).
+     * A hit finishes the job without running it, a miss queues it like any other job.
+     * Objects that had to be compiled are uploaded in the background.
+     *
+     * @return True if every job succeeded.
+     */
+    bool Run();
+
+    std::size_t GetJobCount() const { return m_jobs.size(); }
+
+    /**
+     * @brief Retrieves the signal (SIGINT or SIGTERM) that interrupted the last run, 0 if it wasn't interrupted.
+     */
+    int GetInterruptSignal() const { return m_interruptSignal; }
+
+    /**
+     * @brief Retrieves the test jobs that failed (or timed out) in the last run.
+     *
+     * @return The sources of the failed jobs, in the order they finished.
+     */
+    std::vector<std::string> GetFailedTests() const;
+
+private:
+    struct RunningJob
+    {
+        std::size_t index;
+        pid_t pid;
+
+        std::chrono::steady_clock::time_point startTime;
+
+        // Memory reserved for the job when it was started
+        std::uint64_t expectedMemory;
+
+        // Read end of the pipe the job writes its stdout and stderr to, and what was read from it so far.
+        // The output is printed in one piece once the job finishes, so parallel jobs don't interleave.
+        int outputDescriptor;
+        std::string output;
+
+        // Set once the job was killed for running past its timeout
+        bool isTimedOut = false;
+    };
+
+    // Orders ready jobs by whether they failed in the previous build, then by the longest remaining path,
+    // then by the order they were added in
+    struct ReadyJobOrder
+    {
+        const std::vector<std::uint64_t>* priorities;
+        const std::vector<bool>* failedBefore;
+
+        bool operator()(std::size_t a, std::size_t b) const
+        {
+            if ((*failedBefore)[a] != (*failedBefore)[b])
+                return (*failedBefore)[a];
+
+            if ((*priorities)[a] != (*priorities)[b])
+                return (*priorities)[a] > (*priorities)[b];
+
+            return a < b;
+        }
+    };
+
+    /**
+     * @brief Moves the temporary output of a finished job into place, or removes it if the job failed.
+     *
+     * @return False if the output couldn't be moved, which fails the job.
+     */
+    bool CommitOutput(const Job& job, bool isSucceeded);
+
+    /**
+     * @brief Stops every running job after kole was interrupted, removing their temporary outputs.
+     */
+    void StopRunningJobs(int signal);
+
+    /**
+     * @brief Checks if as many jobs failed as are allowed, after which no new jobs are started.
+     */
+    bool IsStopped() const;
+
+    /**
+     * @brief Prints the failed jobs, and how many jobs didn't run because of them.
+     */
+    void PrintFailureSummary() const;
+
+    /**
+     * @brief Calculates the longest remaining path of every job, in milliseconds.
+     */
+    void CalculatePriorities();
+
+    /**
+     * @brief Picks the ready job with the highest priority whose predicted memory fits.
+     *
+     * @return An iterator to the job in the ready set, or the end if none of them fit.
+     */
+    std::set<std::size_t, ReadyJobOrder>::iterator PickNextJob();
+
+    /**
+     * @brief Checks if another job can be started and takes a jobserver token for it if needed.
+     */
+    bool AcquireSlot();
+
+    /**
+     * @brief Returns the slot of a finished job (the implicit one, or a jobserver token).
+     */
+    void ReleaseSlot();
+
+    /**
+     * @brief Checks if the predicted memory of a job fits next to the running jobs.
+     */
+    bool HasMemoryFor(std::size_t index, std::uint64_t availableMemory) const;
+
+    /**
+     * @brief Predicts the memory a job needs from the peak memory it had in earlier builds.
+     */
+    std::uint64_t GetExpectedMemory(std::size_t index) const;
+
+    /**
+     * @brief Predicts the duration of a job (in milliseconds) from earlier builds.
+     */
+    std::uint64_t GetExpectedDuration(std::size_t index) const;
+
+    void StartJob(std::size_t index);
+
+    /**
+     * @brief Blocks until a child exits, writes output or (if requested) a jobserver token becomes available.
+     */
+    void WaitForEvents(bool wantToken);
+
+    /**
+     * @brief Kills the running jobs that are past their timeout. They're reaped like any other job.
+     */
+    void KillTimedOutJobs();
+
+    /**
+     * @brief Gets how long the poll can wait before the next job times out, in milliseconds.
+     */
+    int GetPollTimeout() const;
+
+    /**
+     * @brief Reaps all exited children and queues the jobs that became ready.
+     */
+    void ReapFinishedJobs();
+
+    /**
+     * @brief Finishes the jobs found in the cache, and queues the ones that weren't.
+     */
+    void ProcessCacheLookups();
+
+    /**
+     * @brief Queues a job whose dependencies are done, looking it up in the cache first if it can be cached.
+     */
+    void QueueJob(std::size_t index);
+
+    /**
+     * @brief Queues the jobs that were only waiting for a job that just finished.
+     */
+    void ReleaseDependents(std::size_t index);
+
+    /**
+     * @brief Creates the cache request of a job.
+     */
+    CacheRequest GetCacheRequest(std::size_t index) const;
+
+    /**
+     * @brief Updates the status line with the progress and the estimated time left.
+     *
+     * The estimate is the remaining predicted work spread over the job limit,
+     * but never less than the longest remaining path.
+     */
+    void UpdateStatus();
+
+private:
+    std::vector<Job> m_jobs;
+    std::vector<std::vector<std::size_t>> m_dependents;
+    std::vector<std::size_t> m_pendingDependencies;
+
+    std::vector<std::uint64_t> m_priorities;
+    std::vector<bool> m_failedBefore;
+
+    std::set<std::size_t, ReadyJobOrder> m_readyJobs{ ReadyJobOrder{ &m_priorities, &m_failedBefore } };
+    std::vector<RunningJob> m_runningJobs;
+
+    // Jobs being looked up in the cache
+    std::set<std::size_t> m_lookupJobs;
+
+    std::size_t m_finishedJobs = 0;
+    std::string m_status;
+
+    std::size_t m_maxJobs;
+    std::size_t m_tokensHeld = 0;
+
+    // Number of failed jobs after which no new jobs are started, 0 to run everything that can run
+    std::size_t m_maxFailures;
+
+    // Memory that can be given to jobs, measured when the run starts
+    std::uint64_t m_memoryBudget = 0;
+    std::uint64_t m_memoryReserved = 0;
+    std::uint64_t m_memoryHeadroom = 0;
+
+    // Predictions for jobs that have no record yet
+    std::uint64_t m_defaultMemory = 0;
+    std::uint64_t m_defaultDuration = 0;
+
+    // Used when nothing was recorded at all
+    static constexpr std::uint64_t m_defaultJobMemory = 256ull << 20;
+    static constexpr std::uint64_t m_defaultJobDuration = 1000;
+
+    // NOTE: Only used to avoid logging the same throttling message for every poll
+    bool m_memoryThrottled = false;
+
+    // Descriptor that becomes readable once kole is interrupted, see Process::CatchInterrupts
+    int m_interruptDescriptor = -1;
+    int m_interruptSignal = 0;
+
+    // Failed jobs (except tests), in the order they failed
+    std::vector<std::size_t> m_failedJobs;
+
+    // NOTE: A failed test doesn't stop the build, every other test still runs
+    std::vector<std::size_t> m_failedTests;
+
+    // NOTE: Rebuilding skips the cache lookups, the objects are still stored in the cache
+    bool m_isRebuilding;
+
+    std::shared_ptr<BuildState> m_buildState;
+    std::shared_ptr<BuildMetrics> m_metrics;
+    std::shared_ptr<ObjectCache> m_cache;
+    std::unique_ptr<Jobserver> m_jobserver;
+};
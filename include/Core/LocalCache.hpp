@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+#include "Core/CacheBackend.hpp"
+#include "Core/ConfigReader.hpp"
+
+// Totals of a local cache, for 'kole cache stats'
+struct LocalCacheStats
+{
+    std::uint64_t entries = 0;
+
+    // Size of the entries on disk, and before they were compressed
+    std::uint64_t size = 0;
+    std::uint64_t originalSize = 0;
+
+    // Object lookups of every build using the cache, and where they were found
+    std::uint64_t lookups = 0;
+    std::uint64_t localHits = 0;
+    std::uint64_t remoteHits = 0;
+
+    std::uint64_t evictedEntries = 0;
+    std::uint64_t evictedSize = 0;
+};
+
+/**
+ * @brief Keeps cache entries on the local disk, compressed and within a size limit.
+ *
+ * The entries are spread over 16 shards by the first character of their hash ('<directory>/<shard>/<key>').
+ * Every shard has an index of the sizes of its entries and when they were last used,
+ * and gets an equal part of the size limit.
+ *
+ * Once a write takes a shard over its part, the least recently used entries of that shard are evicted.
+ * Only the shard is locked while it's evicted, and only against other evictions: builds keep reading
+ * and writing it, and a build that finds the shard locked leaves the eviction to whoever holds it.
+ *
+ * Entries are read-only and only ever replaced by renaming a new file over them,
+ * so uncompressed ones can be hard linked into the object directory (see Place).
+ */
+class LocalCache : public CacheBackend
+{
+public:
+    /**
+     * @param directory Where the entries are stored, shared by every project using it.
+     * @param maxSize The size the entries are kept under, in bytes (compressed).
+     * @param compressionLevel The zstd level entries are compressed with, or nullopt to store them as they are.
+     */
+    LocalCache(std::string directory, std::uint64_t maxSize, std::optional<int> compressionLevel);
+
+    /**
+     * @brief Creates the local cache configured in the 'cache' section.
+     *
+     * @return The cache, or nullptr if the project doesn't use one.
+     */
+    static std::unique_ptr<LocalCache> Create(std::shared_ptr<BuildConfig> config);
+
+    bool Get(const std::string& key, std::string& data) override;
+    bool Put(const std::string& key, const std::string& data) override;
+
+    /**
+     * @brief Places an entry at a path without copying it (see FileSystem::PlaceFile).
+     *
+     * A compressed entry is decompressed and stored uncompressed first, so only its first hit reads it.
+     *
+     * @return False if there's no such entry, or it couldn't be decompressed or placed.
+     */
+    bool Place(const std::string& key, const std::string& destination);
+
+    std::string GetDescription() const override { return m_directory; }
+
+    /**
+     * @brief Adds the lookups of a build (and the evictions it did) to the statistics of the cache.
+     */
+    void RecordStats(std::uint64_t lookups, std::uint64_t localHits, std::uint64_t remoteHits);
+
+    /**
+     * @brief Reads the statistics of the cache and totals the indexes of all shards.
+     */
+    LocalCacheStats GetStats();
+
+    /**
+     * @brief Gets the directory used for 'local: auto', in the user's cache directory.
+     */
+    static std::string GetDefaultDirectory();
+
+private:
+    struct IndexEntry
+    {
+        std::uint64_t size = 0;
+        std::uint64_t originalSize = 0;
+
+        // Seconds since the epoch
+        std::uint64_t lastAccess = 0;
+    };
+
+    struct Shard
+    {
+        // NOTE: Only guards the shard against other threads of this build, other builds use the lock file
+        std::mutex mutex;
+
+        // Size of the shard as far as this build knows, read from the index when it's first written to
+        bool isLoaded = false;
+        std::uint64_t size = 0;
+    };
+
+    std::size_t GetShardIndex(const std::string& key) const;
+    std::string GetShardDirectory(std::size_t shard) const;
+
+    /**
+     * @brief Writes an entry as it is (already compressed or not), records it in the index and evicts if needed.
+     *
+     * @param key The key of the entry.
+     * @param compressed What the entry holds on disk.
+     * @param originalSize The size of the entry before it was compressed.
+     */
+    bool Store(const std::string& key, const std::string& compressed, std::size_t originalSize);
+
+    /**
+     * @brief Appends a line to the index of a shard.
+     *
+     * Every line is written with a single append, so builds writing the same index never mix their lines.
+     */
+    void AppendToIndex(std::size_t shard, const std::string& line);
+
+    /**
+     * @brief Reads the index of a shard, with the latest size and access time of every entry.
+     */
+    std::unordered_map<std::string, IndexEntry> ReadIndex(std::size_t shard) const;
+
+    /**
+     * @brief Evicts the least recently used entries of a shard until it's well under its part of the limit.
+     *
+     * The index is rewritten without the evicted entries. Lines other builds append while it's rewritten are lost,
+     * so entries missing from the index are picked up from the directory (using their modification time).
+     */
+    void Evict(std::size_t shard);
+
+    static std::uint64_t GetCurrentTime();
+
+private:
+    std::string m_directory;
+    std::uint64_t m_maxSize;
+    std::optional<int> m_compressionLevel;
+
+    static constexpr std::size_t m_shardCount = 16;
+    std::array<Shard, m_shardCount> m_shards;
+
+    std::atomic<std::uint64_t> m_evictedEntries = 0;
+    std::atomic<std::uint64_t> m_evictedSize = 0;
+
+    // NOTE: Eviction goes a bit under the limit, so it doesn't run again after every write
+    static constexpr double m_evictionTarget = 0.9;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Utils/ModuleScanner.hpp"
+
+/**
+ * @brief Keeps the C++20 module declarations of every source, and orders the sources so interfaces come first.
+ *
+ * Scanning a source is only repeated once it changes (or the command scanning it does),
+ * the results of earlier builds are kept in a file like the build state.
+ */
+class ModuleGraph
+{
+public:
+    ModuleGraph(std::string cachePath) : m_cachePath(cachePath) {}
+
+    /**
+     * @brief Reads the scans saved by earlier builds.
+     */
+    void Load();
+
+    /**
+     * @brief Writes the scans to disk, replacing the previous ones.
+     */
+    void Save();
+
+    /**
+     * @brief Gets the module declarations of a source, scanning it if it changed since it was last scanned.
+     *
+     * @param source The path to the source file.
+     * @param scanCommand The command writing the P1689 dependencies of the source,
+     * or an empty string to read the declarations from the source text (see ModuleScanner).
+     * @param scanOutput The file the scan command writes.
+     */
+    const ModuleUnit& Scan(const std::string& source, const std::string& scanCommand, const std::string& scanOutput);
+
+    /**
+     * @brief Orders sources so that every source comes after the ones providing the modules it imports.
+     *
+     * Sources that don't take part in modules keep their order.
+     * Modules that no source provides are warned about (they might come from the compiler, like 'std').
+     *
+     * @param sources The scanned sources.
+     * @param order Set to the indices of the sources, in the order they can be compiled in.
+     * @return False if the imports form a cycle.
+     */
+    bool Sort(const std::vector<std::string>& sources, std::vector<std::size_t>& order) const;
+
+    /**
+     * @brief Writes a GCC module mapper file ('-fmodule-mapper'), which tells the compiler where every BMI is.
+     *
+     * The file is only replaced if its contents change.
+     *
+     * @param path The path to the mapper file.
+     * @param interfaces The BMI path of every module.
+     */
+    static void WriteMapper(const std::string& path, const std::map<std::string, std::string>& interfaces);
+
+private:
+    struct ScanRecord
+    {
+        // Last write time of the source, and the command it was scanned with
+        std::int64_t modified = 0;
+        std::string signature;
+
+        ModuleUnit unit;
+    };
+
+    std::string m_cachePath;
+    std::map<std::string, ScanRecord> m_records;
+
+    bool m_isChanged = false;
+
+    // Scans file format version, bumped whenever the format changes
+    static constexpr int m_version = 1;
+};
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <map>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#include "Core/CacheBackend.hpp"
+#include "Core/LocalCache.hpp"
+
+// An object the cache is asked about, or given once it was compiled
+struct CacheRequest
+{
+    // Identifies the request when its lookup completes (the index of the job)
+    std::size_t id;
+
+    // Signature of the compile command (see BuildEngine::GetCommandSignature)
+    std::string signature;
+
+    std::string source;
+    std::string output;
+
+    // The dependency file the compiler writes next to the output
+    std::string depfile;
+};
+
+struct CacheLookup
+{
+    std::size_t id;
+    bool isHit;
+};
+
+/**
+ * @brief Reuses compiled objects from a local cache, and shares them between machines through a remote one.
+ *
+ * An object is found in two steps, the way the compiler itself finds its inputs:
+ * - The manifest ('manifests/<key>') is keyed by the command signature and the path and contents of the source.
+ *   It lists every header the object was compiled with together with the hash of its contents,
+ *   and the hash of the object.
+ * - If every listed header still has the same contents, the object is read from 'objects/<hash>'
+ *   and only used if its contents match that hash.
+ *
+ * The local cache is looked in first. Objects found in the remote one are kept in the local one,
+ * and so are the objects compiled by this build.
+ *
+ * Lookups and uploads run on worker threads, so they never hold up compiling.
+ * A completed lookup is signalled on a pipe (see GetCompletionDescriptor), which the scheduler polls.
+ */
+class ObjectCache
+{
+public:
+    /**
+     * @param localCache The cache on this machine, nullptr if there is none.
+     * @param remoteCache The cache shared with other machines, nullptr if there is none.
+     * @param isUploading Whether compiled objects are uploaded to the remote cache, or it's only read.
+     */
+    ObjectCache(std::unique_ptr<LocalCache> localCache, std::unique_ptr<CacheBackend> remoteCache, bool isUploading);
+
+    /**
+     * @brief Waits for the uploads still running.
+     */
+    ~ObjectCache();
+
+    /**
+     * @brief Starts looking up an object.
+     *
+     * On a hit, the object and its dependency file are written before the lookup completes.
+     */
+    void StartLookup(CacheRequest request);
+
+    /**
+     * @brief Starts storing an object that was just compiled in the caches.
+     */
+    void StartUpload(CacheRequest request);
+
+    /**
+     * @brief Takes the lookups that completed since the last call.
+     */
+    std::vector<CacheLookup> TakeCompletedLookups();
+
+    /**
+     * @brief Gets a descriptor that becomes readable when a lookup completes.
+     */
+    int GetCompletionDescriptor() const { return m_completionPipe[0]; }
+
+    /**
+     * @brief Waits until every upload has finished, and records the lookups of the build in the local cache.
+     */
+    void Finish();
+
+private:
+    struct Dependency
+    {
+        std::string path;
+        std::string hash;
+    };
+
+    struct Manifest
+    {
+        std::string objectHash;
+        std::vector<Dependency> dependencies;
+    };
+
+    void RunWorker();
+
+    bool Lookup(const CacheRequest& request);
+    void Upload(const CacheRequest& request);
+
+    /**
+     * @brief Reads the manifest of a request from one of the caches, if all of its dependencies are unchanged.
+     */
+    bool FindManifest(CacheBackend& cache, const CacheRequest& request, const std::string& manifestKey, Manifest& manifest);
+
+    /**
+     * @brief Reads the object of a manifest from one of the caches, and checks it against its hash.
+     */
+    bool GetObject(CacheBackend& cache, const CacheRequest& request, const Manifest& manifest, std::string& object);
+
+    /**
+     * @brief Writes the dependency file of a request, listing the dependencies of its manifest.
+     */
+    bool WriteDepfile(const CacheRequest& request, const Manifest& manifest);
+
+    /**
+     * @brief Writes the object of a request, and its dependency file.
+     */
+    bool WriteObject(const CacheRequest& request, const Manifest& manifest, const std::string& object);
+
+    /**
+     * @brief Gets the key of the manifest of a request.
+     *
+     * @return The key, or an empty string if the source couldn't be read.
+     */
+    std::string GetManifestKey(const CacheRequest& request);
+
+    /**
+     * @brief Hashes a file, reusing the hash if the file was hashed before during this build.
+     *
+     * Most headers are included by many sources, so they would be read again for every one of them.
+     */
+    std::string GetFileHash(const std::string& path);
+
+    static bool ParseManifest(const std::string& data, Manifest& manifest);
+    static std::string FormatManifest(const Manifest& manifest);
+
+    /**
+     * @brief Writes a file through a temporary one, so it only appears once it's complete.
+     */
+    static bool WriteFile(const std::string& path, const std::string& data);
+
+private:
+    std::unique_ptr<LocalCache> m_localCache;
+    std::unique_ptr<CacheBackend> m_remoteCache;
+    bool m_isUploading;
+
+    std::atomic<std::uint64_t> m_lookupCount = 0;
+    std::atomic<std::uint64_t> m_localHits = 0;
+    std::atomic<std::uint64_t> m_remoteHits = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    // Lookups always go first, jobs are waiting for them
+    std::deque<CacheRequest> m_lookups;
+    std::deque<CacheRequest> m_uploads;
+
+    std::vector<CacheLookup> m_completedLookups;
+
+    std::size_t m_activeUploads = 0;
+    bool m_isStopping = false;
+
+    std::vector<std::thread> m_workers;
+
+    int m_completionPipe[2] = { -1, -1 };
+
+    std::mutex m_hashMutex;
+    std::map<std::string, std::string> m_fileHashes;
+
+    // NOTE: Workers mostly wait for the network, so there can be more of them than there are CPUs
+    static constexpr std::size_t m_workerCount = 8;
+
+    // NOTE: Bumped whenever the format of the entries changes, so older entries are never read
+    static constexpr int m_version = 1;
+};
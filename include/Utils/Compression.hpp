@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Compresses data with zstd.
+ *
+ * Objects are mostly debug info, which compresses to a fraction of its size even on the fastest levels.
+ */
+namespace Compression
+{
+    // NOTE: Fast enough that compressing is never slower than writing the uncompressed object to a disk
+    inline constexpr int DEFAULT_LEVEL = 3;
+
+    /**
+     * @brief Compresses data into a single zstd frame.
+     *
+     * @param data The data to compress.
+     * @param level The zstd compression level, from 1 (fastest) to 19 (smallest), or negative for even faster ones.
+     * @param compressed Set to the compressed data.
+     * @return False if zstd failed.
+     */
+    bool Compress(std::string_view data, int level, std::string& compressed);
+
+    /**
+     * @brief Checks if data starts like a zstd frame.
+     */
+    bool IsCompressed(std::string_view data);
+
+    /**
+     * @brief Decompresses data compressed with Compress.
+     *
+     * @return False if the data isn't a complete zstd frame (e.g. it's corrupted or truncated).
+     */
+    bool Decompress(std::string_view data, std::string& decompressed);
+}
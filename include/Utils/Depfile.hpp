@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Reads and writes the make-style dependency files compilers write with '-MMD'.
+ *
+ * They list the files an object was built from ('obj/main.o: src/main.cpp include/a.hpp'),
+ * which is what tells kole that an object is out of date when only a header changed.
+ */
+namespace Depfile
+{
+    /**
+     * @brief Reads the dependencies of the (first) target in a dependency file.
+     *
+     * @param path The path of the dependency file.
+     * @param dependencies Set to the dependencies, in the order they're listed.
+     * @return False if the file doesn't exist or couldn't be parsed.
+     */
+    bool Read(const std::string& path, std::vector<std::string>& dependencies);
+
+    /**
+     * @brief Writes a dependency file with a single target.
+     *
+     * The file is written to a temporary path first, so an interrupted write doesn't leave half of it behind.
+     */
+    bool Write(const std::string& path, const std::string& target, const std::vector<std::string>& dependencies);
+}
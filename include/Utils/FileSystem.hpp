@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+
+namespace FileSystem
+{
+    enum class PlacementMethod
+    {
+        Reflink,    // The copy shares the data of the source until one of them is written to (btrfs, XFS)
+        Hardlink,   // The copy is the source, under another name
+        Copy,       // The data was copied
+    };
+
+    /**
+     * @brief Places a copy of a file at a path, sharing the data with the source where possible.
+     *
+     * Tries a reflink first, then (if allowed) a hard link, and only copies the data if neither works.
+     * The copy is made under a temporary name and renamed over the destination,
+     * so the previous destination is replaced in one step and never written to.
+     *
+     * @param source The file to copy.
+     * @param destination Where the copy is placed.
+     * @param allowHardlink Whether the destination may be the source itself. Only safe if the source is never
+     * written to (like a read-only cache entry) and the destination is removed before it's written.
+     * @param method Set to the way the file was placed, if given.
+     * @return False if the file couldn't be placed at all.
+     */
+    bool PlaceFile(const std::string& source, const std::string& destination, bool allowHardlink, PlacementMethod* method = nullptr);
+
+    /**
+     * @brief Removes a file if it's a hard link, i.e. other names share its data.
+     *
+     * Tools that write their output in place would otherwise write into every other name as well.
+     */
+    void UnlinkIfShared(const std::string& path);
+
+    /**
+     * @brief Writes a file only if its contents differ, so its modification time moves only when it changes.
+     *
+     * The contents are written under a temporary name and renamed over the file,
+     * so a tool reading it never sees half of it. Missing parent directories are created.
+     *
+     * @param path The file to write.
+     * @param contents The contents the file should have.
+     * @param isWritten Set to whether the file was (re)written, if given.
+     * @return False if the file couldn't be written.
+     */
+    bool WriteFileIfChanged(const std::string& path, const std::string& contents, bool* isWritten = nullptr);
+}
@@ -1,16 +1,23 @@
 #pragma once
 
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "Core/ConfigReader.hpp"
 #include "Utils/Logger/Logger.hpp"
+#include "Utils/PackageConfig.hpp"
+#include "Utils/Toolchain.hpp"
 
 class FlagManager
 {
 public:
-    FlagManager(std::shared_ptr<BuildConfig> config) : m_config(config) {}
+    FlagManager(std::shared_ptr<BuildConfig> config, std::shared_ptr<Toolchain> compiler) : m_config(config), m_compiler(compiler)
+    {
+        m_packageConfig = std::make_unique<PackageConfig>(fmt::format("{}/pkg-config", ConfigConstants::STATE_DIRECTORY));
+    }
 
     /**
      * @brief Retrieves and caches the necessary compile flags.
@@ -22,6 +29,15 @@ public:
      */
     std::string GetFlags();
 
+    /**
+     * @brief Retrieves the compile flags of a source, with the overrides matching it applied (see FlagOverride).
+     *
+     * @param source The path to the source file.
+     *
+     * @return The formatted compile flags, the project's if no override matches the source.
+     */
+    std::string GetFlags(const std::string& source);
+
     /**
      * @brief Retrieves and caches the necessary include paths.
      *
@@ -31,17 +47,47 @@ public:
      */
     std::string GetIncludePaths();
 
+    /**
+     * @brief Retrieves flags that only change how diagnostics look.
+     *
+     * Compiler output is captured through a pipe, so colors are forced if kole itself writes to a terminal
+     * (and the compiler supports it), unless the flags already decide.
+     *
+     * @return The flags, or an empty string if none are needed.
+     */
+    std::string GetDiagnosticFlags();
+
 private:
-    std::string GetOptimization();
+    /**
+     * @brief Puts the compile flags together, the same way for the project and for the sources matching overrides.
+     *
+     * @param optimizationLevel The optimization level ('debug', 'release', ...).
+     * @param commonFlags The flags given for every platform.
+     */
+    std::string ComposeFlags(const std::string& optimizationLevel, const std::string& commonFlags);
+
+    /**
+     * @brief Gets the flag of an optimization level ('debug', 'release', ...), 'debug' if the level isn't known.
+     */
+    std::string GetOptimization(const std::string& level);
 
     std::string GetPlatformFlags();
 
+    /**
+     * @brief Replaces packages in the flags (e.g. '$qt5') with their pkg-config flags.
+     */
     std::string ProcessPlatformFlags(const std::string& flags);
 
 private:
     std::shared_ptr<BuildConfig> m_config;
+    std::shared_ptr<Toolchain> m_compiler;
+    std::unique_ptr<PackageConfig> m_packageConfig;
     std::string m_flags;
     std::string m_includePaths;
+    std::optional<std::string> m_diagnosticFlags;
+
+    // Flags of the sources matching overrides, by the indices of the overrides they match
+    std::map<std::vector<std::size_t>, std::string> m_overrideFlags;
 
     std::map<std::string, std::string> m_optimizationLevels = {
         { "none",         "-O0"    },  // No optimization
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <string_view>
+
+namespace Hash
+{
+    /**
+     * @brief Hashes data with 64-bit FNV-1a.
+     *
+     * Only meant for telling whether something changed (commands, compiler output),
+     * it's not a cryptographic hash.
+     *
+     * @param data The data to hash.
+     * @param seed A previous hash, to continue hashing more data.
+     */
+    std::uint64_t Fnv1a(std::string_view data, std::uint64_t seed = 0xcbf29ce484222325ull);
+
+    /**
+     * @brief Formats a hash as 16 hexadecimal characters.
+     */
+    std::string ToHex(std::uint64_t hash);
+
+    /**
+     * @brief Hashes data with SHA-256.
+     *
+     * Used where a collision would silently give a wrong result, like the keys and contents of cached objects.
+     *
+     * @return The hash as 64 hexadecimal characters.
+     */
+    std::string Sha256(std::string_view data);
+
+    /**
+     * @brief Hashes the contents of a file with SHA-256.
+     *
+     * @return The hash, or an empty string if the file couldn't be read.
+     */
+    std::string Sha256File(const std::string& path);
+}
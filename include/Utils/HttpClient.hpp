@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+/**
+ * @brief A minimal HTTP/1.1 client, just enough to talk to a cache server.
+ *
+ * Every request opens its own connection and closes it once the response was read.
+ * Only plain 'http://' URLs are supported.
+ */
+namespace HttpClient
+{
+    struct Response
+    {
+        int status = 0;
+        std::string body;
+    };
+
+    /**
+     * @brief Sends a request and reads the whole response.
+     *
+     * @param method The request method (e.g. 'GET' or 'PUT').
+     * @param url The URL, as 'http://host[:port]/path'.
+     * @param body The body sent with the request, empty for none.
+     * @param response Set to the status and body of the response.
+     * @param timeout How long connecting, sending and every read may take, in milliseconds.
+     * @return False if the server couldn't be reached or the response couldn't be parsed.
+     */
+    bool Request(const std::string& method, const std::string& url, const std::string& body, Response& response, int timeout = 10000);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Client and server for the GNU make jobserver protocol.
+ *
+ * Every process in a jobserver group holds one implicit token and has to read
+ * an extra token from the shared pipe (or fifo) for every additional job it runs.
+ * Tokens are written back once the job finishes.
+ */
+class Jobserver
+{
+public:
+    ~Jobserver();
+
+    /**
+     * @brief Connects to a jobserver inherited through MAKEFLAGS.
+     *
+     * Supports both the pipe style ('--jobserver-auth=R,W') and the fifo style
+     * ('--jobserver-auth=fifo:PATH') of GNU make.
+     *
+     * @return The connected jobserver, or nullptr if there is none (or it can't be used).
+     */
+    static std::unique_ptr<Jobserver> Connect();
+
+    /**
+     * @brief Creates a new jobserver, making kole the top-level process.
+     *
+     * Fills a pipe with (jobs - 1) tokens and exports it through MAKEFLAGS,
+     * so that child processes (e.g. '-flto=jobserver' links or nested builds) share the same limit.
+     *
+     * @param jobs The total number of jobs allowed at once.
+     * @return The created jobserver, or nullptr if the pipe couldn't be created.
+     */
+    static std::unique_ptr<Jobserver> Create(std::size_t jobs);
+
+    /**
+     * @brief Tries to read a token without blocking.
+     *
+     * @return True if a token was acquired.
+     */
+    bool TryAcquire();
+
+    /**
+     * @brief Writes a previously acquired token back.
+     */
+    void Release();
+
+    /**
+     * @brief Gets the descriptor tokens are read from, so it can be polled.
+     */
+    int GetReadDescriptor() const { return m_readFd; }
+
+    bool IsServer() const { return m_isServer; }
+
+private:
+    Jobserver() = default;
+
+    /**
+     * @brief Opens a private, non-blocking read descriptor for a pipe.
+     *
+     * Setting O_NONBLOCK on the inherited descriptor would change it for every
+     * process sharing it, so a new description is opened through /proc instead.
+     */
+    void OpenNonBlockingReader(int inheritedFd);
+
+private:
+    int m_readFd = -1;
+    int m_writeFd = -1;
+
+    // Descriptors that belong to this object only (and are closed with it)
+    std::vector<int> m_ownedDescriptors;
+
+    // NOTE: Only true when no private descriptor could be opened.
+    // Reads are then preceded by a poll, which leaves a tiny window where another process can take the token.
+    bool m_blockingReader = false;
+
+    bool m_isServer = false;
+
+    // The token bytes currently held, so the same ones are written back
+    std::string m_tokens;
+};
@@ -17,8 +17,15 @@ namespace LogTypes
 
     void EnableDebug();
 
+    /**
+     * @brief Checks if a log type should be logged.
+     *
+     * Fatal and Assert can't be disabled.
+     */
+    bool IsEnabled(LogType type);
+
     // NAMESPACE VARIABLES
 
     extern std::map<LogType, bool> LogTypeStatuses;
     extern std::map<LogType, std::string> LogTypePrefixes;
-}
\ No newline at end of file
+}
@@ -3,23 +3,91 @@
 #include <iostream>
 #include <string>
 #include <memory>
+#include <functional>
 #include <fmt/core.h>
 
 #include "Utils/Logger/LogTypes.hpp"
 
+// NOTE: Messages are formatted only after the log type is checked, so disabled logs (usually Debug)
+// cost almost nothing. Formatted messages are handed to a background thread which writes them,
+// so the calling thread never waits for the console.
+
 namespace Logger
 {
-    void Log(LogTypes::LogType type, std::string message);
+    void Log(LogTypes::LogType type, const std::string& message);
+
+    /**
+     * @brief Prints captured output (e.g. compiler diagnostics) as is, in one piece.
+     */
+    void Output(const std::string& output);
+
+    /**
+     * @brief Sets the status line shown below all other output (e.g. build progress).
+     *
+     * Only shown if the output is a terminal. An empty status removes the line.
+     */
+    void Status(const std::string& status);
+
+    /**
+     * @brief Blocks until every message logged so far has been written.
+     */
+    void Flush();
+
+    /**
+     * @brief Sets a function Exit calls with the exit code before the program exits, e.g. to record a failed build.
+     *
+     * It's called at most once, an exit from inside it doesn't call it again.
+     */
+    void SetExitHandler(std::function<void(int)> handler);
+
+    /**
+     * @brief Flushes all messages and exits the program.
+     */
+    [[noreturn]] void Exit(int code);
+
+    template<typename... Args>
+    void Info(fmt::format_string<Args...> format, Args&&... args)
+    {
+        if (!LogTypes::IsEnabled(LogTypes::LogType::Info)) return;
+        Log(LogTypes::LogType::Info, fmt::format(format, std::forward<Args>(args)...));
+    }
 
-    void Info(std::string message);
+    template<typename... Args>
+    void Debug(fmt::format_string<Args...> format, Args&&... args)
+    {
+        if (!LogTypes::IsEnabled(LogTypes::LogType::Debug)) return;
+        Log(LogTypes::LogType::Debug, fmt::format(format, std::forward<Args>(args)...));
+    }
 
-    void Debug(std::string message);
+    template<typename... Args>
+    void Warning(fmt::format_string<Args...> format, Args&&... args)
+    {
+        if (!LogTypes::IsEnabled(LogTypes::LogType::Warning)) return;
+        Log(LogTypes::LogType::Warning, fmt::format(format, std::forward<Args>(args)...));
+    }
 
-    void Warning(std::string message);
+    template<typename... Args>
+    void Error(fmt::format_string<Args...> format, Args&&... args)
+    {
+        if (!LogTypes::IsEnabled(LogTypes::LogType::Error)) return;
+        Log(LogTypes::LogType::Error, fmt::format(format, std::forward<Args>(args)...));
+    }
 
-    void Error(std::string message);
+    template<typename... Args>
+    [[noreturn]] void Fatal(fmt::format_string<Args...> format, Args&&... args)
+    {
+        Log(LogTypes::LogType::Fatal, fmt::format(format, std::forward<Args>(args)...));
+        Log(LogTypes::LogType::Fatal, "Exiting program...");
+        Exit(1);
+    }
 
-    void Fatal(std::string message);
+    template<typename... Args>
+    void Assert(bool condition, fmt::format_string<Args...> format, Args&&... args)
+    {
+        if (condition) return;
 
-    void Assert(bool condition, std::string message);
-};
\ No newline at end of file
+        Log(LogTypes::LogType::Assert, fmt::format(format, std::forward<Args>(args)...));
+        Log(LogTypes::LogType::Assert, "Exiting program...");
+        Exit(1);
+    }
+};
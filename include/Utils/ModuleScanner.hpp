@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// The C++20 module declarations of a source file
+struct ModuleUnit
+{
+    // Module the source provides a BMI for (e.g. 'math' or 'math:detail'), empty if it provides none
+    std::string provides;
+
+    // Whether the source is an interface unit ('export module'), as opposed to an implementation partition
+    bool isInterface = false;
+
+    // Modules the source imports, including the one an implementation unit ('module math;') belongs to
+    std::vector<std::string> imports;
+};
+
+/**
+ * @brief Finds the modules a source file provides and imports, so that interfaces can be compiled before their importers.
+ *
+ * Compilers that support P1689 (GCC 14's '-fdeps-format=p1689r5') write the dependencies themselves,
+ * after preprocessing. Older ones get a scan of the module declarations in the source text.
+ */
+namespace ModuleScanner
+{
+    /**
+     * @brief Reads the module declarations from the text of a source file.
+     *
+     * Comments and string literals are skipped, but the preprocessor isn't run,
+     * so declarations inside '#if' blocks are always taken.
+     *
+     * @param path The path of the source file.
+     * @param unit Set to the module declarations of the source.
+     * @return False if the file couldn't be read.
+     */
+    bool Scan(const std::string& path, ModuleUnit& unit);
+
+    /**
+     * @brief Reads the dependencies of the first rule in a P1689 file.
+     *
+     * @param path The path of the file the compiler wrote.
+     * @param unit Set to the module declarations of the source.
+     * @return False if the file doesn't exist or isn't valid P1689.
+     */
+    bool ReadP1689(const std::string& path, ModuleUnit& unit);
+}
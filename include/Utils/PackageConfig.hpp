@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Resolves pkg-config packages to compiler flags, once per build.
+ *
+ * The flags are cached on disk together with everything that could change them:
+ * the pkg-config environment variables, and the modification times of the search directories
+ * and the .pc files of the packages and everything they require. As long as none of them changed, pkg-config isn't run at all.
+ */
+class PackageConfig
+{
+public:
+    PackageConfig(std::string cachePath) : m_cachePath(cachePath) {}
+
+    /**
+     * @brief Gets the compile and link flags of packages ('pkg-config --cflags --libs').
+     *
+     * @param packages The names of the packages.
+     * @param flags Set to the flags of all packages.
+     * @return False if pkg-config failed, e.g. because a package isn't installed.
+     */
+    bool Resolve(const std::vector<std::string>& packages, std::string& flags);
+
+private:
+    struct CacheEntry
+    {
+        std::string environment;
+        std::string packages;
+
+        // Files (and directories) the flags were resolved from, with their modification times
+        std::vector<std::pair<std::string, std::string>> files;
+
+        std::string flags;
+    };
+
+    /**
+     * @brief Reads the cached entry, if it's still valid for the packages.
+     */
+    bool LoadCache(const std::string& environment, const std::string& packages, std::string& flags);
+
+    void SaveCache(const CacheEntry& entry);
+
+    /**
+     * @brief Collects the files pkg-config reads for the packages.
+     *
+     * Every search directory is included, so installing or removing a package is noticed,
+     * together with the first .pc file found in them of every package and of everything it requires
+     * ('Requires' and 'Requires.private', followed all the way down).
+     */
+    std::vector<std::pair<std::string, std::string>> GetDependencyFiles(const std::vector<std::string>& packages);
+
+    /**
+     * @brief Gets the modification time of a file as a string, or '-' if it doesn't exist.
+     */
+    static std::string GetModificationTime(const std::string& path);
+
+    /**
+     * @brief Gets the pkg-config variables that change what it resolves, as one string.
+     */
+    static std::string GetEnvironment();
+
+private:
+    std::string m_cachePath;
+
+    // NOTE: Bumped whenever the format changes, older caches are then ignored
+    static constexpr int m_version = 1;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <sys/types.h>
+
+namespace Process
+{
+    struct ProcessResult
+    {
+        // Exit code of the child, 128 + signal if it was killed
+        int exitCode = -1;
+
+        // Peak resident memory of the child and its descendants, in bytes
+        std::uint64_t peakMemory = 0;
+
+        // CPU time spent by the child and its descendants, in microseconds
+        std::uint64_t userTime = 0;
+        std::uint64_t systemTime = 0;
+
+        // Blocks the child and its descendants read from and wrote to the disk (the page cache doesn't count)
+        std::uint64_t blockInputs = 0;
+        std::uint64_t blockOutputs = 0;
+
+        // Times the child and its descendants gave up the CPU (e.g. waiting for I/O), and were made to give it up
+        std::uint64_t voluntarySwitches = 0;
+        std::uint64_t involuntarySwitches = 0;
+    };
+
+    /**
+     * @brief Starts a command through the shell without waiting for it.
+     *
+     * The child inherits the environment and open descriptors of kole,
+     * which is what lets it reach the jobserver.
+     *
+     * @param command The command to run.
+     * @param outputDescriptor If given, stdout and stderr of the child are redirected to a pipe,
+     * and this is set to its (non-blocking) read end, which the caller has to close.
+     * @param isGroupLeader Whether the child gets a process group of its own, so that it and everything
+     * it starts can be stopped together (see Kill). It then no longer gets the signals of the terminal.
+     * @param errorDescriptor If given together with outputDescriptor, stderr gets a pipe of its own
+     * instead of sharing the one of stdout, and this is set to its (non-blocking) read end.
+     * @return The process id of the child, or -1 if it couldn't be started.
+     */
+    pid_t Spawn(const std::string& command, int* outputDescriptor = nullptr, bool isGroupLeader = false, int* errorDescriptor = nullptr);
+
+    /**
+     * @brief Sends a signal to a child and, if it leads a process group, to everything it started.
+     */
+    void Kill(pid_t pid, int signal);
+
+    /**
+     * @brief Reads everything currently available from a non-blocking descriptor.
+     *
+     * @return False once the descriptor reached its end (or failed).
+     */
+    bool ReadAvailable(int descriptor, std::string& output);
+
+    /**
+     * @brief Runs a command through the shell and waits for it to finish.
+     *
+     * @param command The command to run.
+     * @param output Set to everything the command wrote to stdout and stderr.
+     * @param result If given, set to the exit code and resource usage of the command.
+     * @return The exit code of the command (see ProcessResult), -1 if it couldn't be started.
+     */
+    int Run(const std::string& command, std::string& output, ProcessResult* result = nullptr);
+
+    /**
+     * @brief Runs a command through the shell and waits for it to finish, keeping stdout and stderr apart.
+     *
+     * For commands whose stdout is used as data, which warnings on stderr would otherwise end up in.
+     *
+     * @param command The command to run.
+     * @param output Set to everything the command wrote to stdout.
+     * @param errorOutput Set to everything the command wrote to stderr.
+     * @return The exit code of the command (see ProcessResult), -1 if it couldn't be started.
+     */
+    int Run(const std::string& command, std::string& output, std::string& errorOutput);
+
+    /**
+     * @brief Waits for a child process to exit and reaps it.
+     *
+     * @param pid The process id returned by Spawn.
+     * @param result Set to the exit code and resource usage of the child.
+     */
+    void Wait(pid_t pid, ProcessResult& result);
+
+    /**
+     * @brief Checks whether a child process has exited, without blocking.
+     *
+     * @param pid The process id returned by Spawn.
+     * @param result Set to the exit code and resource usage of the child.
+     * @return True if the child has exited and was reaped.
+     */
+    bool TryWait(pid_t pid, ProcessResult& result);
+
+    /**
+     * @brief Gets a descriptor that becomes readable whenever a child exits.
+     *
+     * Installs a SIGCHLD handler the first time it's called, so that the scheduler
+     * can poll for finished children together with other descriptors.
+     */
+    int GetChildSignalDescriptor();
+
+    /**
+     * @brief Empties the child signal descriptor after it was reported as readable.
+     */
+    void DrainChildSignals();
+
+    /**
+     * @brief Catches SIGINT and SIGTERM instead of exiting, until ReleaseInterrupts is called.
+     *
+     * @return A descriptor that becomes readable once one of them arrives.
+     */
+    int CatchInterrupts();
+
+    /**
+     * @brief Restores the default handling of SIGINT and SIGTERM.
+     */
+    void ReleaseInterrupts();
+
+    /**
+     * @brief Gets the interrupt that arrived since interrupts were caught, without blocking.
+     *
+     * @return The signal number, or 0 if none arrived.
+     */
+    int TakeInterrupt();
+}
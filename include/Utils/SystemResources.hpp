@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+namespace SystemResources
+{
+    /**
+     * @brief Get the number of CPUs kole is allowed to use.
+     *
+     * Takes the smallest of the host core count, the CPU affinity mask
+     * and the cgroup v2 CPU quota ('cpu.max'), so containers aren't oversubscribed.
+     */
+    std::size_t GetCpuLimit();
+
+    /**
+     * @brief Get the memory limit of the build, in bytes.
+     *
+     * Uses the cgroup v2 'memory.max' if one is set, otherwise the total memory of the host.
+     */
+    std::uint64_t GetMemoryLimit();
+
+    /**
+     * @brief Get the memory that can currently be used without swapping, in bytes.
+     *
+     * The smaller of the host's available memory and what is left under the cgroup limit.
+     */
+    std::uint64_t GetAvailableMemory();
+
+    /**
+     * @brief Parse a human-readable memory size (e.g. "512M", "2G") to bytes.
+     *
+     * @return The size in bytes, or 0 if it couldn't be parsed.
+     */
+    std::uint64_t ParseMemorySize(const std::string& size);
+
+    /**
+     * @brief Format a size in bytes in a human-readable way (e.g. "1.5G").
+     */
+    std::string FormatMemorySize(std::uint64_t bytes);
+
+    // NAMESPACE VARIABLES
+
+    extern std::string cgroupPath;
+}
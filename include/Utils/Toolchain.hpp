@@ -0,0 +1,105 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+enum class ToolKind
+{
+    Compiler,   // gcc, g++ or anything accepting the same options
+    QtTool,     // moc and uic
+};
+
+/**
+ * @brief Identifies a tool kole runs (its version, target and what it supports).
+ *
+ * Probing runs the tool several times, so the result is cached in the user's cache directory
+ * ('$XDG_CACHE_HOME/kole/toolchains', '~/.cache/kole/toolchains' by default), keyed by the path,
+ * size and modification time of the binary. Upgrading the tool changes them, which probes it again.
+ */
+class Toolchain
+{
+public:
+    /**
+     * @brief Finds the tool and probes it, or loads the result of an earlier probe.
+     *
+     * @param command The command the tool is run with (e.g. 'g++' or 'ccache g++'). The tool in it is looked up
+     * in the PATH (see GetToolName), but it's always run through the whole command.
+     * @param kind What kind of tool it is, which decides what is probed.
+     */
+    Toolchain(std::string command, ToolKind kind);
+
+    /**
+     * @brief Checks if the tool was found.
+     */
+    bool IsFound() const { return !m_path.empty(); }
+
+    /**
+     * @brief Checks if the compiler accepts an option.
+     *
+     * An option is probed the first time it's asked about, and the answer is cached with the rest of the probe,
+     * so every feature probes the options it needs where it uses them.
+     *
+     * @param option The option, which is also what the answer is cached under.
+     * @param probeArguments The arguments the option is probed with, if it needs more than itself (e.g. '-MMD -MF /dev/null').
+     */
+    bool SupportsOption(const std::string& option, const std::string& probeArguments = "");
+
+    /**
+     * @brief Gets a string that changes whenever the tool does.
+     *
+     * Made of the binary, version, target and the builtin defines,
+     * so it's part of every command signature (a new compiler rebuilds everything).
+     */
+    std::string GetFingerprint() const;
+
+    const std::string& GetVersion() const { return m_version; }
+    const std::string& GetTarget() const { return m_target; }
+
+private:
+    /**
+     * @brief Gets the word of a command naming the tool, after any wrappers and variables ('ccache g++' -> 'g++').
+     */
+    static std::string GetToolName(const std::string& command);
+
+    /**
+     * @brief Looks for the binary in the PATH and resolves symlinks (e.g. 'g++' -> 'g++-12').
+     */
+    static std::string FindExecutable(const std::string& command);
+
+    /**
+     * @brief Gets the path of the cache file of a binary.
+     */
+    static std::string GetCachePath(const std::string& path);
+
+    /**
+     * @brief Runs the tool and records what it reports.
+     */
+    void Probe();
+
+    bool LoadCache();
+    void SaveCache();
+
+private:
+    std::string m_command;
+    ToolKind m_kind;
+
+    // Resolved path of the binary, with its size and modification time
+    std::string m_path;
+    std::string m_size;
+    std::string m_modificationTime;
+
+    std::string m_version;
+    std::string m_target;
+
+    // Hash of the predefined macros ('-dM -E'), which also changes with the default language and target options
+    std::string m_definesHash;
+
+    // Where the probe is cached, see GetCachePath
+    std::string m_cachePath;
+
+    // Every option probed so far, and whether the tool accepts it
+    std::map<std::string, bool> m_options;
+
+    // NOTE: Bumped whenever the format changes, older caches are then probed again
+    static constexpr int m_cacheVersion = 4;
+};
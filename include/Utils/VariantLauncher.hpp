@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Generates the launcher of a project built in several variants ('variants' in the config).
+ *
+ * Every variant is the project built for an x86-64 microarchitecture level ('-march=x86-64-v3').
+ * The launcher is a small binary in place of the project's, which checks what the CPU supports
+ * when it starts and replaces itself with the best variant that can run on it.
+ */
+namespace VariantLauncher
+{
+    /**
+     * @brief Checks if a variant is an x86-64 level the launcher knows the CPU features of.
+     */
+    bool IsKnownLevel(const std::string& variant);
+
+    /**
+     * @brief Sorts variants from the oldest level to the newest.
+     */
+    void SortLevels(std::vector<std::string>& variants);
+
+    /**
+     * @brief Gets the name of the binary of a variant ('app' and 'x86-64-v3' to 'app-x86-64-v3').
+     *
+     * @param name The name (or path) of the project's binary, without its extension.
+     * @param extension The extension of the binary, without the dot. Empty if it has none.
+     * @param variant The variant.
+     */
+    std::string GetBinaryName(const std::string& name, const std::string& extension, const std::string& variant);
+
+    /**
+     * @brief Generates the source of the launcher.
+     *
+     * The launcher looks for the variants next to itself, under the names GetBinaryName gives them.
+     *
+     * @param name The name of the project's binary (the launcher's), without its extension.
+     * @param extension The extension of the binary, without the dot. Empty if it has none.
+     * @param variants The variants, sorted with SortLevels.
+     *
+     * @return The C++ source, which only needs the compiler to build (no flags or libraries).
+     */
+    std::string GetSource(const std::string& name, const std::string& extension, const std::vector<std::string>& variants);
+}
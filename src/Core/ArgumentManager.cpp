@@ -15,11 +15,20 @@ void ArgumentManager::ProcessArguments()
     // NOTE: No debug logs can be used here as they won't be enabled until the debug argument is processed.
 
     // Skip the first argument, as it's the name of the executable
-    for (int i = 1; i < m_argc; i++)
+    int i = 1;
+
+    // A command (e.g. 'kole cache stats') is made of the words before the first argument
+    for (; i < m_argc && m_argv[i][0] != '-'; i++)
+        m_command += (m_command.empty() ? "" : " ") + std::string(m_argv[i]);
+
+    if (!m_command.empty() && !m_commands.contains(m_command))
+        this->PrintUnrecognizedCommand(m_command);
+
+    for (; i < m_argc; i++)
     {
         std::string argument(m_argv[i]);
 
-        // If the autorun argument has been 
+        // If the autorun argument has been passed, everything after it belongs to the binary
         if (m_argumentStates.at(Argument::Autorun))
         {
             m_autorunArguments += fmt::format("{} ", argument);
@@ -34,13 +43,11 @@ void ArgumentManager::ProcessArguments()
                 this->PrintUnrecognizedArgument(argument);
         }
 
+        if (argument[0] != '-')
+            this->PrintUnrecognizedArgument(argument);
+
         if (argument.length() == 2 && argument[1] == '-')
-        {
-            if (argument[1] == '-')
-                this->PrintUnspecifiedArgument(true);
-            else
-                this->PrintUnrecognizedArgument(argument);
-        }
+            this->PrintUnspecifiedArgument(true);
 
         bool longhand = argument[1] == '-';
 
@@ -48,45 +55,94 @@ void ArgumentManager::ProcessArguments()
         // and just 1 if it's short-hand
         std::string sequence = argument.substr(longhand ? 2 : 1);
 
-        bool argumentIsFound = false;
-
-        for (const auto& [key, value] : m_argumentIdentifiers)
+        if (longhand)
         {
-            if (longhand)
+            // Values of long-hand arguments can be attached with '=' (e.g. '--jobs=8')
+            std::string value = "";
+            std::size_t separator = sequence.find('=');
+
+            if (separator != std::string::npos)
+            {
+                value = sequence.substr(separator + 1);
+                sequence = sequence.substr(0, separator);
+            }
+
+            bool argumentIsFound = false;
+
+            for (const auto& [key, identifiers] : m_argumentIdentifiers)
             {
                 // The first element of the value array is the short-hand, the second is the long-hand
-                if (sequence == value[1])
+                if (sequence == identifiers[1])
                 {
-                    m_argumentStates[key] = true;
+                    this->SetArgument(key, argument, value, i);
                     argumentIsFound = true;
+                    break;
                 }
             }
-            else
+
+            if (!argumentIsFound) this->PrintUnrecognizedArgument(argument);
+        }
+        else
+        {
+            // Short-hand arguments can be grouped (e.g. '-dr'), so every character is an argument
+            for (std::size_t c = 0; c < sequence.length(); c++)
             {
-                for (char c : sequence)
+                // This converts the char to a string to use the string comparison methods
+                std::string option(1, sequence[c]);
+
+                bool argumentIsFound = false;
+
+                for (const auto& [key, identifiers] : m_argumentIdentifiers)
                 {
-                    // This converts the char to a string to use the string comparison methods
-                    std::string option(1, c);
+                    if (option != identifiers[0]) continue;
+
+                    argumentIsFound = true;
 
-                    if (option == value[0])
+                    // The rest of the sequence is the value (e.g. '-j8'), if the argument takes one
+                    if (m_argumentValueNames.contains(key))
+                    {
+                        this->SetArgument(key, "-" + option, sequence.substr(c + 1), i);
+                        c = sequence.length();
+                    }
+                    else
                     {
-                        m_argumentStates[key] = true;
-                        argumentIsFound = true;
-                        break;
+                        this->SetArgument(key, "-" + option, "", i);
                     }
+
+                    break;
                 }
-            }
 
-            if (argumentIsFound && key == Argument::Help)
-            {
-                this->PrintHelp();
-                exit(0);
+                if (!argumentIsFound) this->PrintUnrecognizedArgument(argument);
             }
-            else if (!argumentIsFound) this->PrintUnrecognizedArgument(argument);
         }
     }
 }
 
+void ArgumentManager::SetArgument(const Argument& argument, const std::string& identifier, const std::string& value, int& index)
+{
+    m_argumentStates[argument] = true;
+
+    if (argument == Argument::Help)
+    {
+        this->PrintHelp();
+        exit(0);
+    }
+
+    if (!m_argumentValueNames.contains(argument)) return;
+
+    if (!value.empty())
+    {
+        m_argumentValues[argument] = value;
+        return;
+    }
+
+    // The value wasn't attached, so it has to be the next argument
+    if (index + 1 >= m_argc)
+        this->PrintMissingValue(identifier);
+
+    m_argumentValues[argument] = m_argv[++index];
+}
+
 void ArgumentManager::PrintHelp()
 {
     PrintUsage();
@@ -113,6 +169,7 @@ void ArgumentManager::PrintHelp()
         for (const auto& identifier : value)
         {
             auto length = identifier.length();
+            if (length == 0) continue;
 
             optionLength += length + 2;
 
@@ -120,6 +177,10 @@ void ArgumentManager::PrintHelp()
             optionLength += length > 1 ? 2 : 1;
         }
 
+        // Add the value name and the space before it
+        if (m_argumentValueNames.contains(key))
+            optionLength += m_argumentValueNames.at(key).length() + 1;
+
         if (optionLength > longestOption)
             longestOption = optionLength;
     }
@@ -130,21 +191,35 @@ void ArgumentManager::PrintHelp()
 
         for (std::size_t i = 0; i < value.size(); i++)
         {
-            if (i > 0) identifiers += ", ";
+            if (value[i].empty()) continue;
+
+            if (!identifiers.empty()) identifiers += ", ";
             if (value[i].length() > 1) identifiers += "-";
 
             identifiers += "-" + value[i];
         }
 
+        if (m_argumentValueNames.contains(key))
+            identifiers += " " + m_argumentValueNames.at(key);
+
         std::cout << std::setw(optionIndentation) << " ";
         std::cout << std::left << std::setw(longestOption + minimalSpaceToDesc) << identifiers;
         std::cout << m_argumentDescriptions.at(key) << std::endl;
     }
+
+    printf("\ncommands:\n");
+
+    for (const auto& [command, description] : m_commands)
+    {
+        std::cout << std::setw(optionIndentation) << " ";
+        std::cout << std::left << std::setw(longestOption + minimalSpaceToDesc) << command;
+        std::cout << description << std::endl;
+    }
 }
 
 void ArgumentManager::PrintUsage()
 {
-    printf("usage: kole");
+    printf("usage: kole [command]");
 
     for (const auto& [key, value] : m_argumentIdentifiers)
     {
@@ -155,13 +230,17 @@ void ArgumentManager::PrintUsage()
         for (std::size_t i = 0; i < value.size(); i++)
         {
             const auto& identifier = value[i];
+            if (identifier.empty()) continue;
 
-            if (i > 0) printf(", ");
+            if (i > 0 && !value[0].empty()) printf(", ");
             if (identifier.length() > 1) printf("-");
 
             printf("-%s", identifier.c_str());
         }
 
+        if (m_argumentValueNames.contains(key))
+            printf(" %s", m_argumentValueNames.at(key).c_str());
+
         printf("]");
     }
 
@@ -175,6 +254,13 @@ void ArgumentManager::PrintUnrecognizedArgument(const std::string& argument)
     exit(1);
 }
 
+void ArgumentManager::PrintUnrecognizedCommand(const std::string& command)
+{
+    printf("%s\n", fmt::format("kole: error: unrecognized command '{}'", command).c_str());
+    printf("info: use -h or --help for help\n");
+    exit(1);
+}
+
 void ArgumentManager::PrintUnspecifiedArgument(bool longhand)
 {
     printf("%s\n", fmt::format("kole: error: unspecified argument after '{}'", longhand ? "--" : "-").c_str());
@@ -182,6 +268,13 @@ void ArgumentManager::PrintUnspecifiedArgument(bool longhand)
     exit(1);
 }
 
+void ArgumentManager::PrintMissingValue(const std::string& argument)
+{
+    printf("%s\n", fmt::format("kole: error: argument '{}' expects a value", argument).c_str());
+    printf("info: use -h or --help for help\n");
+    exit(1);
+}
+
 std::string ArgumentManager::GetAutorunArguments()
 {
     if (m_autorunArguments.empty())
@@ -190,13 +283,43 @@ std::string ArgumentManager::GetAutorunArguments()
     }
     else
     {
-        Logger::Debug(fmt::format("Arguments for binary execution: [{}]", m_autorunArguments));
+        Logger::Debug("Arguments for binary execution: [{}]", m_autorunArguments);
     }
 
     return m_autorunArguments;
 }
 
+std::string ArgumentManager::GetCommand()
+{
+    return m_command;
+}
+
 bool ArgumentManager::GetArgumentState(const Argument& argument)
 {
     return m_argumentStates.at(argument);
 }
+
+std::string ArgumentManager::GetArgumentValue(const Argument& argument)
+{
+    if (!m_argumentValues.contains(argument))
+        return "";
+
+    return m_argumentValues.at(argument);
+}
+
+std::size_t ArgumentManager::GetArgumentNumber(const Argument& argument, std::size_t defaultValue)
+{
+    const std::string value = GetArgumentValue(argument);
+
+    if (value.empty())
+        return defaultValue;
+
+    if (value.find_first_not_of("0123456789") != std::string::npos || value.length() > 9)
+    {
+        printf("%s\n", fmt::format("kole: error: expected a number, got '{}'", value).c_str());
+        printf("info: use -h or --help for help\n");
+        exit(1);
+    }
+
+    return std::stoul(value);
+}
@@ -0,0 +1,308 @@
+#include "Core/BenchmarkRunner.hpp"
+#include "Utils/Logger/Logger.hpp"
+#include "Utils/SystemResources.hpp"
+
+#include <sched.h>
+#include <ctime>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// NOTE: The results are a plain text file with one benchmark per line, oldest first:
+// <binary> <arguments> TAB <key>=<value> TAB <key>=<value> ...
+
+namespace
+{
+    std::string FormatDuration(std::uint64_t microseconds)
+    {
+        if (microseconds < 1000)
+            return fmt::format("{} us", microseconds);
+
+        if (microseconds < 1000000)
+            return fmt::format("{:.2f} ms", microseconds / 1000.0);
+
+        return fmt::format("{:.3f} s", microseconds / 1000000.0);
+    }
+
+    // Nearest-rank percentile of sorted values
+    std::uint64_t GetPercentile(const std::vector<std::uint64_t>& values, double percentile)
+    {
+        const std::size_t rank = static_cast<std::size_t>(std::ceil(percentile * values.size()));
+        return values[std::clamp<std::size_t>(rank, 1, values.size()) - 1];
+    }
+
+    std::uint64_t GetMedian(std::vector<std::uint64_t> values)
+    {
+        std::sort(values.begin(), values.end());
+
+        const std::size_t middle = values.size() / 2;
+
+        if (values.size() % 2 == 0)
+            return (values[middle - 1] + values[middle]) / 2;
+
+        return values[middle];
+    }
+}
+
+bool BenchmarkRunner::Run(const std::string& binary, const std::string& arguments)
+{
+    const std::string command = fmt::format("exec ./{} {}", binary, arguments);
+    const std::string key = arguments.empty() ? binary : fmt::format("{} {}", binary, arguments);
+
+    cpu_set_t originalAffinity;
+    const bool hasAffinity = sched_getaffinity(0, sizeof(originalAffinity), &originalAffinity) == 0;
+
+    if (m_options.benchmarkCpu >= 0 && !this->PinToCpu())
+        return false;
+
+    Logger::Info("Benchmarking {} ({} run(s), {} warm-up run(s))...", binary, m_options.benchmarkRuns, m_options.benchmarkWarmups);
+    Logger::Flush();
+
+    std::vector<std::uint64_t> wallTimes;
+    std::vector<std::uint64_t> userTimes;
+    std::vector<std::uint64_t> systemTimes;
+
+    BenchmarkResult result;
+    bool success = true;
+
+    for (std::size_t i = 0; i < m_options.benchmarkWarmups + m_options.benchmarkRuns; i++)
+    {
+        std::uint64_t wallTime = 0;
+        Process::ProcessResult processResult;
+        std::string output;
+
+        this->RunOnce(command, wallTime, processResult, output);
+
+        if (processResult.exitCode != 0)
+        {
+            Logger::Error("Run {} of the binary failed with exit code {}", i + 1, processResult.exitCode);
+            Logger::Output(output);
+
+            success = false;
+            break;
+        }
+
+        // Warm-up runs fill the page cache and the CPU caches, their results aren't kept
+        if (i < m_options.benchmarkWarmups)
+            continue;
+
+        wallTimes.push_back(wallTime);
+        userTimes.push_back(processResult.userTime);
+        systemTimes.push_back(processResult.systemTime);
+
+        result.peakMemory = std::max(result.peakMemory, processResult.peakMemory);
+    }
+
+    if (hasAffinity && m_options.benchmarkCpu >= 0)
+        sched_setaffinity(0, sizeof(originalAffinity), &originalAffinity);
+
+    if (!success)
+        return false;
+
+    std::sort(wallTimes.begin(), wallTimes.end());
+
+    result.runs = wallTimes.size();
+    result.minimum = wallTimes.front();
+    result.median = GetMedian(wallTimes);
+    result.p95 = GetPercentile(wallTimes, 0.95);
+    result.userTime = GetMedian(userTimes);
+    result.systemTime = GetMedian(systemTimes);
+
+    BenchmarkResult previous;
+    const bool hasPrevious = this->LoadPrevious(key, previous);
+
+    this->PrintResult(binary, result, hasPrevious ? &previous : nullptr);
+    this->Save(key, result);
+
+    return true;
+}
+
+void BenchmarkRunner::RunOnce(const std::string& command, std::uint64_t& wallTime, Process::ProcessResult& result, std::string& output)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    // NOTE: The shell replaces itself with the binary (exec), so the usage wait4 reports is the binary's own
+    Process::Run(command, output, &result);
+
+    wallTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool BenchmarkRunner::PinToCpu()
+{
+    if (m_options.benchmarkCpu >= CPU_SETSIZE)
+    {
+        Logger::Error("CPU {} doesn't exist", m_options.benchmarkCpu);
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(m_options.benchmarkCpu, &set);
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+    {
+        Logger::Error("Failed to pin the benchmark to CPU {}, it may not exist or be outside of the allowed CPUs", m_options.benchmarkCpu);
+        return false;
+    }
+
+    Logger::Debug("Pinned the benchmark to CPU {}", m_options.benchmarkCpu);
+    return true;
+}
+
+void BenchmarkRunner::PrintResult(const std::string& binary, const BenchmarkResult& result, const BenchmarkResult* previous)
+{
+    std::string text;
+
+    text += fmt::format("Wall time:    min {}, median {}, p95 {}\n", FormatDuration(result.minimum), FormatDuration(result.median), FormatDuration(result.p95));
+    text += fmt::format("CPU time:     user {}, system {} (median)\n", FormatDuration(result.userTime), FormatDuration(result.systemTime));
+    text += fmt::format("Peak memory:  {}\n", SystemResources::FormatMemorySize(result.peakMemory));
+
+    if (previous != nullptr)
+        text += fmt::format("Previous:     median {} ({} run(s))\n", FormatDuration(previous->median), previous->runs);
+
+    Logger::Output(text);
+
+    if (previous == nullptr || previous->median == 0)
+        return;
+
+    const double change = (static_cast<double>(result.median) - previous->median) / previous->median;
+
+    if (change > m_slowdownThreshold)
+        Logger::Warning("{} is {:.1f}% slower than in the previous benchmark", binary, change * 100);
+    else if (change < -m_slowdownThreshold)
+        Logger::Info("{} is {:.1f}% faster than in the previous benchmark", binary, -change * 100);
+}
+
+bool BenchmarkRunner::LoadPrevious(const std::string& key, BenchmarkResult& result)
+{
+    std::ifstream file(m_resultsPath);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    std::getline(file, line);
+
+    if (line != fmt::format("kole-benchmarks {}", m_version))
+    {
+        Logger::Debug("Benchmark results are from a different version of kole. Ignoring...");
+        return false;
+    }
+
+    bool isFound = false;
+
+    // The newest result is the last one, so every matching line replaces the one before
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+
+        std::string lineKey;
+        if (!std::getline(stream, lineKey, '\t') || lineKey != key)
+            continue;
+
+        BenchmarkResult lineResult;
+        std::string field;
+
+        while (std::getline(stream, field, '\t'))
+        {
+            const std::size_t separator = field.find('=');
+            if (separator == std::string::npos) continue;
+
+            const std::string name = field.substr(0, separator);
+            const std::string value = field.substr(separator + 1);
+
+            try
+            {
+                if (name == "runs")
+                    lineResult.runs = std::stoull(value);
+                else if (name == "min")
+                    lineResult.minimum = std::stoull(value);
+                else if (name == "median")
+                    lineResult.median = std::stoull(value);
+                else if (name == "p95")
+                    lineResult.p95 = std::stoull(value);
+                else if (name == "user")
+                    lineResult.userTime = std::stoull(value);
+                else if (name == "system")
+                    lineResult.systemTime = std::stoull(value);
+                else if (name == "peak_memory")
+                    lineResult.peakMemory = std::stoull(value);
+            }
+            catch (const std::exception&)
+            {
+                Logger::Debug("Invalid value '{}' for '{}' in the benchmark results", value, name);
+            }
+        }
+
+        result = lineResult;
+        isFound = true;
+    }
+
+    return isFound;
+}
+
+void BenchmarkRunner::Save(const std::string& key, const BenchmarkResult& result)
+{
+    std::vector<std::string> lines;
+
+    {
+        std::ifstream file(m_resultsPath);
+        std::string line;
+
+        if (file.is_open() && std::getline(file, line) && line == fmt::format("kole-benchmarks {}", m_version))
+        {
+            while (std::getline(file, line))
+            {
+                if (!line.empty())
+                    lines.push_back(line);
+            }
+        }
+    }
+
+    lines.push_back(fmt::format(
+        "{}\ttime={}\truns={}\tmin={}\tmedian={}\tp95={}\tuser={}\tsystem={}\tpeak_memory={}",
+        key,
+        std::time(nullptr),
+        result.runs,
+        result.minimum,
+        result.median,
+        result.p95,
+        result.userTime,
+        result.systemTime,
+        result.peakMemory
+    ));
+
+    if (lines.size() > m_maxResults)
+        lines.erase(lines.begin(), lines.end() - m_maxResults);
+
+    try
+    {
+        const fs::path resultsPath = m_resultsPath;
+        fs::create_directories(resultsPath.parent_path());
+
+        // Write to a temporary file first, so an interrupted save doesn't lose the old results
+        const fs::path temporaryPath = resultsPath.string() + ".tmp";
+
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::Warning("Failed to open '{}' for writing the benchmark results", temporaryPath.string());
+            return;
+        }
+
+        file << fmt::format("kole-benchmarks {}\n", m_version);
+
+        for (const auto& line : lines)
+            file << line << '\n';
+
+        file.close();
+        fs::rename(temporaryPath, resultsPath);
+    }
+    catch (const std::exception& e)
+    {
+        Logger::Warning("Failed to save the benchmark results: {}", e.what());
+    }
+}
@@ -1,11 +1,14 @@
 #include "Core/BuildEngine.hpp"
 
 #include <map>
+#include <unistd.h>
 #include <algorithm>
 #include <fmt/core.h>
 #include <filesystem>
 #include <functional>
 
+#include "Utils/FileSystem.hpp"
+#include "Utils/Hash.hpp"
 #include "Utils/Logger/Logger.hpp"
 #include "Utils/Platform.hpp"
 
@@ -14,7 +17,9 @@ namespace fs = std::filesystem;
 BuildEngine::BuildEngine(std::shared_ptr<BuildConfig> config)
 {
     m_config = config;
-    m_flagManager = std::make_unique<FlagManager>(m_config);
+
+    m_compiler = std::make_shared<Toolchain>(m_config->compiler, ToolKind::Compiler);
+    m_flagManager = std::make_unique<FlagManager>(m_config, m_compiler);
 }
 
 std::string BuildEngine::GetOutputPath(std::string sourceFileName, const std::string& sourceExtension)
@@ -22,16 +27,18 @@ std::string BuildEngine::GetOutputPath(std::string sourceFileName, const std::st
     std::string outputExtension;
     std::string outputDirectory;
 
+    const std::string objectDirectory = GetObjectDirectory();
+
     // Determine output extension and directory based on source file extension
     if (sourceExtension == "cpp" || sourceExtension == "c")
     {
         outputExtension = "o";
-        outputDirectory = "obj";
+        outputDirectory = objectDirectory;
     }
     else if (sourceExtension == "h" || sourceExtension == "hpp")
     {
         outputExtension = "cpp";
-        outputDirectory = "obj";
+        outputDirectory = objectDirectory;
         sourceFileName = m_config->qtSupport.at("moc_prefix") + sourceFileName;
     }
     else if (sourceExtension == "ui")
@@ -42,7 +49,7 @@ std::string BuildEngine::GetOutputPath(std::string sourceFileName, const std::st
     }
     else
     {
-        Logger::Warning(fmt::format("Unsupported file extension: {}", sourceExtension));
+        Logger::Warning("Unsupported file extension: {}", sourceExtension);
         return "";
     }
 
@@ -71,48 +78,365 @@ std::string BuildEngine::GetCompileCommandForFile(const std::string& sourceExten
         return GetCompileCommandForUIFile(sourcePath, outputPath);
     }
 
-    Logger::Warning(fmt::format("Unrecognized source extension: '{}'", sourceExtension));
+    Logger::Warning("Unrecognized source extension: '{}'", sourceExtension);
     return "";
 }
 
-std::string BuildEngine::GetLinkCommandForProject(const std::vector<std::string>& files, const std::string& output)
+std::string BuildEngine::GetLinkCommandForProject(
+    const std::vector<std::string>& files,
+    const std::vector<std::string>& archives,
+    const std::vector<std::string>& sharedLibraries,
+    const std::string& output,
+    const std::string& extraFlags,
+    bool* inputsChanged
+)
 {
     std::string flags = m_flagManager->GetFlags();
-    std::string objectFiles = "";
+    std::vector<std::string> inputs;
+
+    // NOTE: Every member of the archives is linked, like the objects would be.
+    // Otherwise objects nothing refers to (e.g. ones registering themselves in static initializers) would be dropped.
+    if (!archives.empty())
+    {
+        inputs.push_back("-Wl,--whole-archive");
+        inputs.insert(inputs.end(), archives.begin(), archives.end());
+        inputs.push_back("-Wl,--no-whole-archive");
+    }
 
-    for (const auto& file : files)
+    inputs.insert(inputs.end(), files.begin(), files.end());
+
+    // NOTE: The libraries can refer to each other without the binary referring to all of them,
+    // so they're kept even where the linker drops libraries that aren't needed by default ('--as-needed').
+    // The binary finds them next to itself, and exports its own symbols for them ('-rdynamic').
+    std::string libraryFlags;
+
+    if (!sharedLibraries.empty())
     {
-        objectFiles += file + " ";
+        inputs.push_back("-Wl,--push-state,--no-as-needed");
+        inputs.insert(inputs.end(), sharedLibraries.begin(), sharedLibraries.end());
+        inputs.push_back("-Wl,--pop-state");
+
+        libraryFlags = " -rdynamic '-Wl,-rpath,$ORIGIN'";
     }
 
+    const bool isWritten = WriteResponseFile(GetResponseFilePath(output), inputs);
+
+    if (inputsChanged != nullptr)
+        *inputsChanged = isWritten;
+
     std::string command = fmt::format(
-        "{} {} -o {} {}",
+        "{} @{} -o {} {}{}{}{}{}",
         m_config->compiler,
-        objectFiles,
+        GetResponseFilePath(output),
+        GetTemporaryPath(output),
+        flags,
+        GetVariantFlags(),
+        libraryFlags,
+        extraFlags.empty() ? "" : " ",
+        extraFlags
+    );
+
+    return AddDiagnosticFlags(command);
+}
+
+std::string BuildEngine::GetSharedLibraryCommand(const std::string& library, const std::vector<std::string>& members, bool& membersChanged)
+{
+    membersChanged = WriteResponseFile(GetResponseFilePath(library), members);
+
+    // NOTE: Symbols the library doesn't define are left for the loader,
+    // so the libraries and the binary can refer to each other in any direction.
+    // The binary records the library by its soname, which the loader looks for next to the binary.
+    std::string command = fmt::format(
+        "{} -shared -Wl,-soname,{} @{} -o {} {}",
+        m_config->compiler,
+        fs::path(library).filename().string(),
+        GetResponseFilePath(library),
+        GetTemporaryPath(library),
+        m_flagManager->GetFlags()
+    );
+
+    return AddDiagnosticFlags(command);
+}
+
+std::string BuildEngine::GetTestCommand(const std::string& binary, std::size_t shard, std::size_t shards)
+{
+    // NOTE: The shell replaces itself with the binary, so a test that times out can be killed directly
+    if (shards <= 1)
+        return fmt::format("exec ./{}", binary);
+
+    return fmt::format("GTEST_SHARD_INDEX={} GTEST_TOTAL_SHARDS={} exec ./{}", shard, shards, binary);
+}
+
+std::string BuildEngine::GetArchiveCommand(const std::string& archive, const std::vector<std::string>& members, bool& membersChanged, bool isThin, bool isShared)
+{
+    const std::string responseFile = archive + ".rsp";
+    membersChanged = WriteResponseFile(responseFile, members);
+
+    // The archive is created again instead of updated, so removed objects don't stay in it
+    return fmt::format("rm -f {0} && ar qcs{2} {0} @{1}", GetTemporaryPath(archive, isShared), responseFile, isThin ? " --thin" : "");
+}
+
+std::string BuildEngine::GetCompileCommandForDependency(const DependencyConfig& dependency, const std::string& source, const std::string& output)
+{
+    std::string includePaths;
+
+    for (const auto& includeDir : dependency.include)
+        includePaths += " -I" + includeDir;
+
+    // NOTE: Vendored C sources (like sqlite) don't compile as C++, the C++ compiler is told they're C
+    const bool isC = fs::path(source).extension() == ".c";
+    const std::string language = isC ? "-x c" : (m_config->languageVersion != "" ? "-std=" + m_config->languageVersion : "");
+
+    std::string command = fmt::format(
+        "{} {} -c {} -o {}{} {}",
+        m_config->compiler,
+        language,
+        source,
         output,
-        flags
+        includePaths,
+        dependency.flags
+    );
+
+    return AddDiagnosticFlags(command);
+}
+
+std::string BuildEngine::GetCommandSignature(const std::string& command, const std::string& sourceExtension)
+{
+    const std::uint64_t hash = Hash::Fnv1a(GetToolchain(sourceExtension).GetFingerprint());
+
+    return Hash::ToHex(Hash::Fnv1a(GetSignedCommand(command), Hash::Fnv1a("\n", hash)));
+}
+
+std::string BuildEngine::GetCommandTemplate(const std::string& command, const std::string& source, const std::string& output, const std::string& depfile)
+{
+    std::string commandTemplate(GetSignedCommand(command));
+
+    // The longest paths are replaced first, the output is usually part of the depfile and the response file paths
+    std::vector<std::pair<std::string, std::string>> placeholders = { { source, "$in" }, { output, "$out" }, { depfile, "$depfile" } };
+
+    std::sort(placeholders.begin(), placeholders.end(), [](const auto& a, const auto& b) { return a.first.length() > b.first.length(); });
+
+    for (const auto& [path, placeholder] : placeholders)
+    {
+        if (path.empty()) continue;
+
+        for (std::size_t position = commandTemplate.find(path); position != std::string::npos; position = commandTemplate.find(path, position + placeholder.length()))
+            commandTemplate.replace(position, path.length(), placeholder);
+    }
+
+    return commandTemplate;
+}
+
+std::string BuildEngine::GetDepfilePath(const std::string& sourceExtension, const std::string& outputPath)
+{
+    if (sourceExtension != "cpp" && sourceExtension != "c")
+        return "";
+
+    if (!m_compiler->SupportsOption("-MMD", "-MMD -MF /dev/null"))
+        return "";
+
+    return fs::path(outputPath).replace_extension("d").string();
+}
+
+std::string BuildEngine::GetTemporaryPath(const std::string& output, bool isShared)
+{
+    if (isShared)
+        return fmt::format("{}.{}.tmp", output, getpid());
+
+    return output + ".tmp";
+}
+
+bool BuildEngine::UsesModules()
+{
+    return m_config->modules == ConfigConstants::TRUE && m_compiler->SupportsOption("-fmodules-ts");
+}
+
+const std::string& BuildEngine::GetModuleDirectory()
+{
+    if (!m_moduleDirectory.empty())
+        return m_moduleDirectory;
+
+    // The BMI depends on everything in the compile command except the source and the output
+    std::uint64_t hash = Hash::Fnv1a(m_compiler->GetFingerprint());
+    hash = Hash::Fnv1a(m_config->languageVersion, Hash::Fnv1a("\n", hash));
+    hash = Hash::Fnv1a(m_flagManager->GetIncludePaths(), Hash::Fnv1a("\n", hash));
+    hash = Hash::Fnv1a(m_flagManager->GetFlags() + GetVariantFlags(), Hash::Fnv1a("\n", hash));
+
+    // Interfaces matching an override are compiled with other flags, and importers read their BMIs
+    for (const auto& flagOverride : m_config->overrides)
+    {
+        for (const auto& pattern : flagOverride.match)
+            hash = Hash::Fnv1a(pattern, Hash::Fnv1a("\n", hash));
+
+        hash = Hash::Fnv1a(fmt::format("{}\n{}\n{}", flagOverride.optimization, flagOverride.flags, flagOverride.replaceFlags), Hash::Fnv1a("\n", hash));
+    }
+
+    m_moduleDirectory = fmt::format("{}/modules/{}", ConfigConstants::STATE_DIRECTORY, Hash::ToHex(hash));
+    return m_moduleDirectory;
+}
+
+std::string BuildEngine::GetModuleInterfacePath(const std::string& moduleName)
+{
+    std::string fileName = moduleName;
+
+    // Partitions ('math:detail') get a file of their own, next to their module
+    std::replace(fileName.begin(), fileName.end(), ':', '-');
+
+    return fmt::format("{}/{}.gcm", GetModuleDirectory(), fileName);
+}
+
+std::string BuildEngine::GetModuleMapperPath()
+{
+    return fmt::format("{}/mapper", GetModuleDirectory());
+}
+
+std::string BuildEngine::GetScanCommandForFile(const std::string& sourcePath, const std::string& outputPath, const std::string& scanOutput)
+{
+    if (!m_compiler->SupportsOption("-fdeps-format=p1689r5", "-fmodules-ts -fdeps-format=p1689r5 -fdeps-file=/dev/null -fdeps-target=/dev/null -MD -MF /dev/null"))
+        return "";
+
+    // NOTE: The source is only preprocessed, which is all the compiler needs to find its module declarations
+    return fmt::format(
+        "{} {}{} -E -x c++ {} -o /dev/null -MD -MF /dev/null -fmodules-ts -fdeps-format=p1689r5 -fdeps-file={} -fdeps-target={} {} {}",
+        m_config->compiler,
+        m_config->languageVersion != "" ? "-std=" : "",
+        m_config->languageVersion,
+        sourcePath,
+        scanOutput,
+        outputPath,
+        m_flagManager->GetIncludePaths(),
+        m_flagManager->GetFlags(sourcePath)
     );
+}
+
+void BuildEngine::SetVariant(const std::string& variant)
+{
+    if (variant == m_variant) return;
+
+    m_variant = variant;
+
+    // The variant's BMIs are built with its '-march', they go to a directory of their own
+    m_moduleDirectory.clear();
+}
+
+bool BuildEngine::SupportsVariant(const std::string& variant)
+{
+    return m_compiler->SupportsOption(fmt::format("-march={}", variant));
+}
+
+std::string BuildEngine::GetObjectDirectory()
+{
+    const std::string& objectDirectory = m_config->directories.at("obj")[0];
+    return m_variant.empty() ? objectDirectory : fmt::format("{}-{}", objectDirectory, m_variant);
+}
+
+std::string BuildEngine::GetLauncherCommand(const std::string& source, const std::string& output)
+{
+    // NOTE: The launcher has to run on every CPU, so none of the project's flags (or the variant's) are used
+    return fmt::format("{} -O2 -x c++ {} -o {}", m_config->compiler, source, GetTemporaryPath(output));
+}
+
+std::string BuildEngine::GetVariantFlags()
+{
+    return m_variant.empty() ? "" : fmt::format(" -march={}", m_variant);
+}
+
+std::string BuildEngine::GetResponseFilePath(const std::string& output)
+{
+    return fmt::format("{}/link/{}.rsp", ConfigConstants::STATE_DIRECTORY, fs::path(output).lexically_normal().generic_string());
+}
+
+bool BuildEngine::WriteResponseFile(const std::string& path, const std::vector<std::string>& arguments)
+{
+    std::string contents;
+
+    for (const auto& argument : arguments)
+    {
+        // Whitespace, quotes and backslashes are escaped with a backslash, which GCC, Clang and ar all understand
+        for (const char c : argument)
+        {
+            if (c == ' ' || c == '\t' || c == '\'' || c == '"' || c == '\\')
+                contents += '\\';
+
+            contents += c;
+        }
+
+        contents += '\n';
+    }
+
+    bool isWritten = false;
+
+    if (!FileSystem::WriteFileIfChanged(path, contents, &isWritten))
+        Logger::Fatal("Failed to write response file '{}'", path);
+
+    return isWritten;
+}
+
+std::string_view BuildEngine::GetSignedCommand(std::string_view command)
+{
+    // NOTE: Diagnostic flags only change how the output looks. Signing them would rebuild everything
+    // whenever kole switches between writing to a terminal and to a pipe.
+    const std::string diagnosticFlags = m_flagManager->GetDiagnosticFlags();
+
+    if (!diagnosticFlags.empty() && command.ends_with(" " + diagnosticFlags))
+        command.remove_suffix(diagnosticFlags.length() + 1);
 
     return command;
 }
 
+std::string BuildEngine::AddDiagnosticFlags(const std::string& command)
+{
+    const std::string diagnosticFlags = m_flagManager->GetDiagnosticFlags();
+
+    if (diagnosticFlags.empty())
+        return command;
+
+    return command + " " + diagnosticFlags;
+}
+
+const Toolchain& BuildEngine::GetToolchain(const std::string& sourceExtension)
+{
+    std::string tool;
+
+    if (sourceExtension == "h" || sourceExtension == "hpp")
+        tool = "moc";
+    else if (sourceExtension == "ui")
+        tool = "uic";
+    else
+        return *m_compiler;
+
+    if (!m_qtTools.contains(tool))
+        m_qtTools[tool] = std::make_unique<Toolchain>(tool, ToolKind::QtTool);
+
+    return *m_qtTools.at(tool);
+}
+
 std::string BuildEngine::GetCompileCommandForSourceFile(const std::string& source, const std::string& output)
 {
-    std::string flags = m_flagManager->GetFlags();
+    std::string flags = m_flagManager->GetFlags(source);
     std::string includePaths = m_flagManager->GetIncludePaths();
 
+    // The headers the compiler reads are written next to the object, so changing one rebuilds it
+    const std::string depfile = GetDepfilePath(fs::path(source).extension().string().substr(1), output);
+
+    // Every source can import modules, the mapper tells the compiler where their BMIs are (and where to write its own)
+    const std::string moduleFlags = UsesModules() ? fmt::format("-fmodules-ts -fmodule-mapper={} ", GetModuleMapperPath()) : "";
+
     std::string command = fmt::format(
-        "{} {}{} -c {} -o {} {} {}",
+        "{} {}{} -c {} -o {} {}{}{} {}{}",
         m_config->compiler,
         m_config->languageVersion != "" ? "-std=" : "",
         m_config->languageVersion,
         source,
-        output,
+        GetTemporaryPath(output),
+        depfile.empty() ? "" : fmt::format("-MMD -MF {} ", depfile),
+        moduleFlags,
         includePaths,
-        flags
+        flags,
+        GetVariantFlags()
     );
 
-    return command;
+    return AddDiagnosticFlags(command);
 }
 
 std::string BuildEngine::GetCompileCommandForHeaderFile(const std::string& source, const std::string& output)
@@ -120,7 +444,7 @@ std::string BuildEngine::GetCompileCommandForHeaderFile(const std::string& sourc
     std::string command = fmt::format(
         "moc {} -o {} >/dev/null 2>&1",
         source,
-        output
+        GetTemporaryPath(output)
     );
 
     // NOTE: The reason this specific flag is passed to the moc command
@@ -136,7 +460,7 @@ std::string BuildEngine::GetCompileCommandForUIFile(const std::string& source, c
     std::string command = fmt::format(
         "uic {} -o {}",
         source,
-        output
+        GetTemporaryPath(output)
     );
 
     return command;
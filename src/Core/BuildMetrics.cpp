@@ -0,0 +1,191 @@
+#include "Core/BuildMetrics.hpp"
+#include "Utils/Logger/Logger.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const std::map<BuildPhase, std::string> phaseNames = {
+        { BuildPhase::Config,  "config"  },
+        { BuildPhase::Scan,    "scan"    },
+        { BuildPhase::Codegen, "codegen" },
+        { BuildPhase::Compile, "compile" },
+        { BuildPhase::Link,    "link"    },
+        { BuildPhase::Test,    "test"    },
+    };
+
+    std::string EscapeJson(const std::string& text)
+    {
+        std::string escaped;
+        escaped.reserve(text.size() + 2);
+
+        escaped += '"';
+
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n";  break;
+            case '\r': escaped += "\\r";  break;
+            case '\t': escaped += "\\t";  break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                    escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+                else
+                    escaped += c;
+            }
+        }
+
+        escaped += '"';
+        return escaped;
+    }
+}
+
+std::uint64_t BuildMetrics::GetElapsed() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+}
+
+void BuildMetrics::AddPhaseTime(BuildPhase phase, std::uint64_t duration)
+{
+    m_phaseTimes[phase] += duration;
+}
+
+void BuildMetrics::AddCommand(CommandMetrics command)
+{
+    const std::uint64_t end = command.start + command.duration;
+
+    auto [it, inserted] = m_phaseSpans.try_emplace(command.phase, command.start, end);
+
+    if (!inserted)
+    {
+        it->second.first = std::min(it->second.first, command.start);
+        it->second.second = std::max(it->second.second, end);
+    }
+
+    m_commands.push_back(std::move(command));
+}
+
+void BuildMetrics::UpdateConcurrency(std::size_t runningCommands)
+{
+    m_peakConcurrency = std::max(m_peakConcurrency, runningCommands);
+}
+
+bool BuildMetrics::Write(const std::string& path)
+{
+    std::map<BuildPhase, std::uint64_t> phaseTimes = m_phaseTimes;
+
+    for (const auto& [phase, span] : m_phaseSpans)
+        phaseTimes[phase] += span.second - span.first;
+
+    std::size_t compiledUnits = 0;
+    std::size_t failedUnits = 0;
+
+    std::uint64_t userTime = 0;
+    std::uint64_t systemTime = 0;
+    std::uint64_t peakMemory = 0;
+
+    for (const CommandMetrics& command : m_commands)
+    {
+        userTime += command.userTime;
+        systemTime += command.systemTime;
+        peakMemory = std::max(peakMemory, command.peakMemory);
+
+        if (command.phase == BuildPhase::Link || command.phase == BuildPhase::Test) continue;
+
+        if (command.exitCode == 0)
+            compiledUnits++;
+        else
+            failedUnits++;
+    }
+
+    try
+    {
+        const fs::path metricsPath = path;
+
+        if (metricsPath.has_parent_path())
+            fs::create_directories(metricsPath.parent_path());
+
+        std::ofstream file(metricsPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::Error("Failed to open '{}' for writing the build metrics", path);
+            return false;
+        }
+
+        file << "{\n";
+        file << fmt::format("  \"version\": {},\n", m_version);
+        file << fmt::format("  \"success\": {},\n", m_success);
+        file << fmt::format("  \"duration_ms\": {},\n", GetElapsed());
+
+        file << "  \"phases_ms\": {\n";
+
+        for (auto it = phaseNames.begin(); it != phaseNames.end(); ++it)
+        {
+            const std::uint64_t time = phaseTimes.contains(it->first) ? phaseTimes.at(it->first) : 0;
+            file << fmt::format("    \"{}\": {}{}\n", it->second, time, std::next(it) != phaseNames.end() ? "," : "");
+        }
+
+        file << "  },\n";
+
+        file << "  \"units\": {\n";
+        file << fmt::format("    \"compiled\": {},\n", compiledUnits);
+        file << fmt::format("    \"skipped\": {},\n", m_skippedUnits);
+        file << fmt::format("    \"cached\": {},\n", m_cachedUnits);
+        file << fmt::format("    \"failed\": {}\n", failedUnits);
+        file << "  },\n";
+
+        file << fmt::format("  \"peak_concurrency\": {},\n", m_peakConcurrency);
+
+        file << "  \"processes\": {\n";
+        file << fmt::format("    \"spawned\": {},\n", m_commands.size());
+        file << fmt::format("    \"user_cpu_ms\": {},\n", userTime / 1000);
+        file << fmt::format("    \"system_cpu_ms\": {},\n", systemTime / 1000);
+        file << fmt::format("    \"peak_memory\": {}\n", peakMemory);
+        file << "  },\n";
+
+        file << "  \"commands\": [";
+
+        for (std::size_t i = 0; i < m_commands.size(); i++)
+        {
+            const CommandMetrics& command = m_commands[i];
+
+            file << (i > 0 ? ",\n" : "\n");
+            file << "    {";
+            file << fmt::format(" \"phase\": \"{}\",", phaseNames.at(command.phase));
+            file << fmt::format(" \"source\": {},", EscapeJson(command.source));
+            file << fmt::format(" \"output\": {},", EscapeJson(command.output));
+            file << fmt::format(" \"command\": {},", EscapeJson(command.command));
+            file << fmt::format(" \"start_ms\": {},", command.start);
+            file << fmt::format(" \"duration_ms\": {},", command.duration);
+            file << fmt::format(" \"exit_code\": {},", command.exitCode);
+            file << fmt::format(" \"peak_memory\": {},", command.peakMemory);
+            file << fmt::format(" \"user_cpu_ms\": {},", command.userTime / 1000);
+            file << fmt::format(" \"system_cpu_ms\": {},", command.systemTime / 1000);
+            file << fmt::format(" \"block_input\": {},", command.blockInputs);
+            file << fmt::format(" \"block_output\": {},", command.blockOutputs);
+            file << fmt::format(" \"voluntary_switches\": {},", command.voluntarySwitches);
+            file << fmt::format(" \"involuntary_switches\": {}", command.involuntarySwitches);
+            file << " }";
+        }
+
+        file << (m_commands.empty() ? "]\n" : "\n  ]\n");
+        file << "}\n";
+    }
+    catch (const std::exception& e)
+    {
+        Logger::Error("Failed to write the build metrics: {}", e.what());
+        return false;
+    }
+
+    Logger::Debug("Wrote build metrics to '{}'", path);
+    m_isWritten = true;
+
+    return true;
+}
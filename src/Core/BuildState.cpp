@@ -0,0 +1,405 @@
+#include "Core/BuildState.hpp"
+#include "Utils/Hash.hpp"
+#include "Utils/Logger/Logger.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <sstream>
+#include <filesystem>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+// NOTE: The state is a plain text file with one output per line:
+// <output> TAB <key>=<value> TAB <key>=<value> ...
+// It's read and written once per build, so it has to stay cheap for large projects.
+// The commands the outputs were built with are in a file next to it, one per line:
+// <key> TAB <command>
+// Until the state is saved, every change is appended to a journal next to it, one per line:
+// record TAB <output line of the state>, or command TAB <line of the commands>
+
+namespace
+{
+    bool ParseRecord(const std::string& line, std::string& output, BuildRecord& record)
+    {
+        std::istringstream stream(line);
+
+        if (!std::getline(stream, output, '\t') || output.empty())
+            return false;
+
+        std::string field;
+
+        while (std::getline(stream, field, '\t'))
+        {
+            const std::size_t separator = field.find('=');
+            if (separator == std::string::npos) continue;
+
+            const std::string key = field.substr(0, separator);
+            const std::string value = field.substr(separator + 1);
+
+            try
+            {
+                if (key == "duration")
+                    record.duration = std::stoull(value);
+                else if (key == "peak_memory")
+                    record.peakMemory = std::stoull(value);
+                else if (key == "user_time")
+                    record.userTime = std::stoull(value);
+                else if (key == "system_time")
+                    record.systemTime = std::stoull(value);
+                else if (key == "block_input")
+                    record.blockInputs = std::stoull(value);
+                else if (key == "block_output")
+                    record.blockOutputs = std::stoull(value);
+                else if (key == "voluntary_switches")
+                    record.voluntarySwitches = std::stoull(value);
+                else if (key == "involuntary_switches")
+                    record.involuntarySwitches = std::stoull(value);
+                else if (key == "signature")
+                    record.signature = value;
+                else if (key == "failed")
+                    record.failed = value == "1";
+                else if (key == "command")
+                    record.command = value;
+                else if (key == "source_hash")
+                    record.sourceHash = value;
+                else if (key == "placed_time")
+                    record.placedTime = std::stoll(value);
+            }
+            catch (const std::exception&)
+            {
+                Logger::Debug("Invalid value '{}' for '{}' in the build state", value, key);
+            }
+        }
+
+        return true;
+    }
+
+    std::string FormatRecord(const std::string& output, const BuildRecord& record)
+    {
+        std::ostringstream line;
+
+        line << output;
+        line << "\tduration=" << record.duration;
+        line << "\tpeak_memory=" << record.peakMemory;
+
+        // Outputs that were only fetched from the cache (or trusted) have no usage of their own
+        if (record.userTime != 0 || record.systemTime != 0)
+        {
+            line << "\tuser_time=" << record.userTime;
+            line << "\tsystem_time=" << record.systemTime;
+            line << "\tblock_input=" << record.blockInputs;
+            line << "\tblock_output=" << record.blockOutputs;
+            line << "\tvoluntary_switches=" << record.voluntarySwitches;
+            line << "\tinvoluntary_switches=" << record.involuntarySwitches;
+        }
+
+        if (!record.signature.empty())
+            line << "\tsignature=" << record.signature;
+
+        if (record.failed)
+            line << "\tfailed=1";
+
+        if (!record.command.empty())
+            line << "\tcommand=" << record.command;
+
+        if (!record.sourceHash.empty())
+            line << "\tsource_hash=" << record.sourceHash;
+
+        if (record.placedTime != 0)
+            line << "\tplaced_time=" << record.placedTime;
+
+        return line.str();
+    }
+}
+
+void BuildState::Load()
+{
+    m_records.clear();
+    m_commands.clear();
+
+    std::ifstream file(m_statePath);
+    std::string line;
+
+    if (!file.is_open())
+        Logger::Debug("No build state found at '{}'", m_statePath);
+    else if (!std::getline(file, line) || line != fmt::format("kole-state {}", m_version))
+        Logger::Debug("Build state is from a different version of kole. Ignoring...");
+    else
+    {
+        while (std::getline(file, line))
+        {
+            std::string output;
+            BuildRecord record;
+
+            if (ParseRecord(line, output, record))
+                m_records[output] = record;
+        }
+
+        Logger::Debug("Loaded {} record(s) from the build state", m_records.size());
+
+        this->LoadCommands();
+    }
+
+    // A build that was killed before it saved the state left what it did in the journal
+    this->ReplayJournal();
+}
+
+void BuildState::Save()
+{
+    try
+    {
+        const fs::path statePath = m_statePath;
+        fs::create_directories(statePath.parent_path());
+
+        // Write to a temporary file first, so an interrupted save doesn't lose the old state
+        const fs::path temporaryPath = statePath.string() + ".tmp";
+
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::Warning("Failed to open '{}' for writing the build state", temporaryPath.string());
+            return;
+        }
+
+        file << fmt::format("kole-state {}\n", m_version);
+
+        for (const auto& [output, record] : m_records)
+            file << FormatRecord(output, record) << '\n';
+
+        file.close();
+        fs::rename(temporaryPath, statePath);
+    }
+    catch (const std::exception& e)
+    {
+        Logger::Warning("Failed to save the build state: {}", e.what());
+        return;
+    }
+
+    if (!this->SaveCommands()) return;
+
+    // Everything in the journal is part of the state now
+    m_journal.close();
+
+    std::error_code error;
+    fs::remove(this->GetJournalPath(), error);
+}
+
+void BuildState::LoadCommands()
+{
+    m_commands.clear();
+
+    std::ifstream file(fs::path(m_statePath).parent_path() / "commands");
+    if (!file.is_open()) return;
+
+    std::string line;
+    std::getline(file, line);
+
+    if (line != fmt::format("kole-commands {}", m_version))
+        return;
+
+    while (std::getline(file, line))
+    {
+        const std::size_t separator = line.find('\t');
+        if (separator == std::string::npos) continue;
+
+        m_commands[line.substr(0, separator)] = line.substr(separator + 1);
+    }
+}
+
+bool BuildState::SaveCommands()
+{
+    try
+    {
+        const fs::path commandsPath = fs::path(m_statePath).parent_path() / "commands";
+        const fs::path temporaryPath = commandsPath.string() + ".tmp";
+
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::Warning("Failed to open '{}' for writing the build commands", temporaryPath.string());
+            return false;
+        }
+
+        file << fmt::format("kole-commands {}\n", m_version);
+
+        // Commands no output was built with anymore are dropped
+        std::unordered_set<std::string> keys;
+
+        for (const auto& [output, record] : m_records)
+        {
+            if (record.command.empty() || !m_commands.contains(record.command) || !keys.insert(record.command).second)
+                continue;
+
+            file << record.command << '\t' << m_commands.at(record.command) << '\n';
+        }
+
+        file.close();
+        fs::rename(temporaryPath, commandsPath);
+    }
+    catch (const std::exception& e)
+    {
+        Logger::Warning("Failed to save the build commands: {}", e.what());
+        return false;
+    }
+
+    return true;
+}
+
+std::string BuildState::GetJournalPath() const
+{
+    return m_statePath + ".journal";
+}
+
+void BuildState::ReplayJournal()
+{
+    std::ifstream file(this->GetJournalPath());
+    if (!file.is_open()) return;
+
+    std::string line;
+
+    if (!std::getline(file, line) || line != fmt::format("kole-journal {}", m_version))
+    {
+        Logger::Debug("Build journal is from a different version of kole. Ignoring...");
+        return;
+    }
+
+    std::size_t count = 0;
+
+    while (std::getline(file, line))
+    {
+        // The last line is cut short if the build was killed while writing it
+        if (file.eof()) break;
+
+        const std::size_t separator = line.find('\t');
+        if (separator == std::string::npos) continue;
+
+        const std::string kind = line.substr(0, separator);
+        const std::string entry = line.substr(separator + 1);
+
+        if (kind == "record")
+        {
+            std::string output;
+            BuildRecord record;
+
+            if (ParseRecord(entry, output, record))
+                m_records[output] = record;
+        }
+        else if (kind == "command")
+        {
+            const std::size_t keySeparator = entry.find('\t');
+            if (keySeparator == std::string::npos) continue;
+
+            m_commands[entry.substr(0, keySeparator)] = entry.substr(keySeparator + 1);
+        }
+
+        count++;
+    }
+
+    Logger::Debug("Replayed {} change(s) from the journal of an interrupted build", count);
+}
+
+void BuildState::AppendJournal(const std::string& kind, const std::string& entry)
+{
+    if (!m_journal.is_open())
+    {
+        const fs::path journalPath = this->GetJournalPath();
+
+        std::error_code error;
+        fs::create_directories(journalPath.parent_path(), error);
+
+        // NOTE: The journal of an interrupted build is kept (and added to), it was already replayed by Load
+        const bool isNew = !fs::exists(journalPath, error);
+
+        m_journal.open(journalPath, std::ios::app);
+
+        if (!m_journal.is_open())
+        {
+            Logger::Debug("Failed to open the build journal '{}'", journalPath.string());
+            return;
+        }
+
+        if (isNew)
+            m_journal << fmt::format("kole-journal {}\n", m_version);
+    }
+
+    // Flushed right away, the journal is only useful if it survives kole being killed
+    m_journal << kind << '\t' << entry << '\n';
+    m_journal.flush();
+}
+
+const BuildRecord* BuildState::GetRecord(const std::string& output) const
+{
+    auto it = m_records.find(output);
+
+    if (it == m_records.end())
+        return nullptr;
+
+    return &it->second;
+}
+
+void BuildState::SetRecord(const std::string& output, const BuildRecord& record)
+{
+    m_records[output] = record;
+
+    this->AppendJournal("record", FormatRecord(output, record));
+}
+
+std::uint64_t BuildState::GetAveragePeakMemory() const
+{
+    std::uint64_t total = 0;
+    std::uint64_t count = 0;
+
+    for (const auto& [output, record] : m_records)
+    {
+        if (record.peakMemory == 0) continue;
+
+        total += record.peakMemory;
+        count++;
+    }
+
+    return count > 0 ? total / count : 0;
+}
+
+std::uint64_t BuildState::GetAverageDuration() const
+{
+    std::uint64_t total = 0;
+    std::uint64_t count = 0;
+
+    for (const auto& [output, record] : m_records)
+    {
+        if (record.duration == 0) continue;
+
+        total += record.duration;
+        count++;
+    }
+
+    return count > 0 ? total / count : 0;
+}
+
+std::string BuildState::AddCommand(const std::string& command)
+{
+    // Line breaks would end the command's line in the file
+    std::string storedCommand = command;
+    std::replace(storedCommand.begin(), storedCommand.end(), '\n', ' ');
+
+    const std::string key = Hash::ToHex(Hash::Fnv1a(storedCommand));
+
+    // Only new commands are journaled, most outputs share one that was saved before
+    if (!m_commands.contains(key))
+        this->AppendJournal("command", key + '\t' + storedCommand);
+
+    m_commands[key] = std::move(storedCommand);
+
+    return key;
+}
+
+const std::string* BuildState::GetCommand(const std::string& key) const
+{
+    auto it = m_commands.find(key);
+
+    if (it == m_commands.end())
+        return nullptr;
+
+    return &it->second;
+}
@@ -0,0 +1,130 @@
+#include "Core/CacheBackend.hpp"
+#include "Utils/HttpClient.hpp"
+#include "Utils/Logger/Logger.hpp"
+
+#include <thread>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+#include <filesystem>
+#include <functional>
+
+namespace fs = std::filesystem;
+
+std::unique_ptr<CacheBackend> CacheBackend::Create(const std::string& location)
+{
+    if (location.rfind("http://", 0) == 0)
+        return std::make_unique<HttpCacheBackend>(location);
+
+    if (location.find("://") != std::string::npos)
+    {
+        Logger::Warning("Cache location '{}' isn't supported, only directories and 'http://' URLs are", location);
+        return nullptr;
+    }
+
+    return std::make_unique<DirectoryCacheBackend>(location);
+}
+
+bool DirectoryCacheBackend::Get(const std::string& key, std::string& data)
+{
+    std::ifstream file(fs::path(m_directory) / key, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    return !file.bad();
+}
+
+bool DirectoryCacheBackend::Put(const std::string& key, const std::string& data)
+{
+    const fs::path path = fs::path(m_directory) / key;
+
+    // NOTE: Other machines write the same entries at the same time, so every writer gets its own temporary file.
+    // The rename replaces the entry in one step, even on most network filesystems.
+    const std::size_t threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+    const fs::path temporaryPath = fmt::format("{}.{}.{:x}.tmp", path.string(), getpid(), threadId);
+
+    std::error_code error;
+    fs::create_directories(path.parent_path(), error);
+
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    file.write(data.data(), data.size());
+    file.close();
+
+    if (!file)
+    {
+        fs::remove(temporaryPath, error);
+        return false;
+    }
+
+    fs::rename(temporaryPath, path, error);
+
+    if (error)
+    {
+        fs::remove(temporaryPath, error);
+        return false;
+    }
+
+    return true;
+}
+
+HttpCacheBackend::HttpCacheBackend(std::string url) : m_url(url)
+{
+    while (m_url.ends_with('/'))
+        m_url.pop_back();
+}
+
+bool HttpCacheBackend::Get(const std::string& key, std::string& data)
+{
+    if (m_isDisabled) return false;
+
+    HttpClient::Response response;
+
+    if (!HttpClient::Request("GET", fmt::format("{}/{}", m_url, key), "", response))
+    {
+        Disable();
+        return false;
+    }
+
+    if (response.status != 200)
+    {
+        if (response.status != 404)
+            Logger::Debug("Cache server answered GET '{}' with {}", key, response.status);
+
+        return false;
+    }
+
+    data = std::move(response.body);
+    return true;
+}
+
+bool HttpCacheBackend::Put(const std::string& key, const std::string& data)
+{
+    if (m_isDisabled) return false;
+
+    HttpClient::Response response;
+
+    if (!HttpClient::Request("PUT", fmt::format("{}/{}", m_url, key), data, response))
+    {
+        Disable();
+        return false;
+    }
+
+    if (response.status < 200 || response.status >= 300)
+    {
+        Logger::Debug("Cache server answered PUT '{}' with {}", key, response.status);
+        return false;
+    }
+
+    return true;
+}
+
+void HttpCacheBackend::Disable()
+{
+    // Only the first failing request warns, the ones running next to it fail the same way
+    if (m_isDisabled.exchange(true)) return;
+
+    Logger::Warning("Cache server '{}' can't be reached, it won't be used for the rest of the build", m_url);
+}
@@ -0,0 +1,255 @@
+#include "Core/Commands.hpp"
+#include "Core/BuildState.hpp"
+#include "Core/IncludeGraph.hpp"
+#include "Core/LocalCache.hpp"
+#include "Utils/Logger/Logger.hpp"
+#include "Utils/SystemResources.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+
+namespace
+{
+    double GetPercentage(std::uint64_t part, std::uint64_t total)
+    {
+        return total != 0 ? part * 100.0 / total : 0.0;
+    }
+
+    int PrintCacheStats(std::shared_ptr<BuildConfig> config)
+    {
+        std::unique_ptr<LocalCache> cache = LocalCache::Create(config);
+
+        if (cache == nullptr)
+        {
+            Logger::Error("The project doesn't use a local cache, set 'local' in the 'cache' section of the config");
+            return 1;
+        }
+
+        const std::string& directory = cache->GetDescription();
+        const std::uint64_t maxSize = SystemResources::ParseMemorySize(config->cache.at("max_size"));
+
+        const LocalCacheStats stats = cache->GetStats();
+
+        const std::uint64_t hits = stats.localHits + stats.remoteHits;
+        const std::uint64_t savedSize = stats.originalSize > stats.size ? stats.originalSize - stats.size : 0;
+
+        std::string text;
+
+        text += fmt::format("Cache directory:    {}\n", directory);
+        text += fmt::format("Entries:            {}\n", stats.entries);
+
+        if (maxSize != 0)
+            text += fmt::format("Size:               {} of {} ({:.1f}%)\n", SystemResources::FormatMemorySize(stats.size), SystemResources::FormatMemorySize(maxSize), GetPercentage(stats.size, maxSize));
+        else
+            text += fmt::format("Size:               {}\n", SystemResources::FormatMemorySize(stats.size));
+
+        text += fmt::format("Uncompressed size:  {}\n", SystemResources::FormatMemorySize(stats.originalSize));
+        text += fmt::format("Saved by zstd:      {} ({:.1f}%)\n", SystemResources::FormatMemorySize(savedSize), GetPercentage(savedSize, stats.originalSize));
+        text += fmt::format("Lookups:            {}\n", stats.lookups);
+        text += fmt::format("Hits:               {} ({:.1f}%), {} local, {} remote\n", hits, GetPercentage(hits, stats.lookups), stats.localHits, stats.remoteHits);
+        text += fmt::format("Misses:             {}\n", stats.lookups - std::min(hits, stats.lookups));
+        text += fmt::format("Evicted:            {} entries ({})\n", stats.evictedEntries, SystemResources::FormatMemorySize(stats.evictedSize));
+
+        Logger::Output(text);
+        return 0;
+    }
+
+    int PrintResourceStats(std::shared_ptr<ArgumentManager> arguments)
+    {
+        // Blocks in rusage are always 512 bytes, whatever the block size of the disk is
+        constexpr std::uint64_t blockSize = 512;
+        constexpr std::size_t maxRows = 20;
+
+        const std::map<std::string, std::function<std::uint64_t(const BuildRecord&)>> sortKeys = {
+            { "cpu", [](const BuildRecord& record) { return record.userTime + record.systemTime; } },
+            { "rss", [](const BuildRecord& record) { return record.peakMemory; } },
+            { "io",  [](const BuildRecord& record) { return (record.blockInputs + record.blockOutputs) * blockSize; } },
+        };
+
+        const std::string top = arguments->GetArgumentState(Argument::Top) ? arguments->GetArgumentValue(Argument::Top) : "cpu";
+
+        if (!sortKeys.contains(top))
+        {
+            Logger::Error("Can't sort by '{}', use 'cpu', 'rss' or 'io'", top);
+            return 1;
+        }
+
+        BuildState buildState(fmt::format("{}/state", ConfigConstants::STATE_DIRECTORY));
+        buildState.Load();
+
+        // Only outputs whose command ran have a usage, ones fetched from the cache (or built by older versions) don't
+        std::vector<std::pair<std::string, const BuildRecord*>> records;
+
+        for (const auto& [output, record] : buildState.GetRecords())
+        {
+            if (record.userTime != 0 || record.systemTime != 0)
+                records.emplace_back(output, &record);
+        }
+
+        if (records.empty())
+        {
+            Logger::Info("No resource usage was recorded yet, build the project first");
+            return 0;
+        }
+
+        const auto& GetKey = sortKeys.at(top);
+
+        std::sort(records.begin(), records.end(), [&](const auto& a, const auto& b)
+        {
+            const std::uint64_t keyA = GetKey(*a.second);
+            const std::uint64_t keyB = GetKey(*b.second);
+
+            return keyA != keyB ? keyA > keyB : a.first < b.first;
+        });
+
+        std::uint64_t totalCpu = 0;
+
+        for (const auto& [output, record] : records)
+            totalCpu += record->userTime + record->systemTime;
+
+        std::string text = fmt::format("{:>10}  {:>10}  {:>10}  {:>10}  {:>10}  {:>12}  {}\n", "User", "System", "Peak RSS", "Read", "Written", "Switches", "Output");
+
+        for (std::size_t i = 0; i < records.size() && i < maxRows; i++)
+        {
+            const auto& [output, record] = records[i];
+
+            text += fmt::format(
+                "{:>9.2f}s  {:>9.2f}s  {:>10}  {:>10}  {:>10}  {:>5}/{:<6}  {}\n",
+                record->userTime / 1000000.0,
+                record->systemTime / 1000000.0,
+                SystemResources::FormatMemorySize(record->peakMemory),
+                SystemResources::FormatMemorySize(record->blockInputs * blockSize),
+                SystemResources::FormatMemorySize(record->blockOutputs * blockSize),
+                record->voluntarySwitches,
+                record->involuntarySwitches,
+                output
+            );
+        }
+
+        text += fmt::format("\n{} of {} recorded command(s), {:.2f}s of CPU time in total\n", std::min(records.size(), maxRows), records.size(), totalCpu / 1000000.0);
+        text += "Switches are voluntary (waiting, e.g. for I/O) / involuntary (preempted)\n";
+
+        Logger::Output(text);
+        return 0;
+    }
+
+    std::string FormatDuration(std::uint64_t duration)
+    {
+        return fmt::format("{:.2f}s", duration / 1000.0);
+    }
+
+    int PrintQuery(std::shared_ptr<BuildConfig> config, std::shared_ptr<ArgumentManager> arguments)
+    {
+        constexpr std::size_t maxRows = 20;
+
+        const bool isRdeps = arguments->GetArgumentState(Argument::Rdeps);
+        const bool isIncludes = arguments->GetArgumentState(Argument::Includes);
+        const bool isHeaders = arguments->GetArgumentState(Argument::Headers);
+
+        if (isRdeps + isIncludes + isHeaders != 1)
+        {
+            Logger::Error("Pass one of --rdeps FILE, --includes FILE or --headers to 'kole query'");
+            return 1;
+        }
+
+        BuildState buildState(fmt::format("{}/state", ConfigConstants::STATE_DIRECTORY));
+        buildState.Load();
+
+        // Tests are compiled outside of the object directory (see FileCompiler::QueueTests)
+        IncludeGraph graph;
+        graph.Load({ config->directories.at("obj")[0], fmt::format("{}/tests", ConfigConstants::STATE_DIRECTORY) }, buildState);
+
+        if (graph.GetUnits().empty())
+        {
+            Logger::Info("No dependency files were found, build the project first");
+            return 0;
+        }
+
+        std::string text;
+
+        if (isRdeps)
+        {
+            const std::string header = arguments->GetArgumentValue(Argument::Rdeps);
+
+            if (!std::filesystem::exists(header))
+                Logger::Warning("'{}' doesn't exist", header);
+
+            const std::vector<const TranslationUnit*> units = graph.GetDependents(header);
+
+            if (units.empty())
+            {
+                Logger::Info("No object includes '{}'", header);
+                return 0;
+            }
+
+            std::uint64_t totalDuration = 0;
+
+            text += fmt::format("{:>10}  {}\n", "Compile", "Object");
+
+            for (const TranslationUnit* unit : units)
+            {
+                text += fmt::format("{:>10}  {}\n", unit->duration != 0 ? FormatDuration(unit->duration) : "-", unit->object);
+                totalDuration += unit->duration;
+            }
+
+            text += fmt::format("\n{} of {} object(s) include '{}', {} of compiling in total\n", units.size(), graph.GetUnits().size(), header, FormatDuration(totalDuration));
+        }
+        else if (isIncludes)
+        {
+            const std::string path = arguments->GetArgumentValue(Argument::Includes);
+            const TranslationUnit* unit = graph.FindUnit(path);
+
+            if (unit == nullptr)
+            {
+                Logger::Error("No dependency file lists '{}', pass a source or an object that was built", path);
+                return 1;
+            }
+
+            for (const auto& header : unit->headers)
+                text += header + "\n";
+
+            text += fmt::format("\n'{}' ({}) includes {} header(s)\n", unit->source, unit->object, unit->headers.size());
+        }
+        else
+        {
+            const std::vector<HeaderUsage> usages = graph.GetHeaderUsages();
+
+            text += fmt::format("{:>10}  {:>6}  {:>10}  {}\n", "Cost", "Units", "Average", "Header");
+
+            for (std::size_t i = 0; i < usages.size() && i < maxRows; i++)
+            {
+                const HeaderUsage& usage = usages[i];
+
+                text += fmt::format(
+                    "{:>10}  {:>6}  {:>10}  {}\n",
+                    FormatDuration(usage.cost),
+                    usage.units.size(),
+                    FormatDuration(usage.cost / usage.units.size()),
+                    usage.header
+                );
+            }
+
+            text += fmt::format("\n{} of {} header(s) included by the {} object(s)\n", std::min(usages.size(), maxRows), usages.size(), graph.GetUnits().size());
+            text += "Cost is the number of units times their average compile time, what changing the header costs\n";
+        }
+
+        Logger::Output(text);
+        return 0;
+    }
+}
+
+int Commands::Run(const std::string& command, std::shared_ptr<BuildConfig> config, std::shared_ptr<ArgumentManager> arguments)
+{
+    if (command == "cache stats")
+        return PrintCacheStats(config);
+
+    if (command == "stats")
+        return PrintResourceStats(arguments);
+
+    if (command == "query")
+        return PrintQuery(config, arguments);
+
+    Logger::Error("Command '{}' isn't implemented", command);
+    return 1;
+}
@@ -1,6 +1,11 @@
 #include "Core/ConfigReader.hpp"
+#include "Core/LocalCache.hpp"
+#include "Utils/Compression.hpp"
 #include "Utils/Logger/Logger.hpp"
+#include "Utils/SystemResources.hpp"
+#include "Utils/VariantLauncher.hpp"
 
+#include <cctype>
 #include <fstream>
 #include <algorithm>
 #include <filesystem>
@@ -20,7 +25,7 @@ void ConfigReader::CreateConfig()
         std::ofstream configFile(m_configPath);
         if (!configFile.is_open())
         {
-            Logger::Error(fmt::format("Failed to open config file at '{}'", m_configPath));
+            Logger::Error("Failed to open config file at '{}'", m_configPath);
             return;
         }
 
@@ -28,11 +33,11 @@ void ConfigReader::CreateConfig()
         // configFile << m_defaultConfig;
         configFile.close();
 
-        Logger::Info(fmt::format("Successfully created config file at '{}'", m_configPath));
+        Logger::Info("Successfully created config file at '{}'", m_configPath);
     }
     catch (const std::exception& e)
     {
-        Logger::Error(fmt::format("Error creating config file: {}", e.what()));
+        Logger::Error("Error creating config file: {}", e.what());
     }
 }
 
@@ -57,7 +62,7 @@ void ConfigReader::ReadConfig()
 
             if (std::find(m_recognizedKeys.begin(), m_recognizedKeys.end(), key) == m_recognizedKeys.end())
             {
-                Logger::Warning(fmt::format("Property '{}' was not recognized in the configuration. Ignoring...", key));
+                Logger::Warning("Property '{}' was not recognized in the configuration. Ignoring...", key);
             }
         }
 
@@ -92,7 +97,7 @@ void ConfigReader::ReadConfig()
                 // If a directory isn't recognized in the config property, ignore it and warn the user
                 if (!m_buildConfig->directories.contains(key))
                 {
-                    Logger::Warning(fmt::format("Directory '{}' was not recognized. Ignoring...", key));
+                    Logger::Warning("Directory '{}' was not recognized. Ignoring...", key);
                     continue;
                 }
 
@@ -142,7 +147,7 @@ void ConfigReader::ReadConfig()
 
                 if (!m_buildConfig->flags.contains(key))
                 {
-                    Logger::Warning(fmt::format("Flag '{}' was not recognized. Ignoring...", key));
+                    Logger::Warning("Flag '{}' was not recognized. Ignoring...", key);
                     continue;
                 }
 
@@ -161,7 +166,7 @@ void ConfigReader::ReadConfig()
 
                 if (!m_buildConfig->qtSupport.contains(key))
                 {
-                    Logger::Warning(fmt::format("QT Support property '{}' was not recognized. Ignoring...", key));
+                    Logger::Warning("QT Support property '{}' was not recognized. Ignoring...", key);
                     continue;
                 }
 
@@ -169,6 +174,162 @@ void ConfigReader::ReadConfig()
             }
         }
 
+        if (config["scheduler"])
+        {
+            const auto& scheduler = config["scheduler"];
+
+            for (const auto& property : scheduler)
+            {
+                std::string key = property.first.as<std::string>();
+                std::string value = property.second.as<std::string>();
+
+                if (!m_buildConfig->scheduler.contains(key))
+                {
+                    Logger::Warning("Scheduler property '{}' was not recognized. Ignoring...", key);
+                    continue;
+                }
+
+                m_buildConfig->scheduler[key] = ProcessProperty(value);
+            }
+        }
+
+        if (config["cache"])
+        {
+            const auto& cache = config["cache"];
+
+            for (const auto& property : cache)
+            {
+                std::string key = property.first.as<std::string>();
+                std::string value = property.second.as<std::string>();
+
+                if (!m_buildConfig->cache.contains(key))
+                {
+                    Logger::Warning("Cache property '{}' was not recognized. Ignoring...", key);
+                    continue;
+                }
+
+                m_buildConfig->cache[key] = ProcessProperty(value);
+            }
+        }
+
+        if (config["link"])
+        {
+            const auto& link = config["link"];
+
+            for (const auto& property : link)
+            {
+                std::string key = property.first.as<std::string>();
+                std::string value = property.second.as<std::string>();
+
+                if (!m_buildConfig->link.contains(key))
+                {
+                    Logger::Warning("Link property '{}' was not recognized. Ignoring...", key);
+                    continue;
+                }
+
+                m_buildConfig->link[key] = ProcessProperty(value);
+            }
+        }
+
+        if (config["tests"])
+        {
+            const auto& tests = config["tests"];
+
+            for (const auto& property : tests)
+            {
+                std::string key = property.first.as<std::string>();
+                std::string value = property.second.as<std::string>();
+
+                if (!m_buildConfig->tests.contains(key))
+                {
+                    Logger::Warning("Tests property '{}' was not recognized. Ignoring...", key);
+                    continue;
+                }
+
+                m_buildConfig->tests[key] = ProcessProperty(value);
+            }
+        }
+
+        if (config["dependencies"])
+        {
+            const auto& dependencies = config["dependencies"];
+
+            // Paths keep their case, unlike the lists ProcessProperty is given
+            auto ReadPaths = [&](const YAML::Node& node)
+            {
+                const std::vector<std::string> values = node.IsSequence() ? node.as<std::vector<std::string>>() : std::vector<std::string>{ node.as<std::string>() };
+                std::vector<std::string> paths;
+
+                for (const auto& value : values)
+                {
+                    const std::string path = ProcessProperty(value);
+
+                    if (!path.empty())
+                        paths.push_back(path);
+                }
+
+                return paths;
+            };
+
+            for (const auto& entry : dependencies)
+            {
+                const std::string name = entry.first.as<std::string>();
+                DependencyConfig dependency;
+
+                for (const auto& property : entry.second)
+                {
+                    std::string key = property.first.as<std::string>();
+
+                    if (key == "path")
+                        dependency.path = ProcessProperty(property.second.as<std::string>());
+                    else if (key == "sources")
+                        dependency.sources = ReadPaths(property.second);
+                    else if (key == "include")
+                        dependency.include = ReadPaths(property.second);
+                    else if (key == "flags")
+                        dependency.flags = ProcessProperty(property.second.as<std::string>());
+                    else
+                        Logger::Warning("Property '{}' of dependency '{}' was not recognized. Ignoring...", key, name);
+                }
+
+                m_buildConfig->dependencies[name] = dependency;
+            }
+        }
+
+        if (config["overrides"])
+        {
+            for (const auto& entry : config["overrides"])
+            {
+                FlagOverride flagOverride;
+
+                for (const auto& property : entry)
+                {
+                    std::string key = property.first.as<std::string>();
+
+                    // NOTE: Patterns keep their case like the ones in 'exclude', they are matched ignoring it anyway
+                    if (key == "match")
+                    {
+                        const auto& match = property.second;
+                        const std::vector<std::string> patterns = match.IsSequence() ? match.as<std::vector<std::string>>() : std::vector<std::string>{ match.as<std::string>() };
+
+                        for (const auto& pattern : patterns)
+                            flagOverride.match.push_back(ProcessProperty(pattern));
+                    }
+                    // Not processed, 'none' is a level here ('-O0') rather than no value
+                    else if (key == "optimization")
+                        flagOverride.optimization = property.second.as<std::string>();
+                    else if (key == "flags")
+                        flagOverride.flags = ProcessProperty(property.second.as<std::string>());
+                    else if (key == "replace_flags")
+                        flagOverride.replaceFlags = ProcessProperty(property.second.as<std::string>()) == ConfigConstants::TRUE;
+                    else
+                        Logger::Warning("Property '{}' of an override was not recognized. Ignoring...", key);
+                }
+
+                m_buildConfig->overrides.push_back(flagOverride);
+            }
+        }
+
         if (config["compiler"])
         {
             std::string property = config["compiler"].as<std::string>();
@@ -187,11 +348,25 @@ void ConfigReader::ReadConfig()
             m_buildConfig->optimization = ProcessProperty(property);
         }
 
+        if (config["modules"])
+        {
+            std::string property = config["modules"].as<std::string>();
+            m_buildConfig->modules = ProcessProperty(property);
+        }
+
+        if (config["variants"])
+        {
+            const auto& variants = config["variants"];
+            std::vector<std::string> property = variants.IsSequence() ? variants.as<std::vector<std::string>>() : std::vector<std::string>{ variants.as<std::string>() };
+
+            m_buildConfig->variants = ProcessProperty(property);
+        }
+
         Logger::Debug("Successfully read config file");
     }
     catch (const YAML::Exception& e)
     {
-        Logger::Error(fmt::format("Failed when parsing config file '{}': {}", m_configPath, e.what()));
+        Logger::Error("Failed when parsing config file '{}': {}", m_configPath, e.what());
         Logger::Info("Using default configuration values.");
     }
 }
@@ -223,7 +398,154 @@ void ConfigReader::PostProcess()
 
     if (compileUi == ConfigConstants::TRUE && uiExtension != "hpp" && uiExtension != "h")
     {
-        Logger::Warning(fmt::format("UI extension '{}' is not valid and may cause issues.", uiExtension));
+        Logger::Warning("UI extension '{}' is not valid and may cause issues.", uiExtension);
+    }
+
+    const std::string memoryHeadroom = m_buildConfig->scheduler.at("memory_headroom");
+
+    if (SystemResources::ParseMemorySize(memoryHeadroom) == 0 && memoryHeadroom != "0" && !memoryHeadroom.empty())
+    {
+        Logger::Warning("Memory headroom '{}' is not a valid size. Memory won't be reserved.", memoryHeadroom);
+    }
+
+    if (m_buildConfig->cache.at("local") == ConfigConstants::AUTO)
+    {
+        m_buildConfig->cache["local"] = LocalCache::GetDefaultDirectory();
+    }
+
+    // NOTE: Next to the local cache's default directory, both are in the user's cache directory
+    if (m_buildConfig->cache.at("dependencies") == ConfigConstants::AUTO)
+    {
+        m_buildConfig->cache["dependencies"] = (fs::path(LocalCache::GetDefaultDirectory()).parent_path() / "deps").string();
+    }
+
+    const std::string maxCacheSize = m_buildConfig->cache.at("max_size");
+
+    if (SystemResources::ParseMemorySize(maxCacheSize) == 0 && !maxCacheSize.empty())
+    {
+        Logger::Warning("Cache size '{}' is not a valid size. The local cache won't be limited.", maxCacheSize);
+    }
+
+    const std::string compressionLevel = m_buildConfig->cache.at("compression_level");
+
+    // Negative levels are zstd's fastest ones
+    const std::size_t digitsStart = compressionLevel.starts_with('-') ? 1 : 0;
+    const bool isNumber = compressionLevel.length() > digitsStart && compressionLevel.length() <= digitsStart + 2
+        && compressionLevel.find_first_not_of("0123456789", digitsStart) == std::string::npos;
+
+    // No level ('none') stores the entries uncompressed, which lets them be linked instead of copied
+    if (!isNumber && !compressionLevel.empty())
+    {
+        Logger::Warning("Compression level '{}' is not a number. Using {} instead.", compressionLevel, Compression::DEFAULT_LEVEL);
+        m_buildConfig->cache["compression_level"] = std::to_string(Compression::DEFAULT_LEVEL);
+    }
+
+    const std::string& languageVersion = m_buildConfig->languageVersion;
+
+    // Modules came with C++20, earlier versions are '...++98' to '...++17'
+    const bool isBeforeCpp20 = languageVersion.ends_with("98") || languageVersion.ends_with("03") || languageVersion.ends_with("11")
+        || languageVersion.ends_with("14") || languageVersion.ends_with("17") || languageVersion.ends_with("1z");
+
+    if (m_buildConfig->modules == ConfigConstants::TRUE && isBeforeCpp20)
+    {
+        Logger::Warning("Modules need C++20 or newer, but the language version is '{}'", languageVersion);
+    }
+
+    const int platform = Platform::GetPlatform();
+
+    // The binary finds its libraries through an '$ORIGIN' rpath, which only ELF platforms have
+    if (m_buildConfig->link.at("dev_shared") == ConfigConstants::TRUE && (platform == Platform::WINDOWS || platform == Platform::MACOS))
+    {
+        Logger::Warning("Shared libraries per directory ('dev_shared') aren't supported on this platform. Linking the binary as usual.");
+        m_buildConfig->link["dev_shared"] = ConfigConstants::FALSE;
+    }
+
+    std::vector<std::string> variants;
+
+    for (const auto& variant : m_buildConfig->variants)
+    {
+        if (!VariantLauncher::IsKnownLevel(variant))
+            Logger::Warning("Variant '{}' isn't an x86-64 level (x86-64, x86-64-v2, x86-64-v3 or x86-64-v4). Ignoring it...", variant);
+        else if (std::find(variants.begin(), variants.end(), variant) == variants.end())
+            variants.push_back(variant);
+    }
+
+    VariantLauncher::SortLevels(variants);
+    m_buildConfig->variants = variants;
+
+    // The launcher replaces itself with a variant ('exec'), which Windows doesn't have
+    if (!m_buildConfig->variants.empty() && platform == Platform::WINDOWS)
+    {
+        Logger::Warning("Variants aren't supported on this platform. Building the project once.");
+        m_buildConfig->variants.clear();
+    }
+
+    // Every variant would need its own libraries, while the binary finds them next to itself under one name
+    if (!m_buildConfig->variants.empty() && m_buildConfig->link.at("dev_shared") == ConfigConstants::TRUE)
+    {
+        Logger::Warning("Variants aren't built with shared libraries per directory ('dev_shared'). Building the project once.");
+        m_buildConfig->variants.clear();
+    }
+
+    for (auto it = m_buildConfig->dependencies.begin(); it != m_buildConfig->dependencies.end();)
+    {
+        auto& [name, dependency] = *it;
+
+        // The name is part of the archive's file name ('lib<name>.a')
+        const bool isValidName = !name.empty() && std::all_of(name.begin(), name.end(), [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-' || c == '.'; });
+
+        if (!isValidName)
+        {
+            Logger::Warning("Dependency name '{}' can only have letters, digits, '_', '-' and '.'. Ignoring it...", name);
+            it = m_buildConfig->dependencies.erase(it);
+            continue;
+        }
+
+        if (dependency.path.empty() || !fs::is_directory(dependency.path))
+        {
+            Logger::Warning("Directory '{}' of dependency '{}' doesn't exist. Ignoring it...", dependency.path, name);
+            it = m_buildConfig->dependencies.erase(it);
+            continue;
+        }
+
+        // The package is built on its own, so the project's sources leave it out like an excluded directory
+        dependency.path = fs::path(dependency.path).lexically_normal().generic_string();
+
+        if (dependency.path.ends_with('/'))
+            dependency.path.pop_back();
+
+        m_buildConfig->exclude.push_back(dependency.path);
+        ++it;
+    }
+
+    for (auto it = m_buildConfig->overrides.begin(); it != m_buildConfig->overrides.end();)
+    {
+        std::erase_if(it->match, [](const std::string& pattern) { return pattern.empty(); });
+
+        if (it->match.empty())
+        {
+            Logger::Warning("An override doesn't match any path ('match' is missing). Ignoring it...");
+            it = m_buildConfig->overrides.erase(it);
+            continue;
+        }
+
+        ++it;
+    }
+
+    const std::string shards = m_buildConfig->tests.at("shards");
+
+    if (shards.empty() || shards.length() > 4 || shards.find_first_not_of("0123456789") != std::string::npos || std::stoul(shards) == 0)
+    {
+        Logger::Warning("Number of test shards '{}' is not a positive number. Tests won't be sharded.", shards);
+        m_buildConfig->tests["shards"] = "1";
+    }
+
+    const std::string testTimeout = m_buildConfig->tests.at("timeout");
+
+    if (!testTimeout.empty() && (testTimeout.length() > 6 || testTimeout.find_first_not_of("0123456789") != std::string::npos))
+    {
+        Logger::Warning("Test timeout '{}' is not a number of seconds. Tests won't time out.", testTimeout);
+        m_buildConfig->tests["timeout"] = "";
     }
 }
 
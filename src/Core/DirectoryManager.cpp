@@ -39,13 +39,13 @@ void DirectoryManager::CreateDirectory(const std::string& directory)
         if (fs::exists(directoryPath)) return;
 
         if (fs::create_directory(directoryPath))
-            Logger::Info(fmt::format("Created empty directory '{}'", directory));
+            Logger::Info("Created empty directory '{}'", directory);
         else
-            Logger::Error(fmt::format("Failed to create directory '{}'", directory));
+            Logger::Error("Failed to create directory '{}'", directory);
     }
     catch (const std::exception& e)
     {
-        Logger::Error(fmt::format("Failed to create directory '{}'", directory));
-        std::cerr << e.what() << '\n';
+        Logger::Error("Failed to create directory '{}'", directory);
+        Logger::Error("{}", e.what());
     }
 }
@@ -1,11 +1,141 @@
 #include "Core/FileCompiler.hpp"
+#include "Utils/Depfile.hpp"
+#include "Utils/FileSystem.hpp"
+#include "Utils/Hash.hpp"
 #include "Utils/Logger/Logger.hpp"
+#include "Utils/VariantLauncher.hpp"
 
+#include <map>
+#include <set>
+#include <sstream>
+#include <optional>
 #include <algorithm>
 #include <fmt/core.h>
 
 #include "Utils/RegexHelper.hpp"
 
+namespace
+{
+    std::vector<std::string> SplitArguments(const std::string& command)
+    {
+        std::vector<std::string> arguments;
+        std::istringstream stream(command);
+        std::string argument;
+
+        while (stream >> argument)
+            arguments.push_back(argument);
+
+        return arguments;
+    }
+
+    // Lists the arguments only one of the commands has, like "removed '-O0', added '-O2'"
+    std::string DescribeCommandChange(const std::string* previous, const std::string& current)
+    {
+        if (previous == nullptr)
+            return "its command or compiler changed";
+
+        if (*previous == current)
+            return "the compiler changed";
+
+        std::vector<std::string> removed = SplitArguments(*previous);
+        std::vector<std::string> added = SplitArguments(current);
+
+        // Arguments both commands have cancel out, once per occurrence
+        for (auto it = removed.begin(); it != removed.end();)
+        {
+            auto match = std::find(added.begin(), added.end(), *it);
+
+            if (match == added.end())
+            {
+                ++it;
+                continue;
+            }
+
+            added.erase(match);
+            it = removed.erase(it);
+        }
+
+        if (removed.empty() && added.empty())
+            return "its command changed (the same arguments in a different order)";
+
+        auto List = [](const std::string& verb, const std::vector<std::string>& arguments)
+        {
+            if (arguments.empty()) return std::string();
+
+            std::string list;
+
+            for (std::size_t i = 0; i < arguments.size() && i < 5; i++)
+                list += fmt::format("{}'{}'", i > 0 ? ", " : "", arguments[i]);
+
+            if (arguments.size() > 5)
+                list += fmt::format(" and {} more", arguments.size() - 5);
+
+            return fmt::format("{} {}", verb, list);
+        };
+
+        const std::string removedList = List("removed", removed);
+        const std::string addedList = List("added", added);
+
+        return fmt::format("its command changed ({}{}{})", removedList, !removedList.empty() && !addedList.empty() ? "; " : "", addedList);
+    }
+}
+
+FileCompiler::FileCompiler(std::shared_ptr<BuildConfig> config, const BuildOptions& options, std::shared_ptr<BuildMetrics> metrics)
+    : m_config(config), m_options(options), m_metrics(metrics)
+{
+    m_buildEngine = std::make_shared<BuildEngine>(m_config);
+
+    m_buildState = std::make_shared<BuildState>(fmt::format("{}/state", ConfigConstants::STATE_DIRECTORY));
+    m_buildState->Load();
+
+    const std::string& remote = m_config->cache.at("remote");
+
+    std::unique_ptr<LocalCache> localCache = LocalCache::Create(m_config);
+    std::unique_ptr<CacheBackend> remoteCache = nullptr;
+
+    if (!remote.empty())
+        remoteCache = CacheBackend::Create(remote);
+
+    // NOTE: Cached objects are told apart by the compiler's version, without it they'd be shared between any compilers
+    if ((localCache != nullptr || remoteCache != nullptr) && !m_buildEngine->IsCompilerFound())
+    {
+        Logger::Warning("The object cache is turned off, '{}' isn't known well enough to tell its objects apart", m_config->compiler);
+
+        localCache = nullptr;
+        remoteCache = nullptr;
+    }
+
+    if (localCache != nullptr || remoteCache != nullptr)
+        m_cache = std::make_shared<ObjectCache>(std::move(localCache), std::move(remoteCache), m_config->cache.at("upload") == ConfigConstants::TRUE);
+
+    m_scheduler = std::make_unique<JobScheduler>(m_config, m_options, m_buildState, m_metrics, m_cache);
+
+    if (m_buildEngine->UsesModules())
+    {
+        m_moduleGraph = std::make_unique<ModuleGraph>(fmt::format("{}/modules/scans", ConfigConstants::STATE_DIRECTORY));
+        m_moduleGraph->Load();
+    }
+    else if (m_config->modules == ConfigConstants::TRUE)
+    {
+        Logger::Warning("'{}' doesn't support modules ('-fmodules-ts'), sources are compiled without them", m_config->compiler);
+    }
+
+    for (const auto& variant : m_config->variants)
+    {
+        if (m_buildEngine->SupportsVariant(variant))
+            m_variants.push_back(variant);
+        else
+            Logger::Warning("'{}' can't build for '{}' ('-march={}'), skipping the variant", m_config->compiler, variant, variant);
+    }
+
+    // Without variants, the project itself is the only thing built
+    if (m_variants.empty())
+        m_variants.push_back("");
+
+    this->CheckRunVariant();
+    this->SetupDirectories();
+}
+
 void FileCompiler::SetupDirectories()
 {
     std::vector<std::string> tempDirs;
@@ -44,28 +174,30 @@ void FileCompiler::SetupDirectories()
     }
 }
 
-void FileCompiler::CompileObjectFiles(bool rebuild)
+void FileCompiler::CompileObjectFiles()
 {
+    const std::uint64_t scanStart = m_metrics->GetElapsed();
+
     for (const auto& dir : m_directoriesForCompilation)
     {
         const fs::path dirPath = dir;
-        Logger::Debug(fmt::format("Processing directory '{}'", dirPath.string()));
+        Logger::Debug("Processing directory '{}'", dirPath.string());
 
         if (RegexHelper::MatchesRegex(dirPath, m_config->exclude))
         {
-            Logger::Info(fmt::format("Skipping excluded directory '{}'", dirPath.string()));
+            Logger::Info("Skipping excluded directory '{}'", dirPath.string());
             continue;
         }
 
         if (!fs::exists(dirPath))
         {
-            Logger::Error(fmt::format("Source directory '{}' doesn't exist, skipping...", dir));
+            Logger::Error("Source directory '{}' doesn't exist, skipping...", dir);
             continue;
         }
 
         if (fs::is_empty(dirPath))
         {
-            Logger::Warning(fmt::format("Source directory '{}' is empty. No files to process, skipping...", dir));
+            Logger::Warning("Source directory '{}' is empty. No files to process, skipping...", dir);
             continue;
         }
 
@@ -74,7 +206,7 @@ void FileCompiler::CompileObjectFiles(bool rebuild)
             const fs::path sourcePath = entry.path();
 
             if (RegexHelper::MatchesRegex(sourcePath, m_config->exclude)) {
-                Logger::Info(fmt::format("Skipping excluded '{}'", sourcePath.string()));
+                Logger::Info("Skipping excluded '{}'", sourcePath.string());
 
                 // If it's a directory, skip recursion into it
                 if (fs::is_directory(sourcePath)) {
@@ -88,12 +220,22 @@ void FileCompiler::CompileObjectFiles(bool rebuild)
 
             fs::path childPath = fs::relative(sourcePath, dirPath);
 
-            this->CompileObjectFile(dirPath, childPath, rebuild);
+            this->CompileObjectFile(dirPath, childPath);
         }
     }
+
+    if (m_moduleGraph != nullptr)
+        this->QueueModuleSources();
+
+    this->QueueDependencies();
+
+    m_metrics->AddPhaseTime(BuildPhase::Scan, m_metrics->GetElapsed() - scanStart);
+
+    if (m_scheduler->GetJobCount() == 0)
+        Logger::Info("All files are up to date");
 }
 
-void FileCompiler::CompileObjectFile(fs::path parentDirectory, fs::path childPath, bool rebuild)
+void FileCompiler::CompileObjectFile(fs::path parentDirectory, fs::path childPath)
 {
     // Get filename without path
     const std::string& extension = childPath.extension().string().substr(1);
@@ -102,88 +244,371 @@ void FileCompiler::CompileObjectFile(fs::path parentDirectory, fs::path childPat
     fs::path sourcePath = parentDirectory / childPath;
     sourcePath.replace_extension(extension);
 
-    try
+    // The order of module units is only known once every source was scanned
+    if (m_moduleGraph != nullptr && extension == "cpp")
+    {
+        m_moduleSources.emplace_back(sourcePath, path);
+        return;
+    }
+
+    // Generated UI headers are shared by the variants, everything else is built for each of them
+    const std::vector<std::string> variants = extension == "ui" ? std::vector<std::string>{ m_variants.front() } : m_variants;
+
+    for (const auto& variant : variants)
     {
+        m_buildEngine->SetVariant(variant);
+
         const std::string outputPathStr = m_buildEngine->GetOutputPath(path, extension);
 
         if (outputPathStr == "")
         {
-            Logger::Warning(fmt::format("Skipping compilation of file '{}'", sourcePath.string()));
+            Logger::Warning("Skipping compilation of file '{}'", sourcePath.string());
             return;
         }
 
-        fs::path outputPath = outputPathStr;
-        fs::create_directories(outputPath.parent_path());
+        this->QueueFileJob(sourcePath, extension, outputPathStr);
+    }
+}
+
+std::optional<std::size_t> FileCompiler::QueueFileJob(
+    const fs::path& sourcePath,
+    const std::string& extension,
+    const fs::path& outputPath,
+    const std::vector<std::size_t>& dependencies,
+    const std::string& outdatedReason,
+    bool isCacheable
+)
+{
+    fs::create_directories(outputPath.parent_path());
+
+    const fs::path outputFile = outputPath;
+    m_knownOutputs.insert(outputFile.lexically_normal().string());
+
+    const std::string command = m_buildEngine->GetCompileCommandForFile(extension, sourcePath.string(), outputPath);
+
+    // Safety check
+    if (command.empty())
+    {
+        Logger::Error("Empty compile command was returned for file {}", sourcePath.string());
+        return std::nullopt;
+    }
+
+    const std::string signature = m_buildEngine->GetCommandSignature(command, extension);
+    const std::string depfile = m_buildEngine->GetDepfilePath(extension, outputPath.string());
+    const std::string commandTemplate = m_buildEngine->GetCommandTemplate(command, sourcePath.string(), outputPath.string(), depfile);
+
+    // NOTE: The contents are only hashed for sources that are built (or might be),
+    // so the next '--explain' can tell whether they were edited or only touched
+    std::string sourceHash;
+    std::string reason;
+
+    // If the rebuild flag is passed, just skip this check
+    if (m_options.rebuild)
+        reason = "everything is rebuilt ('--rebuild')";
+    else if (!outdatedReason.empty())
+        reason = outdatedReason;
+    else if (!fs::exists(outputFile))
+        reason = fmt::format("'{}' doesn't exist", outputPath.string());
+    else
+    {
+        std::error_code error;
+        auto sourceLastModified = fs::last_write_time(sourcePath);
+        auto outputLastModified = this->GetOutputTime(outputPath.string(), error);
 
-        const fs::path outputFile = outputPath;
+        const BuildRecord* record = m_buildState->GetRecord(outputPath.string());
+        const bool commandChanged = record != nullptr && !record->signature.empty() && record->signature != signature;
 
-        // If the rebuild flag is passed, just skip this check
-        if (fs::exists(outputFile) && !rebuild)
+        // Rebuild if the source file or its headers are newer than the object file, or it was built differently
+        if (sourceLastModified > outputLastModified)
         {
-            auto sourceLastModified = fs::last_write_time(sourcePath);
-            auto outputLastModified = fs::last_write_time(outputFile);
+            sourceHash = Hash::Sha256File(sourcePath.string());
+            reason = this->DescribeSourceChange(sourcePath.string(), sourceHash, record);
+        }
+        else if (commandChanged)
+        {
+            Logger::Debug("Rebuilding {} (its command or compiler changed)", sourcePath.string());
+
+            const std::string* previousTemplate = record->command.empty() ? nullptr : m_buildState->GetCommand(record->command);
+            reason = DescribeCommandChange(previousTemplate, commandTemplate);
+        }
+        else
+        {
+            reason = this->FindNewerDependency(depfile, outputLastModified);
+        }
+
+        if (reason.empty())
+        {
+            Logger::Debug("Skipping {} (up to date)", sourcePath.string());
+            m_metrics->AddSkippedUnit();
 
-            // Skip compilation if the source file is older than the object file (up-to-date)
-            if (sourceLastModified <= outputLastModified)
+            // Outputs built before signatures were recorded are trusted and get the current one
+            if (record == nullptr || record->signature.empty())
             {
-                Logger::Debug(fmt::format("Skipping {} (up to date)", sourcePath.string()));
-                return;
+                BuildRecord updatedRecord = record != nullptr ? *record : BuildRecord();
+                updatedRecord.signature = signature;
+
+                m_buildState->SetRecord(outputPath.string(), updatedRecord);
             }
+
+            return std::nullopt;
         }
+    }
 
-        const std::string command = m_buildEngine->GetCompileCommandForFile(extension, sourcePath.string(), outputPath);
+    this->Explain(sourcePath.string(), reason);
 
-        // Safety check
-        if (command.empty())
-        {
-            Logger::Error(fmt::format("Empty compile command was returned for file {}", sourcePath.string()));
-            return;
-        }
+    const bool isSource = extension == "cpp" || extension == "c";
 
-        const int exitStatus = system(command.c_str());
+    Job job = { isSource ? JobType::Compile : JobType::Codegen, command, sourcePath.string(), outputPath.string(), {}, signature, depfile };
 
-        if (exitStatus != 0)
-            throw std::runtime_error(command);
+    // NOTE: The UI directories are compiled first (see SetupDirectories),
+    // so every generated header job is already known when source files are queued
+    if (isSource)
+        job.dependencies = m_generatedHeaderJobs;
+
+    job.dependencies.insert(job.dependencies.end(), dependencies.begin(), dependencies.end());
+    job.isCacheable = isCacheable;
+    job.temporaryOutput = BuildEngine::GetTemporaryPath(job.output);
+    job.commandKey = m_buildState->AddCommand(commandTemplate);
+    job.sourceHash = !sourceHash.empty() ? sourceHash : Hash::Sha256File(sourcePath.string());
+
+    const std::string output = job.output;
+    const std::size_t index = m_scheduler->AddJob(std::move(job));
+
+    m_queuedOutputs.emplace_back(output, index);
+
+    if (extension == "ui")
+        m_generatedHeaderJobs.push_back(index);
+
+    return index;
+}
 
-        Logger::Info(fmt::format("Compiled {}", sourcePath.string()));
+void FileCompiler::QueueModuleSources()
+{
+    const std::string scanOutput = fmt::format("{}/modules/scan.ddi", ConfigConstants::STATE_DIRECTORY);
+
+    std::vector<std::string> sources;
+    std::vector<const ModuleUnit*> units;
+
+    // NOTE: The variants share the scans, the scan command doesn't have their '-march'
+    m_buildEngine->SetVariant(m_variants.front());
+
+    for (const auto& [sourcePath, name] : m_moduleSources)
+    {
+        const std::string outputPath = m_buildEngine->GetOutputPath(name, "cpp");
+        const std::string scanCommand = m_buildEngine->GetScanCommandForFile(sourcePath.string(), outputPath, scanOutput);
+
+        sources.push_back(sourcePath.string());
+        units.push_back(&m_moduleGraph->Scan(sourcePath.string(), scanCommand, scanOutput));
     }
-    catch (const std::runtime_error& command)
+
+    m_moduleGraph->Save();
+
+    std::vector<std::size_t> order;
+
+    if (!m_moduleGraph->Sort(sources, order))
+        Logger::Fatal("Modules can't import each other in a cycle");
+
+    for (const auto& variant : m_variants)
     {
-        Logger::Error(fmt::format("Failed to compile '{}'", sourcePath.string()));
-        Logger::Fatal(fmt::format("Command: {}", command.what()));
+        m_buildEngine->SetVariant(variant);
+        this->QueueModuleUnits(units, order);
     }
 }
 
-void FileCompiler::LinkObjectFiles()
+void FileCompiler::QueueModuleUnits(const std::vector<const ModuleUnit*>& units, const std::vector<std::size_t>& order)
 {
-    const fs::path objPath = m_config->directories.at("obj")[0];
+    // The mapper lists every module, including the ones whose BMI is only built later in this build
+    std::map<std::string, std::string> interfaces;
 
-    if (fs::is_empty(objPath))
+    for (const ModuleUnit* unit : units)
     {
-        Logger::Warning("No object files were found, skipping linking phase...");
-        return;
+        if (!unit->provides.empty())
+            interfaces[unit->provides] = m_buildEngine->GetModuleInterfacePath(unit->provides);
     }
 
-    std::vector<std::string> objects;
+    ModuleGraph::WriteMapper(m_buildEngine->GetModuleMapperPath(), interfaces);
+
+    // Jobs building a BMI, by the module they provide
+    std::map<std::string, std::size_t> interfaceJobs;
+
+    for (std::size_t index : order)
+    {
+        const auto& [sourcePath, name] = m_moduleSources[index];
+        const std::string outputPath = m_buildEngine->GetOutputPath(name, "cpp");
+        const ModuleUnit& unit = *units[index];
 
-    // const fs::directory_iterator objDir (objPath);
+        std::vector<std::size_t> dependencies;
+        std::string outdatedReason;
 
-    // for (auto const& file : objDir)
-    // {
-    //     const std::string filePath = file.path().string();
-    //     objects.push_back(filePath);
-    // }
+        std::error_code error;
+        const auto outputLastModified = fs::last_write_time(outputPath, error);
+
+        for (const auto& name : unit.imports)
+        {
+            if (interfaceJobs.contains(name))
+            {
+                dependencies.push_back(interfaceJobs.at(name));
+
+                if (outdatedReason.empty())
+                    outdatedReason = fmt::format("module '{}' it imports is rebuilt", name);
+
+                continue;
+            }
 
-    for (auto it = fs::recursive_directory_iterator(objPath); it != fs::recursive_directory_iterator(); ++it) {
-        const fs::directory_entry& entry = *it;
-        const fs::path path = entry.path();
+            // A BMI rebuilt in an earlier build (that failed before this object was built) is newer than the object
+            std::error_code interfaceError;
+            const auto interfaceLastModified = fs::last_write_time(m_buildEngine->GetModuleInterfacePath(name), interfaceError);
 
-        if (!fs::is_regular_file(entry))
+            if (!error && !interfaceError && interfaceLastModified > outputLastModified && outdatedReason.empty())
+                outdatedReason = fmt::format("the BMI of module '{}' it imports is newer than its object", name);
+        }
+
+        // Every set of flags has its own BMIs, so switching flags can find the object up to date but the BMI missing
+        if (!unit.provides.empty() && !fs::exists(m_buildEngine->GetModuleInterfacePath(unit.provides)) && outdatedReason.empty())
+            outdatedReason = fmt::format("the BMI of module '{}' doesn't exist", unit.provides);
+
+        if (!outdatedReason.empty() && !error)
+            Logger::Debug("Rebuilding {} (a module it depends on changed)", sourcePath.string());
+
+        const bool isModuleUnit = !unit.provides.empty() || !unit.imports.empty();
+        const std::optional<std::size_t> job = this->QueueFileJob(sourcePath, sourcePath.extension().string().substr(1), outputPath, dependencies, outdatedReason, !isModuleUnit);
+
+        if (job.has_value() && !unit.provides.empty())
+            interfaceJobs[unit.provides] = *job;
+    }
+}
+
+void FileCompiler::QueueDependencies()
+{
+    static const std::set<std::string> sourceExtensions = { ".c", ".cc", ".cpp", ".cxx" };
+    static const std::set<std::string> headerExtensions = { ".h", ".hh", ".hpp", ".hxx", ".inl", ".ipp", ".tpp" };
+
+    // The commands are run from the package's directory, so the objects need an absolute path
+    const fs::path storePath = fs::absolute(m_config->cache.at("dependencies"));
+
+    for (const auto& [name, dependency] : m_config->dependencies)
+    {
+        const fs::path packagePath = dependency.path;
+
+        // Paths relative to the package's directory, the same in every project vendoring it
+        std::set<std::string> sources;
+        std::set<std::string> hashedFiles;
+
+        auto AddFile = [&](const fs::path& path, bool isSourceEntry)
+        {
+            const std::string extension = path.extension().string();
+            const std::string relativePath = path.lexically_relative(packagePath).generic_string();
+
+            if (isSourceEntry && sourceExtensions.contains(extension))
+                sources.insert(relativePath);
+
+            if (sourceExtensions.contains(extension) || headerExtensions.contains(extension))
+                hashedFiles.insert(relativePath);
+        };
+
+        auto AddEntry = [&](const std::string& entry, bool isSourceEntry)
+        {
+            const fs::path path = (packagePath / entry).lexically_normal();
+
+            if (fs::is_regular_file(path))
+            {
+                AddFile(path, isSourceEntry);
+                return;
+            }
+
+            if (!fs::is_directory(path))
+            {
+                Logger::Warning("'{}' of dependency '{}' doesn't exist", entry, name);
+                return;
+            }
+
+            for (const auto& file : fs::recursive_directory_iterator(path))
+            {
+                if (file.is_regular_file())
+                    AddFile(file.path(), isSourceEntry);
+            }
+        };
+
+        for (const auto& entry : dependency.sources)
+            AddEntry(entry, true);
+
+        for (const auto& entry : dependency.include)
+            AddEntry(entry, false);
+
+        if (sources.empty())
+        {
+            Logger::Warning("Dependency '{}' has no sources, nothing is built for it", name);
+            continue;
+        }
+
+        // NOTE: The archive is built again for every toolchain, set of flags and contents of the package,
+        // so the directory is named after all of them and a built archive is never out of date
+        std::uint64_t fingerprint = Hash::Fnv1a(name);
+
+        for (const auto& source : sources)
+        {
+            const std::string command = m_buildEngine->GetCompileCommandForDependency(dependency, source, "$out");
+            const std::string signature = m_buildEngine->GetCommandSignature(command, fs::path(source).extension().string().substr(1));
+
+            fingerprint = Hash::Fnv1a(source + '\t' + signature + '\n', fingerprint);
+        }
+
+        for (const auto& file : hashedFiles)
+            fingerprint = Hash::Fnv1a(file + '\t' + Hash::Sha256File((packagePath / file).string()) + '\n', fingerprint);
+
+        const fs::path buildPath = storePath / fmt::format("{}-{}", name, Hash::ToHex(fingerprint));
+        const std::string archive = (buildPath / fmt::format("lib{}.a", name)).string();
+
+        m_dependencyArchives.push_back(archive);
+
+        if (fs::exists(archive))
+        {
+            Logger::Debug("Dependency '{}' is already built in '{}'", name, buildPath.string());
             continue;
+        }
 
-        objects.push_back(path.string());
+        Logger::Info("Building dependency '{}' into '{}'", name, buildPath.string());
+        this->Explain(name, "the dependency isn't built with these sources, flags and compiler yet");
+
+        std::vector<std::string> objects;
+        std::vector<std::size_t> compileJobs;
+
+        for (const auto& source : sources)
+        {
+            // The extension is kept, so 'a.c' and 'a.cpp' don't share an object
+            const fs::path objectPath = buildPath / "obj" / (source + ".o");
+            objects.push_back(objectPath.string());
+
+            // Objects finished by an interrupted build are kept, they can't be out of date
+            if (fs::exists(objectPath))
+                continue;
+
+            fs::create_directories(objectPath.parent_path());
+
+            // Another project may be building the same package right now, each process writes to its own temporary path
+            const std::string temporaryPath = BuildEngine::GetTemporaryPath(objectPath.string(), true);
+            const std::string command = m_buildEngine->GetCompileCommandForDependency(dependency, source, temporaryPath);
+            const std::string signature = m_buildEngine->GetCommandSignature(command, fs::path(source).extension().string().substr(1));
+
+            Job job = { JobType::Compile, fmt::format("cd {} && {}", dependency.path, command), (packagePath / source).string(), objectPath.string(), {}, signature, "" };
+            job.temporaryOutput = temporaryPath;
+
+            compileJobs.push_back(m_scheduler->AddJob(std::move(job)));
+        }
+
+        bool membersChanged = false;
+        const std::string command = m_buildEngine->GetArchiveCommand(archive, objects, membersChanged, false, true);
+
+        Job job = { JobType::Archive, command, name, archive, compileJobs, m_buildEngine->GetCommandSignature(command, ""), "" };
+        job.temporaryOutput = BuildEngine::GetTemporaryPath(archive, true);
+
+        // The binary has to be linked again once the archive is built
+        m_queuedOutputs.emplace_back(archive, m_scheduler->AddJob(std::move(job)));
     }
+}
 
+void FileCompiler::LinkObjectFiles()
+{
     m_output = fmt::format(
         "{}/{}{}{}",
         m_config->directories.at("bin")[0],
@@ -192,37 +617,715 @@ void FileCompiler::LinkObjectFiles()
         m_config->extension
     );
 
-    try
+    // NOTE: Every link waits for every compile, so its duration is part of every path the scheduler weighs
+    std::vector<std::size_t> compileJobs;
+
+    for (std::size_t i = 0; i < m_scheduler->GetJobCount(); i++)
+        compileJobs.push_back(i);
+
+    // The tests are linked with the objects of the first variant, the one most CPUs run
+    std::set<std::string> testObjects;
+    std::vector<std::string> linkedVariants;
+
+    for (const auto& variant : m_variants)
     {
-        const std::string command = m_buildEngine->GetLinkCommandForProject(objects, m_output);
+        m_buildEngine->SetVariant(variant);
 
-        const int exitStatus = system(command.c_str());
+        // With variants, the project's binary is the launcher and every variant is linked next to it
+        const std::string binary = variant.empty()
+            ? m_output
+            : VariantLauncher::GetBinaryName(fmt::format("{}/{}", m_config->directories.at("bin")[0], m_config->output), m_config->extension, variant);
 
-        if (exitStatus != 0)
-            throw std::runtime_error(command);
+        std::set<std::string> objects;
+
+        // A variant without objects is left out, the jobs of the others are still run
+        if (!this->QueueLink(binary, compileJobs, objects))
+        {
+            if (!variant.empty())
+                Logger::Warning("No object files were found for variant '{}', skipping its link", variant);
+
+            continue;
+        }
+
+        linkedVariants.push_back(variant);
+
+        if (testObjects.empty())
+            testObjects = objects;
     }
-    catch (const std::runtime_error& command)
+
+    if (linkedVariants.empty())
     {
-        Logger::Error("Failed when linking project");
-        Logger::Fatal(fmt::format("Command: {}", command.what()));
+        Logger::Warning("No object files were found, skipping linking phase...");
+        this->WriteMetrics(true);
+        return;
+    }
+
+    if (!linkedVariants.front().empty())
+        this->QueueLauncher(linkedVariants);
+
+    if (m_options.test)
+    {
+        m_buildEngine->SetVariant(linkedVariants.front());
+        this->QueueTests({ testObjects.begin(), testObjects.end() }, compileJobs);
     }
 
+    const bool success = m_scheduler->Run();
+
+    if (m_cache != nullptr)
+        m_cache->Finish();
+
+    // Saved even after a failure, so the jobs that did run aren't lost
+    m_buildState->Save();
+
+    // NOTE: The next build continues where this one stopped, the finished jobs are in the state
+    if (const int signal = m_scheduler->GetInterruptSignal(); signal != 0)
+    {
+        Logger::Error("Build interrupted");
+        Logger::Exit(128 + signal);
+    }
+
+    this->WriteMetrics(success);
+
+    if (!success)
+        Logger::Fatal("Build failed");
+
     Logger::Info("Build successful");
+
+    if (m_options.test)
+        this->ReportTests();
+}
+
+bool FileCompiler::QueueLink(const std::string& binary, const std::vector<std::size_t>& compileJobs, std::set<std::string>& objects)
+{
+    const fs::path objPath = m_buildEngine->GetObjectDirectory();
+
+    // NOTE: Both the existing objects and the ones that are about to be compiled are linked.
+    // The paths are normalized, since queued outputs start with './' and scanned ones don't.
+    // A variant's directory only exists once one of its objects was queued.
+    if (fs::exists(objPath))
+    {
+        for (auto it = fs::recursive_directory_iterator(objPath); it != fs::recursive_directory_iterator(); ++it) {
+            const fs::directory_entry& entry = *it;
+            const fs::path path = entry.path();
+
+            if (!fs::is_regular_file(entry))
+                continue;
+
+            // Dependency files live next to the objects, and temporary files are left behind by interrupted writes
+            if (path.extension() == ".d" || path.extension() == ".tmp")
+                continue;
+
+            objects.insert(path.lexically_normal().string());
+        }
+    }
+
+    for (const auto& [output, _] : m_queuedOutputs)
+    {
+        const fs::path outputPath = fs::path(output).lexically_normal();
+        const fs::path relativePath = outputPath.lexically_relative(objPath.lexically_normal());
+
+        // Only outputs inside the object directory are linked (generated UI headers aren't)
+        if (!relativePath.empty() && *relativePath.begin() != "..")
+            objects.insert(outputPath.string());
+    }
+
+    if (objects.empty())
+        return false;
+
+    std::vector<std::string> files = { objects.begin(), objects.end() };
+    std::vector<std::string> archives;
+    std::vector<std::string> sharedLibraries;
+
+    const bool isDevShared = m_config->link.at("dev_shared") == ConfigConstants::TRUE;
+    bool librariesChanged = false;
+
+    // The archives and libraries queued for this binary are waited for as well
+    std::vector<std::size_t> dependencies = compileJobs;
+    const std::size_t firstJob = m_scheduler->GetJobCount();
+
+    if (isDevShared)
+        sharedLibraries = this->QueueSharedLibraries(objPath, files, librariesChanged);
+
+    if (m_config->link.at("thin_archives") == ConfigConstants::TRUE)
+        archives = this->QueueArchives(objPath, files);
+
+    for (std::size_t i = firstJob; i < m_scheduler->GetJobCount(); i++)
+        dependencies.push_back(i);
+
+    // Linked after the project's objects, which are the ones referring to them
+    files.insert(files.end(), m_dependencyArchives.begin(), m_dependencyArchives.end());
+
+    bool inputsChanged = false;
+    const std::string command = m_buildEngine->GetLinkCommandForProject(files, archives, sharedLibraries, binary, "", &inputsChanged);
+    const std::string signature = m_buildEngine->GetCommandSignature(command, "");
+
+    const std::string commandTemplate = m_buildEngine->GetCommandTemplate(command, "", binary, "");
+
+    // NOTE: The binary is usually linked every time. With shared libraries it only holds the objects
+    // outside of them, and loads the libraries when it starts, so a change inside a library doesn't relink it
+    // (unless the library is linked differently, which can change its soname).
+    const BuildRecord* record = m_buildState->GetRecord(binary);
+    const std::map<std::string, std::size_t> queuedJobs = this->GetQueuedJobs();
+
+    std::string reason;
+    const bool isInputOutdated = this->IsGroupOutdated(binary, files, queuedJobs, nullptr, &reason) || this->IsGroupOutdated(binary, archives, queuedJobs, nullptr, &reason);
+
+    if (m_options.rebuild)
+    {
+        reason = "everything is rebuilt ('--rebuild')";
+    }
+    else if (!isInputOutdated)
+    {
+        if (inputsChanged)
+            reason = "its inputs changed (objects were added or removed)";
+        else if (record == nullptr || record->signature != signature)
+            reason = DescribeCommandChange(record != nullptr && !record->command.empty() ? m_buildState->GetCommand(record->command) : nullptr, commandTemplate);
+        else if (librariesChanged)
+            reason = "a library it loads is linked differently";
+        else if (!isDevShared)
+            reason = "the binary is linked on every build";
+    }
+
+    for (const auto& object : objects)
+    {
+        if (!m_knownOutputs.contains(object))
+            this->Explain(binary, fmt::format("'{}' is linked, but no source produces it anymore (orphaned)", object));
+    }
+
+    if (reason.empty())
+    {
+        Logger::Debug("Skipping {} (up to date)", binary);
+        return true;
+    }
+
+    this->Explain(binary, reason);
+
+    Job job = { JobType::Link, command, binary, binary, dependencies, signature, "" };
+    job.temporaryOutput = BuildEngine::GetTemporaryPath(binary);
+    job.commandKey = m_buildState->AddCommand(commandTemplate);
+
+    m_scheduler->AddJob(std::move(job));
+    return true;
+}
+
+void FileCompiler::QueueLauncher(const std::vector<std::string>& variants)
+{
+    const std::string source = fmt::format("{}/variants/launcher.cpp", ConfigConstants::STATE_DIRECTORY);
+    const std::string contents = VariantLauncher::GetSource(m_config->output, m_config->extension, variants);
+
+    // Only written once the variants change, so the launcher isn't built again on every build
+    if (!FileSystem::WriteFileIfChanged(source, contents))
+        Logger::Fatal("Failed to write the launcher source '{}'", source);
+
+    const std::string command = m_buildEngine->GetLauncherCommand(source, m_output);
+    const std::string signature = m_buildEngine->GetCommandSignature(command, "");
+    const std::string commandTemplate = m_buildEngine->GetCommandTemplate(command, source, m_output, "");
+
+    const BuildRecord* record = m_buildState->GetRecord(m_output);
+    std::string reason;
+
+    if (m_options.rebuild)
+        reason = "everything is rebuilt ('--rebuild')";
+    else if (!this->IsGroupOutdated(m_output, { source }, {}, nullptr, &reason) && (record == nullptr || record->signature != signature))
+        reason = DescribeCommandChange(record != nullptr && !record->command.empty() ? m_buildState->GetCommand(record->command) : nullptr, commandTemplate);
+
+    if (reason.empty())
+    {
+        Logger::Debug("Skipping {} (up to date)", m_output);
+        return;
+    }
+
+    this->Explain(m_output, reason);
+
+    Job job = { JobType::Link, command, source, m_output, {}, signature, "" };
+    job.temporaryOutput = BuildEngine::GetTemporaryPath(m_output);
+    job.commandKey = m_buildState->AddCommand(commandTemplate);
+
+    m_scheduler->AddJob(std::move(job));
+}
+
+void FileCompiler::QueueTests(const std::vector<std::string>& objects, const std::vector<std::size_t>& projectJobs)
+{
+    const fs::path testDirectory = m_config->tests.at("directory");
+
+    if (testDirectory.empty())
+    {
+        Logger::Warning("No test directory is set, set 'directory' in the 'tests' section of the config");
+        return;
+    }
+
+    if (!fs::exists(testDirectory))
+    {
+        Logger::Error("Test directory '{}' doesn't exist, skipping tests...", testDirectory.string());
+        return;
+    }
+
+    // The object with the project's 'main' in it is left out, the tests have their own
+    const fs::path mainSource = fs::path(m_config->tests.at("main")).lexically_normal();
+    std::string mainObject;
+
+    for (const auto& dir : m_config->directories.at("src"))
+    {
+        const fs::path relativePath = mainSource.lexically_relative(fs::path(dir).lexically_normal());
+
+        if (relativePath.empty() || *relativePath.begin() == ".." || !mainSource.has_extension())
+            continue;
+
+        const std::string extension = mainSource.extension().string().substr(1);
+        const std::string outputPath = m_buildEngine->GetOutputPath(fs::path(relativePath).replace_extension("").string(), extension);
+
+        mainObject = fs::path(outputPath).lexically_normal().string();
+    }
+
+    std::vector<std::string> projectObjects;
+
+    for (const auto& object : objects)
+    {
+        if (object != mainObject)
+            projectObjects.push_back(object);
+    }
+
+    const std::size_t shards = std::stoul(m_config->tests.at("shards"));
+    const std::string& timeout = m_config->tests.at("timeout");
+
+    // The test objects compiled below are added as they're queued
+    std::map<std::string, std::size_t> queuedJobs = this->GetQueuedJobs();
+
+    for (auto it = fs::recursive_directory_iterator(testDirectory); it != fs::recursive_directory_iterator(); ++it)
+    {
+        const fs::path sourcePath = it->path();
+
+        if (RegexHelper::MatchesRegex(sourcePath, m_config->exclude))
+        {
+            if (fs::is_directory(sourcePath))
+                it.disable_recursion_pending();
+
+            continue;
+        }
+
+        if (!it->is_regular_file() || (sourcePath.extension() != ".cpp" && sourcePath.extension() != ".c"))
+            continue;
+
+        // 'tests/a/b.cpp' is compiled to '.kole/tests/a/b.o' and linked to 'bin/tests/a/b'
+        const fs::path relativePath = fs::relative(sourcePath, testDirectory);
+
+        const fs::path objectPath = (fs::path(ConfigConstants::STATE_DIRECTORY) / "tests" / relativePath).replace_extension("o");
+        fs::path binaryPath = fs::path(m_config->directories.at("bin")[0]) / "tests" / relativePath;
+        binaryPath.replace_extension(m_config->extension);
+
+        std::vector<std::size_t> linkDependencies = projectJobs;
+
+        if (const std::optional<std::size_t> compileJob = this->QueueFileJob(sourcePath, sourcePath.extension().string().substr(1), objectPath))
+        {
+            linkDependencies.push_back(*compileJob);
+            queuedJobs[objectPath.lexically_normal().string()] = *compileJob;
+        }
+
+        std::vector<std::string> files = projectObjects;
+        files.push_back(objectPath.string());
+        files.insert(files.end(), m_dependencyArchives.begin(), m_dependencyArchives.end());
+
+        fs::create_directories(binaryPath.parent_path());
+
+        const std::string binary = binaryPath.string();
+
+        bool inputsChanged = false;
+        const std::string command = m_buildEngine->GetLinkCommandForProject(files, {}, {}, binary, m_config->tests.at("flags"), &inputsChanged);
+        const std::string signature = m_buildEngine->GetCommandSignature(command, "");
+        const std::string commandTemplate = m_buildEngine->GetCommandTemplate(command, "", binary, "");
+
+        // Relinked like an archive, only once one of its objects or its command changed
+        const BuildRecord* record = m_buildState->GetRecord(binary);
+        std::string reason;
+
+        if (m_options.rebuild)
+        {
+            reason = "everything is rebuilt ('--rebuild')";
+        }
+        else if (!this->IsGroupOutdated(binary, files, queuedJobs, nullptr, &reason))
+        {
+            if (inputsChanged)
+                reason = "its inputs changed (objects were added or removed)";
+            else if (record == nullptr || record->signature != signature)
+                reason = DescribeCommandChange(record != nullptr && !record->command.empty() ? m_buildState->GetCommand(record->command) : nullptr, commandTemplate);
+        }
+
+        std::vector<std::size_t> testDependencies;
+
+        if (reason.empty())
+        {
+            Logger::Debug("Skipping {} (up to date)", binary);
+        }
+        else
+        {
+            this->Explain(binary, reason);
+
+            Job linkJob = { JobType::Link, command, binary, binary, linkDependencies, signature, "" };
+            linkJob.temporaryOutput = BuildEngine::GetTemporaryPath(binary);
+            linkJob.commandKey = m_buildState->AddCommand(commandTemplate);
+
+            testDependencies.push_back(m_scheduler->AddJob(std::move(linkJob)));
+        }
+
+        for (std::size_t shard = 0; shard < shards; shard++)
+        {
+            // The shard is part of the name, so every shard keeps its own duration and result for the next run.
+            // Its record never shares the binary's, which holds the signature of the link.
+            const std::string name = shards > 1 ? fmt::format("{} [{}/{}]", binary, shard + 1, shards) : binary;
+            const std::string record = fmt::format("{} [{}/{}]", binary, shard + 1, shards);
+
+            Job job = { JobType::Test, m_buildEngine->GetTestCommand(binary, shard, shards), name, record, testDependencies, "", "" };
+            job.timeout = timeout.empty() ? 0 : std::stoull(timeout) * 1000;
+
+            m_scheduler->AddJob(std::move(job));
+            m_testJobCount++;
+        }
+    }
+
+    if (m_testJobCount == 0)
+        Logger::Warning("No tests were found in '{}'", testDirectory.string());
+}
+
+void FileCompiler::ReportTests()
+{
+    const std::vector<std::string> failedTests = m_scheduler->GetFailedTests();
+
+    if (failedTests.empty())
+    {
+        Logger::Info("All {} test run(s) passed", m_testJobCount);
+        return;
+    }
+
+    Logger::Error("{} of {} test run(s) failed:", failedTests.size(), m_testJobCount);
+
+    for (const auto& test : failedTests)
+        Logger::Error("  {}", test);
+
+    Logger::Fatal("Tests failed");
+}
+
+std::vector<std::string> FileCompiler::QueueArchives(const fs::path& objPath, std::vector<std::string>& files)
+{
+    std::map<std::string, std::vector<std::string>> directories;
+    std::vector<std::string> remainingFiles;
+
+    // NOTE: Only objects are archived, generated moc sources are compiled by the link itself
+    for (const auto& file : files)
+    {
+        if (fs::path(file).extension() != ".o")
+        {
+            remainingFiles.push_back(file);
+            continue;
+        }
+
+        const fs::path directory = fs::path(file).parent_path().lexically_relative(objPath.lexically_normal());
+        directories[directory.generic_string()].push_back(file);
+    }
+
+    const std::map<std::string, std::size_t> queuedJobs = this->GetQueuedJobs();
+
+    const fs::path archiveDirectory = fs::path(ConfigConstants::STATE_DIRECTORY) / "archives";
+    std::vector<std::string> archives;
+
+    for (const auto& [directory, members] : directories)
+    {
+        // 'obj/a/b' is archived in '.kole/archives/obj-a-b.a'
+        std::string name = objPath.lexically_normal().generic_string();
+
+        if (directory != ".")
+            name += "/" + directory;
+
+        std::replace(name.begin(), name.end(), '/', '-');
+
+        const std::string archive = (archiveDirectory / (name + ".a")).string();
+        archives.push_back(archive);
+
+        std::vector<std::size_t> dependencies;
+        std::string reason;
+
+        const bool isOutdated = this->IsGroupOutdated(archive, members, queuedJobs, &dependencies, &reason);
+
+        bool membersChanged = false;
+        const std::string command = m_buildEngine->GetArchiveCommand(archive, members, membersChanged);
+
+        if (!isOutdated && membersChanged)
+            reason = "its objects changed (objects were added or removed)";
+
+        // Archives of directories where nothing changed are left alone
+        if (dependencies.empty() && !isOutdated && !membersChanged)
+        {
+            Logger::Debug("Skipping {} (up to date)", archive);
+            continue;
+        }
+
+        this->Explain(archive, reason);
+
+        Job job = { JobType::Archive, command, archive, archive, dependencies, m_buildEngine->GetCommandSignature(command, ""), "" };
+        job.temporaryOutput = BuildEngine::GetTemporaryPath(archive);
+        job.commandKey = m_buildState->AddCommand(m_buildEngine->GetCommandTemplate(command, "", archive, ""));
+
+        // The binary has to be linked again once an archive it links changes
+        m_queuedOutputs.emplace_back(archive, m_scheduler->AddJob(std::move(job)));
+    }
+
+    files = remainingFiles;
+    return archives;
+}
+
+std::vector<std::string> FileCompiler::QueueSharedLibraries(const fs::path& objPath, std::vector<std::string>& files, bool& commandsChanged)
+{
+    commandsChanged = false;
+
+    std::map<std::string, std::vector<std::string>> directories;
+    std::vector<std::string> remainingFiles;
+
+    // NOTE: Objects right in the object directory (sources right in a source directory, like 'main.cpp')
+    // stay in the binary, generated moc sources are compiled by the link of the binary as well
+    for (const auto& file : files)
+    {
+        const fs::path directory = fs::path(file).parent_path().lexically_relative(objPath.lexically_normal());
+
+        if (fs::path(file).extension() != ".o" || directory.empty() || directory == ".")
+        {
+            remainingFiles.push_back(file);
+            continue;
+        }
+
+        directories[directory.begin()->string()].push_back(file);
+    }
+
+    const std::map<std::string, std::size_t> queuedJobs = this->GetQueuedJobs();
+    std::vector<std::string> libraries;
+
+    for (const auto& [directory, members] : directories)
+    {
+        // 'src/net/...' is linked into 'bin/libnet.so'
+        const std::string library = fmt::format("{}/lib{}.so", m_config->directories.at("bin")[0], directory);
+        libraries.push_back(library);
+
+        std::vector<std::size_t> dependencies;
+        std::string reason;
+
+        const bool isOutdated = this->IsGroupOutdated(library, members, queuedJobs, &dependencies, &reason);
+
+        bool membersChanged = false;
+        const std::string command = m_buildEngine->GetSharedLibraryCommand(library, members, membersChanged);
+        const std::string signature = m_buildEngine->GetCommandSignature(command, "");
+        const std::string commandTemplate = m_buildEngine->GetCommandTemplate(command, "", library, "");
+
+        const BuildRecord* record = m_buildState->GetRecord(library);
+        const bool commandChanged = record == nullptr || record->signature != signature;
+
+        if (commandChanged)
+            commandsChanged = true;
+
+        if (m_options.rebuild)
+            reason = "everything is rebuilt ('--rebuild')";
+        else if (!isOutdated && membersChanged)
+            reason = "its objects changed (objects were added or removed)";
+        else if (!isOutdated && commandChanged)
+            reason = DescribeCommandChange(record != nullptr && !record->command.empty() ? m_buildState->GetCommand(record->command) : nullptr, commandTemplate);
+
+        // Libraries of directories where nothing changed are left alone
+        if (reason.empty())
+        {
+            Logger::Debug("Skipping {} (up to date)", library);
+            continue;
+        }
+
+        this->Explain(library, reason);
+
+        Job job = { JobType::Link, command, library, library, dependencies, signature, "" };
+        job.temporaryOutput = BuildEngine::GetTemporaryPath(library);
+        job.commandKey = m_buildState->AddCommand(commandTemplate);
+
+        m_scheduler->AddJob(std::move(job));
+    }
+
+    files = remainingFiles;
+    return libraries;
+}
+
+std::map<std::string, std::size_t> FileCompiler::GetQueuedJobs()
+{
+    std::map<std::string, std::size_t> queuedJobs;
+
+    for (const auto& [output, index] : m_queuedOutputs)
+        queuedJobs[fs::path(output).lexically_normal().string()] = index;
+
+    return queuedJobs;
+}
+
+bool FileCompiler::IsGroupOutdated(
+    const std::string& output,
+    const std::vector<std::string>& members,
+    const std::map<std::string, std::size_t>& queuedJobs,
+    std::vector<std::size_t>* dependencies,
+    std::string* reason
+)
+{
+    std::error_code error;
+    const auto outputLastModified = fs::last_write_time(output, error);
+
+    std::vector<std::string> queuedMembers;
+    std::string newerMember;
+
+    for (const auto& member : members)
+    {
+        if (queuedJobs.contains(member))
+        {
+            queuedMembers.push_back(member);
+
+            if (dependencies != nullptr)
+                dependencies->push_back(queuedJobs.at(member));
+
+            continue;
+        }
+
+        // A member can also be newer if the build that built it failed before the output was updated
+        std::error_code memberError;
+
+        if (!error && newerMember.empty() && this->GetOutputTime(member, memberError) > outputLastModified && !memberError)
+            newerMember = member;
+    }
+
+    if (!error && queuedMembers.empty() && newerMember.empty())
+        return false;
+
+    if (reason != nullptr)
+    {
+        if (error)
+            *reason = fmt::format("'{}' doesn't exist", output);
+        else if (queuedMembers.size() == 1)
+            *reason = fmt::format("'{}' is built again", queuedMembers.front());
+        else if (!queuedMembers.empty())
+            *reason = fmt::format("'{}' and {} other input(s) are built again", queuedMembers.front(), queuedMembers.size() - 1);
+        else
+            *reason = fmt::format("'{}' is newer than it (modification time)", newerMember);
+    }
+
+    return true;
+}
+
+fs::file_time_type FileCompiler::GetOutputTime(const std::string& output, std::error_code& error)
+{
+    const fs::file_time_type lastModified = fs::last_write_time(output, error);
+    const BuildRecord* record = m_buildState->GetRecord(output);
+
+    if (error || record == nullptr || record->placedTime == 0)
+        return lastModified;
+
+    return std::max(lastModified, fs::file_time_type(fs::file_time_type::duration(record->placedTime)));
+}
+
+std::string FileCompiler::FindNewerDependency(const std::string& depfile, fs::file_time_type outputLastModified)
+{
+    if (depfile.empty()) return "";
+
+    std::vector<std::string> dependencies;
+
+    // Without a dependency file there's no telling which headers the object was built from
+    if (!Depfile::Read(depfile, dependencies))
+    {
+        Logger::Debug("Dependency file '{}' is missing", depfile);
+        return fmt::format("its dependency file '{}' is missing, so the headers it includes aren't known", depfile);
+    }
+
+    for (const auto& dependency : dependencies)
+    {
+        std::error_code error;
+        const auto lastModified = fs::last_write_time(dependency, error);
+
+        // A header that was removed (or renamed) has to be looked for again
+        if (error || lastModified > outputLastModified)
+        {
+            Logger::Debug("Rebuilding '{}', '{}' changed", depfile, dependency);
+
+            if (error)
+                return fmt::format("header '{}' was removed", dependency);
+
+            return fmt::format("header '{}' is newer than its object (modification time)", dependency);
+        }
+    }
+
+    return "";
+}
+
+std::string FileCompiler::DescribeSourceChange(const std::string& source, const std::string& sourceHash, const BuildRecord* record)
+{
+    if (record == nullptr || record->sourceHash.empty() || sourceHash.empty())
+        return fmt::format("'{}' is newer than its output (modification time)", source);
+
+    if (record->sourceHash == sourceHash)
+        return fmt::format("'{}' is newer than its output, but its contents didn't change (modification time)", source);
+
+    return fmt::format("'{}' changed (contents)", source);
+}
+
+void FileCompiler::Explain(const std::string& name, const std::string& reason)
+{
+    if (!m_options.explain || reason.empty()) return;
+
+    Logger::Info("Explain: {}: {}", name, reason);
+}
+
+void FileCompiler::WriteMetrics(bool success)
+{
+    if (m_options.metricsPath.empty()) return;
+
+    m_metrics->SetSuccess(success);
+    m_metrics->Write(m_options.metricsPath);
+}
+
+std::string FileCompiler::GetRunBinary()
+{
+    const std::string& variant = m_options.variant;
+
+    if (variant.empty())
+        return m_output;
+
+    return VariantLauncher::GetBinaryName(fmt::format("{}/{}", m_config->directories.at("bin")[0], m_config->output), m_config->extension, variant);
+}
+
+void FileCompiler::CheckRunVariant()
+{
+    const std::string& variant = m_options.variant;
+
+    if (variant.empty())
+        return;
+
+    if (m_variants.front().empty())
+        Logger::Fatal("No variants are built, set 'variants' in the config to run '{}'", variant);
+
+    if (std::find(m_variants.begin(), m_variants.end(), variant) == m_variants.end())
+    {
+        std::string variants;
+
+        for (const auto& builtVariant : m_variants)
+            variants += (variants.empty() ? "" : ", ") + builtVariant;
+
+        Logger::Fatal("'{}' isn't one of the variants built ({})", variant, variants);
+    }
 }
 
 void FileCompiler::RunBinaryExecutable(const std::string& arguments)
 {
     Logger::Assert(!m_output.empty(), "Binary executable wasn't found when trying to run it. Something has gone wrong");
 
-    printf("\n");
+    const std::string binary = this->GetRunBinary();
+
+    Logger::Output("\n");
     if (arguments.empty())
         Logger::Info("Executing compiled binary...");
     else
-        Logger::Info(fmt::format("Executing binary with arguments: '{}'", arguments.substr(0, arguments.length() - 1)));
+        Logger::Info("Executing binary with arguments: '{}'", arguments.substr(0, arguments.length() - 1));
+
+    // The binary writes straight to the console, everything logged before has to be out first
+    Logger::Flush();
 
     try
     {
-        std::string command = fmt::format("./{} {}", m_output, arguments);
+        std::string command = fmt::format("./{} {}", binary, arguments);
 
         int platform = Platform::GetPlatform();
 
@@ -239,6 +1342,24 @@ void FileCompiler::RunBinaryExecutable(const std::string& arguments)
     catch (std::string command)
     {
         Logger::Error("Failed when running binary executable");
-        Logger::Fatal(fmt::format("Command: {}", command));
+        Logger::Fatal("Command: {}", command);
     }
 }
+
+void FileCompiler::BenchmarkBinaryExecutable(const std::string& arguments)
+{
+    Logger::Assert(!m_output.empty(), "Binary executable wasn't found when trying to benchmark it. Something has gone wrong");
+
+    Logger::Output("\n");
+
+    // The autorun arguments end with a space
+    std::string trimmedArguments = arguments;
+
+    if (!trimmedArguments.empty() && trimmedArguments.back() == ' ')
+        trimmedArguments.pop_back();
+
+    BenchmarkRunner runner(fmt::format("{}/benchmarks", ConfigConstants::STATE_DIRECTORY), m_options);
+
+    if (!runner.Run(this->GetRunBinary(), trimmedArguments))
+        Logger::Fatal("Failed when benchmarking binary executable");
+}
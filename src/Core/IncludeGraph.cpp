@@ -0,0 +1,146 @@
+#include "Core/IncludeGraph.hpp"
+#include "Utils/Depfile.hpp"
+#include "Utils/Logger/Logger.hpp"
+
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+void IncludeGraph::Load(const std::vector<std::string>& directories, const BuildState& buildState)
+{
+    m_units.clear();
+    m_dependents.clear();
+
+    // The records are keyed by the output as it was queued ('./obj/a.o'), the paths found here have no './'
+    std::map<std::string, std::uint64_t> durations;
+
+    for (const auto& [output, record] : buildState.GetRecords())
+        durations[GetKey(output)] = record.duration;
+
+    for (const auto& directory : directories)
+    {
+        std::error_code error;
+
+        if (!fs::is_directory(directory, error))
+            continue;
+
+        for (auto it = fs::recursive_directory_iterator(directory, error); it != fs::recursive_directory_iterator(); it.increment(error))
+        {
+            if (error) break;
+
+            const fs::path path = it->path();
+
+            if (path.extension() != ".d" || !it->is_regular_file())
+                continue;
+
+            std::vector<std::string> dependencies;
+
+            if (!Depfile::Read(path.string(), dependencies) || dependencies.empty())
+            {
+                Logger::Debug("Skipping dependency file '{}', it couldn't be read", path.string());
+                continue;
+            }
+
+            // The source always comes first, the compiler lists the headers after it
+            TranslationUnit unit;
+            unit.object = fs::path(path).replace_extension("o").lexically_normal().string();
+            unit.source = fs::path(dependencies.front()).lexically_normal().string();
+
+            for (std::size_t i = 1; i < dependencies.size(); i++)
+                unit.headers.push_back(fs::path(dependencies[i]).lexically_normal().string());
+
+            if (durations.contains(GetKey(unit.object)))
+                unit.duration = durations.at(GetKey(unit.object));
+
+            m_units.push_back(std::move(unit));
+        }
+    }
+
+    std::sort(m_units.begin(), m_units.end(), [](const auto& a, const auto& b) { return a.object < b.object; });
+
+    for (std::size_t i = 0; i < m_units.size(); i++)
+    {
+        for (const auto& header : m_units[i].headers)
+            m_dependents[GetKey(header)].push_back(i);
+    }
+
+    Logger::Debug("Read the includes of {} unit(s), {} header(s)", m_units.size(), m_dependents.size());
+}
+
+const TranslationUnit* IncludeGraph::FindUnit(const std::string& path) const
+{
+    const std::string key = GetKey(path);
+
+    for (const auto& unit : m_units)
+    {
+        if (GetKey(unit.source) == key || GetKey(unit.object) == key)
+            return &unit;
+    }
+
+    return nullptr;
+}
+
+std::vector<const TranslationUnit*> IncludeGraph::GetDependents(const std::string& header) const
+{
+    std::vector<const TranslationUnit*> units;
+
+    auto it = m_dependents.find(GetKey(header));
+    if (it == m_dependents.end()) return units;
+
+    for (std::size_t index : it->second)
+        units.push_back(&m_units[index]);
+
+    return units;
+}
+
+std::vector<HeaderUsage> IncludeGraph::GetHeaderUsages() const
+{
+    std::vector<HeaderUsage> usages;
+
+    for (const auto& [key, indices] : m_dependents)
+    {
+        HeaderUsage usage;
+
+        // Shown the way the compiler listed it in the first unit, which is usually relative to the project
+        const TranslationUnit& firstUnit = m_units[indices.front()];
+
+        for (const auto& header : firstUnit.headers)
+        {
+            if (GetKey(header) == key)
+            {
+                usage.header = header;
+                break;
+            }
+        }
+
+        for (std::size_t index : indices)
+        {
+            usage.units.push_back(&m_units[index]);
+            usage.cost += m_units[index].duration;
+        }
+
+        usages.push_back(std::move(usage));
+    }
+
+    std::sort(usages.begin(), usages.end(), [](const auto& a, const auto& b)
+    {
+        if (a.cost != b.cost)
+            return a.cost > b.cost;
+
+        if (a.units.size() != b.units.size())
+            return a.units.size() > b.units.size();
+
+        return a.header < b.header;
+    });
+
+    return usages;
+}
+
+std::string IncludeGraph::GetKey(const std::string& path)
+{
+    std::error_code error;
+    const fs::path absolutePath = fs::absolute(path, error);
+
+    return (error ? fs::path(path) : absolutePath).lexically_normal().string();
+}
@@ -0,0 +1,742 @@
+#include "Core/JobScheduler.hpp"
+#include "Utils/FileSystem.hpp"
+#include "Utils/Logger/Logger.hpp"
+#include "Utils/Process.hpp"
+#include "Utils/SystemResources.hpp"
+
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <map>
+#include <algorithm>
+#include <filesystem>
+
+namespace
+{
+    const std::map<JobType, BuildPhase> jobPhases = {
+        { JobType::Codegen, BuildPhase::Codegen },
+        { JobType::Compile, BuildPhase::Compile },
+        { JobType::Archive, BuildPhase::Link    },
+        { JobType::Link,    BuildPhase::Link    },
+        { JobType::Test,    BuildPhase::Test    },
+    };
+}
+
+JobScheduler::JobScheduler(
+    std::shared_ptr<BuildConfig> config,
+    const BuildOptions& options,
+    std::shared_ptr<BuildState> buildState,
+    std::shared_ptr<BuildMetrics> metrics,
+    std::shared_ptr<ObjectCache> cache
+)
+    : m_maxJobs(options.jobs), m_maxFailures(options.maxFailures), m_isRebuilding(options.rebuild), m_buildState(buildState), m_metrics(metrics), m_cache(cache)
+{
+    m_memoryHeadroom = SystemResources::ParseMemorySize(config->scheduler.at("memory_headroom"));
+
+    m_jobserver = Jobserver::Connect();
+
+    if (m_jobserver != nullptr) return;
+
+    if (m_maxJobs == 0)
+        m_maxJobs = SystemResources::GetCpuLimit();
+
+    m_jobserver = Jobserver::Create(m_maxJobs);
+}
+
+std::size_t JobScheduler::AddJob(Job job)
+{
+    const std::size_t index = m_jobs.size();
+
+    for (std::size_t dependency : job.dependencies)
+        Logger::Assert(dependency < index, "Job for '{}' depends on a job that wasn't added yet", job.source);
+
+    m_jobs.push_back(std::move(job));
+    return index;
+}
+
+bool JobScheduler::Run()
+{
+    if (m_jobs.empty()) return true;
+
+    m_dependents.assign(m_jobs.size(), {});
+    m_pendingDependencies.assign(m_jobs.size(), 0);
+
+    for (std::size_t i = 0; i < m_jobs.size(); i++)
+    {
+        for (std::size_t dependency : m_jobs[i].dependencies)
+        {
+            m_dependents[dependency].push_back(i);
+            m_pendingDependencies[i]++;
+        }
+    }
+
+    m_memoryBudget = SystemResources::GetAvailableMemory();
+    m_memoryReserved = 0;
+
+    // Jobs that were never built are expected to be like an average one
+    m_defaultMemory = m_buildState->GetAveragePeakMemory();
+    if (m_defaultMemory == 0)
+        m_defaultMemory = m_defaultJobMemory;
+
+    m_defaultDuration = m_buildState->GetAverageDuration();
+    if (m_defaultDuration == 0)
+        m_defaultDuration = m_defaultJobDuration;
+
+    CalculatePriorities();
+
+    m_failedBefore.assign(m_jobs.size(), false);
+
+    for (std::size_t i = 0; i < m_jobs.size(); i++)
+    {
+        const BuildRecord* record = m_buildState->GetRecord(m_jobs[i].output);
+        m_failedBefore[i] = record != nullptr && record->failed;
+    }
+
+    for (std::size_t i = 0; i < m_jobs.size(); i++)
+    {
+        if (m_pendingDependencies[i] == 0)
+            QueueJob(i);
+    }
+
+    Logger::Debug(
+        "Memory limit is {}, {} available, keeping {} free",
+        SystemResources::FormatMemorySize(SystemResources::GetMemoryLimit()),
+        SystemResources::FormatMemorySize(m_memoryBudget),
+        SystemResources::FormatMemorySize(m_memoryHeadroom)
+    );
+
+    if (m_maxJobs == 0)
+        Logger::Debug("Running {} job(s), limited by the jobserver", m_jobs.size());
+    else
+        Logger::Debug("Running {} job(s) with a limit of {}", m_jobs.size(), m_maxJobs);
+
+    Logger::Debug(
+        "Estimated critical path is {:.1f}s",
+        *std::max_element(m_priorities.begin(), m_priorities.end()) / 1000.0
+    );
+
+    // NOTE: Ctrl-C (or a CI timeout) only reaches kole, the jobs have process groups of their own,
+    // so the running jobs are stopped here and none of them leaves a partial output behind
+    m_interruptDescriptor = Process::CatchInterrupts();
+
+    while (true)
+    {
+        while (!IsStopped() && !m_readyJobs.empty())
+        {
+            auto next = PickNextJob();
+
+            if (next == m_readyJobs.end() || !AcquireSlot())
+                break;
+
+            const std::size_t index = *next;
+            m_readyJobs.erase(next);
+
+            StartJob(index);
+        }
+
+        UpdateStatus();
+
+        // Either everything is done, or too many jobs failed and the remaining ones were drained.
+        // Jobs depending on a failed job never become ready, so they don't keep the loop going.
+        if (m_runningJobs.empty() && m_lookupJobs.empty()) break;
+
+        const bool wantToken = !IsStopped() && !m_readyJobs.empty()
+            && (m_maxJobs == 0 || m_runningJobs.size() < m_maxJobs);
+
+        WaitForEvents(wantToken);
+
+        if (const int signal = Process::TakeInterrupt(); signal != 0)
+        {
+            StopRunningJobs(signal);
+            break;
+        }
+
+        KillTimedOutJobs();
+        ReapFinishedJobs();
+        ProcessCacheLookups();
+    }
+
+    Process::ReleaseInterrupts();
+    Logger::Status("");
+
+    if (m_interruptSignal != 0)
+        return false;
+
+    if (m_maxFailures != 1 && !m_failedJobs.empty())
+        PrintFailureSummary();
+
+    return m_failedJobs.empty();
+}
+
+void JobScheduler::CalculatePriorities()
+{
+    m_priorities.assign(m_jobs.size(), 0);
+
+    // Dependencies always come before their dependents, so going backwards
+    // every dependent already has its remaining path calculated
+    for (std::size_t i = m_jobs.size(); i-- > 0;)
+    {
+        std::uint64_t longestDependent = 0;
+
+        for (std::size_t dependent : m_dependents[i])
+            longestDependent = std::max(longestDependent, m_priorities[dependent]);
+
+        m_priorities[i] = GetExpectedDuration(i) + longestDependent;
+    }
+}
+
+std::set<std::size_t, JobScheduler::ReadyJobOrder>::iterator JobScheduler::PickNextJob()
+{
+    // The first job always runs, even if it's predicted to not fit
+    if (m_runningJobs.empty())
+        return m_readyJobs.begin();
+
+    const std::uint64_t availableMemory = SystemResources::GetAvailableMemory();
+
+    // If the most important job doesn't fit, a smaller one might still use the free memory
+    for (auto it = m_readyJobs.begin(); it != m_readyJobs.end(); ++it)
+    {
+        if (HasMemoryFor(*it, availableMemory))
+        {
+            m_memoryThrottled = false;
+            return it;
+        }
+    }
+
+    if (!m_memoryThrottled)
+    {
+        Logger::Debug(
+            "Holding back {} job(s) ({} free, {} reserved by {} running job(s))",
+            m_readyJobs.size(),
+            SystemResources::FormatMemorySize(availableMemory),
+            SystemResources::FormatMemorySize(m_memoryReserved),
+            m_runningJobs.size()
+        );
+    }
+
+    m_memoryThrottled = true;
+    return m_readyJobs.end();
+}
+
+bool JobScheduler::AcquireSlot()
+{
+    if (m_maxJobs != 0 && m_runningJobs.size() >= m_maxJobs)
+        return false;
+
+    // The first job always runs on the implicit token
+    if (m_runningJobs.empty())
+        return true;
+
+    if (m_jobserver == nullptr)
+        return true;
+
+    if (!m_jobserver->TryAcquire())
+        return false;
+
+    m_tokensHeld++;
+    return true;
+}
+
+void JobScheduler::ReleaseSlot()
+{
+    if (m_tokensHeld == 0) return;
+
+    m_jobserver->Release();
+    m_tokensHeld--;
+}
+
+bool JobScheduler::HasMemoryFor(std::size_t index, std::uint64_t availableMemory) const
+{
+    // Jobs that were just started haven't allocated their memory yet, so the free memory alone isn't enough.
+    // The predicted memory of every running job is reserved from what was free when the run started.
+    const bool fitsBudget = m_memoryReserved + GetExpectedMemory(index) + m_memoryHeadroom <= m_memoryBudget;
+
+    // Other processes (or jobs using more than predicted) can still eat into the free memory
+    const bool hasHeadroom = availableMemory >= m_memoryHeadroom;
+
+    return fitsBudget && hasHeadroom;
+}
+
+std::uint64_t JobScheduler::GetExpectedMemory(std::size_t index) const
+{
+    const BuildRecord* record = m_buildState->GetRecord(m_jobs[index].output);
+
+    if (record == nullptr || record->peakMemory == 0)
+        return m_defaultMemory;
+
+    return record->peakMemory;
+}
+
+std::uint64_t JobScheduler::GetExpectedDuration(std::size_t index) const
+{
+    const BuildRecord* record = m_buildState->GetRecord(m_jobs[index].output);
+
+    if (record == nullptr || record->duration == 0)
+        return m_defaultDuration;
+
+    return record->duration;
+}
+
+void JobScheduler::StartJob(std::size_t index)
+{
+    const Job& job = m_jobs[index];
+
+    Logger::Debug("Running '{}'", job.command);
+
+    // A killed build might have left the temporary output behind, and archives are added to rather than replaced.
+    // Outputs written in place might be linked from the object cache, writing to them would change the cache entry.
+    if (!job.temporaryOutput.empty())
+    {
+        std::error_code error;
+        std::filesystem::remove(job.temporaryOutput, error);
+    }
+    else
+    {
+        FileSystem::UnlinkIfShared(job.output);
+    }
+
+    int outputDescriptor = -1;
+    pid_t pid = Process::Spawn(job.command, &outputDescriptor, true);
+
+    if (pid < 0)
+    {
+        Logger::Error("Failed to start the job for '{}'", job.source);
+        Logger::Error("Command: {}", job.command);
+
+        ReleaseSlot();
+        m_failedJobs.push_back(index);
+        return;
+    }
+
+    const std::uint64_t expectedMemory = GetExpectedMemory(index);
+
+    m_memoryReserved += expectedMemory;
+    m_runningJobs.push_back({ index, pid, std::chrono::steady_clock::now(), expectedMemory, outputDescriptor, "" });
+    m_metrics->UpdateConcurrency(m_runningJobs.size());
+}
+
+void JobScheduler::WaitForEvents(bool wantToken)
+{
+    std::vector<pollfd> descriptors = {
+        { Process::GetChildSignalDescriptor(), POLLIN, 0 },
+    };
+
+    if (wantToken && m_jobserver != nullptr)
+        descriptors.push_back({ m_jobserver->GetReadDescriptor(), POLLIN, 0 });
+
+    if (!m_lookupJobs.empty())
+        descriptors.push_back({ m_cache->GetCompletionDescriptor(), POLLIN, 0 });
+
+    if (m_interruptDescriptor != -1)
+        descriptors.push_back({ m_interruptDescriptor, POLLIN, 0 });
+
+    for (const RunningJob& runningJob : m_runningJobs)
+    {
+        if (runningJob.outputDescriptor != -1)
+            descriptors.push_back({ runningJob.outputDescriptor, POLLIN, 0 });
+    }
+
+    // NOTE: The timeout is only a safety net, children exiting always wake up the poll.
+    // It also makes sure that jobs held back for memory are checked again every now and then.
+    poll(descriptors.data(), descriptors.size(), GetPollTimeout());
+
+    Process::DrainChildSignals();
+
+    // Children block once the pipe is full, so their output has to be read while they run
+    for (RunningJob& runningJob : m_runningJobs)
+    {
+        if (runningJob.outputDescriptor == -1) continue;
+
+        if (!Process::ReadAvailable(runningJob.outputDescriptor, runningJob.output))
+        {
+            close(runningJob.outputDescriptor);
+            runningJob.outputDescriptor = -1;
+        }
+    }
+}
+
+void JobScheduler::KillTimedOutJobs()
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    for (RunningJob& runningJob : m_runningJobs)
+    {
+        const Job& job = m_jobs[runningJob.index];
+
+        if (job.timeout == 0 || runningJob.isTimedOut) continue;
+
+        if (now - runningJob.startTime < std::chrono::milliseconds(job.timeout)) continue;
+
+        // NOTE: Everything the test started is killed with it, the job leads its own process group
+        Process::Kill(runningJob.pid, SIGKILL);
+        runningJob.isTimedOut = true;
+    }
+}
+
+int JobScheduler::GetPollTimeout() const
+{
+    const auto now = std::chrono::steady_clock::now();
+    std::int64_t timeout = 1000;
+
+    for (const RunningJob& runningJob : m_runningJobs)
+    {
+        const Job& job = m_jobs[runningJob.index];
+
+        if (job.timeout == 0 || runningJob.isTimedOut) continue;
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - runningJob.startTime).count();
+        timeout = std::min<std::int64_t>(timeout, std::max<std::int64_t>(static_cast<std::int64_t>(job.timeout) - elapsed, 0));
+    }
+
+    return static_cast<int>(timeout);
+}
+
+void JobScheduler::ReapFinishedJobs()
+{
+    for (auto it = m_runningJobs.begin(); it != m_runningJobs.end();)
+    {
+        Process::ProcessResult result;
+
+        if (!Process::TryWait(it->pid, result))
+        {
+            ++it;
+            continue;
+        }
+
+        const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - it->startTime);
+
+        const std::size_t index = it->index;
+        const Job& job = m_jobs[index];
+        const bool isTimedOut = it->isTimedOut;
+
+        m_memoryReserved -= it->expectedMemory;
+
+        // NOTE: Children of the job might still hold the pipe open, only what was written until now is taken
+        std::string output = std::move(it->output);
+
+        if (it->outputDescriptor != -1)
+        {
+            Process::ReadAvailable(it->outputDescriptor, output);
+            close(it->outputDescriptor);
+        }
+
+        it = m_runningJobs.erase(it);
+        m_finishedJobs++;
+        ReleaseSlot();
+
+        // The output is only replaced by a command that succeeded, a failed one leaves the previous output
+        if (!CommitOutput(job, result.exitCode == 0))
+            result.exitCode = 1;
+
+        // The record is kept even if the job failed, it's just as good of a prediction
+        const BuildRecord* previous = m_buildState->GetRecord(job.output);
+
+        BuildRecord record = previous != nullptr ? *previous : BuildRecord();
+        record.duration = std::max<std::uint64_t>(duration.count(), 1);
+
+        if (result.peakMemory > 0)
+            record.peakMemory = result.peakMemory;
+
+        record.userTime = result.userTime;
+        record.systemTime = result.systemTime;
+        record.blockInputs = result.blockInputs;
+        record.blockOutputs = result.blockOutputs;
+        record.voluntarySwitches = result.voluntarySwitches;
+        record.involuntarySwitches = result.involuntarySwitches;
+
+        record.failed = result.exitCode != 0;
+        m_buildState->SetRecord(job.output, record);
+
+        CommandMetrics command = { jobPhases.at(job.type), job.source, job.output, job.command };
+        command.duration = duration.count();
+        command.start = m_metrics->GetElapsed() - std::min<std::uint64_t>(command.duration, m_metrics->GetElapsed());
+        command.exitCode = result.exitCode;
+        command.peakMemory = result.peakMemory;
+        command.userTime = result.userTime;
+        command.systemTime = result.systemTime;
+        command.blockInputs = result.blockInputs;
+        command.blockOutputs = result.blockOutputs;
+        command.voluntarySwitches = result.voluntarySwitches;
+        command.involuntarySwitches = result.involuntarySwitches;
+
+        m_metrics->AddCommand(std::move(command));
+
+        if (result.exitCode != 0 && job.type == JobType::Test)
+        {
+            if (isTimedOut)
+                Logger::Error("Test {} timed out after {}s", job.source, job.timeout / 1000.0);
+            else
+                Logger::Error("Test {} failed with exit code {}", job.source, result.exitCode);
+
+            Logger::Output(output);
+
+            m_failedTests.push_back(index);
+            continue;
+        }
+
+        if (result.exitCode != 0)
+        {
+            if (job.type == JobType::Link)
+                Logger::Error("Failed when linking '{}'", job.output);
+            else if (job.type == JobType::Archive)
+                Logger::Error("Failed to archive '{}'", job.output);
+            else
+                Logger::Error("Failed to compile '{}'", job.source);
+
+            Logger::Error("Command: {}", job.command);
+            Logger::Output(output);
+
+            m_failedJobs.push_back(index);
+            continue;
+        }
+
+        // NOTE: Only a successful command is recorded, a failed one has to run again anyway
+        record.signature = job.signature;
+        record.command = job.commandKey;
+        record.sourceHash = job.sourceHash;
+        record.placedTime = 0;
+        m_buildState->SetRecord(job.output, record);
+
+        if (job.type == JobType::Link)
+            Logger::Info("[{}/{}] Linked {}", m_finishedJobs, m_jobs.size(), job.output);
+        else if (job.type == JobType::Archive)
+            Logger::Info("[{}/{}] Archived {}", m_finishedJobs, m_jobs.size(), job.output);
+        else if (job.type == JobType::Test)
+            Logger::Info("[{}/{}] Passed {} ({:.2f}s)", m_finishedJobs, m_jobs.size(), job.source, duration.count() / 1000.0);
+        else
+            Logger::Info("[{}/{}] Compiled {}", m_finishedJobs, m_jobs.size(), job.source);
+
+        // Warnings are shown right below the file they belong to, the output of a passed test isn't interesting
+        if (job.type != JobType::Test)
+            Logger::Output(output);
+
+        if (m_cache != nullptr && job.type == JobType::Compile && job.isCacheable && !job.depfile.empty())
+            m_cache->StartUpload(GetCacheRequest(index));
+
+        ReleaseDependents(index);
+    }
+}
+
+bool JobScheduler::CommitOutput(const Job& job, bool isSucceeded)
+{
+    if (job.temporaryOutput.empty()) return true;
+
+    std::error_code error;
+
+    if (!isSucceeded)
+    {
+        std::filesystem::remove(job.temporaryOutput, error);
+        return true;
+    }
+
+    // NOTE: Some tools succeed without writing anything (moc for a header without Q_OBJECT)
+    if (!std::filesystem::exists(job.temporaryOutput, error))
+        return true;
+
+    std::filesystem::rename(job.temporaryOutput, job.output, error);
+
+    if (error)
+    {
+        Logger::Error("Failed to move '{}' to '{}': {}", job.temporaryOutput, job.output, error.message());
+        std::filesystem::remove(job.temporaryOutput, error);
+
+        return false;
+    }
+
+    return true;
+}
+
+void JobScheduler::StopRunningJobs(int signal)
+{
+    m_interruptSignal = signal;
+
+    Logger::Status("");
+    Logger::Warning("Interrupted, stopping {} running job(s)", m_runningJobs.size());
+
+    for (const RunningJob& runningJob : m_runningJobs)
+        Process::Kill(runningJob.pid, SIGTERM);
+
+    // The jobs are waited for, so none of them writes its temporary output after it was removed
+    for (RunningJob& runningJob : m_runningJobs)
+    {
+        Process::ProcessResult result;
+        Process::Wait(runningJob.pid, result);
+
+        if (runningJob.outputDescriptor != -1)
+            close(runningJob.outputDescriptor);
+
+        CommitOutput(m_jobs[runningJob.index], false);
+
+        m_memoryReserved -= runningJob.expectedMemory;
+        ReleaseSlot();
+    }
+
+    m_runningJobs.clear();
+}
+
+bool JobScheduler::IsStopped() const
+{
+    return m_maxFailures != 0 && m_failedJobs.size() >= m_maxFailures;
+}
+
+void JobScheduler::PrintFailureSummary() const
+{
+    std::vector<bool> isFailed(m_jobs.size(), false);
+
+    for (std::size_t index : m_failedJobs)
+        isFailed[index] = true;
+
+    // Jobs that never became ready waited (directly or not) for a failed job, unless the build stopped first
+    std::size_t blockedJobs = 0;
+    std::size_t unstartedJobs = 0;
+
+    std::vector<bool> isBlocked(m_jobs.size(), false);
+
+    for (std::size_t i = 0; i < m_jobs.size(); i++)
+    {
+        for (std::size_t dependency : m_jobs[i].dependencies)
+        {
+            if (isFailed[dependency] || isBlocked[dependency])
+                isBlocked[i] = true;
+        }
+
+        if (isBlocked[i])
+            blockedJobs++;
+        else if (m_pendingDependencies[i] != 0 || m_readyJobs.contains(i))
+            unstartedJobs++;
+    }
+
+    Logger::Error("{} job(s) failed:", m_failedJobs.size());
+
+    for (std::size_t index : m_failedJobs)
+        Logger::Error("  {}", m_jobs[index].type == JobType::Compile || m_jobs[index].type == JobType::Codegen ? m_jobs[index].source : m_jobs[index].output);
+
+    if (blockedJobs > 0)
+        Logger::Error("{} job(s) didn't run because a job they depend on failed", blockedJobs);
+
+    if (unstartedJobs > 0)
+        Logger::Error("{} job(s) didn't run because the build stopped after {} failure(s)", unstartedJobs, m_failedJobs.size());
+}
+
+std::vector<std::string> JobScheduler::GetFailedTests() const
+{
+    std::vector<std::string> failedTests;
+
+    for (std::size_t index : m_failedTests)
+        failedTests.push_back(m_jobs[index].source);
+
+    return failedTests;
+}
+
+void JobScheduler::ProcessCacheLookups()
+{
+    if (m_cache == nullptr) return;
+
+    for (const CacheLookup& lookup : m_cache->TakeCompletedLookups())
+    {
+        const std::size_t index = lookup.id;
+        const Job& job = m_jobs[index];
+
+        m_lookupJobs.erase(index);
+
+        if (!lookup.isHit)
+        {
+            m_readyJobs.insert(index);
+            continue;
+        }
+
+        m_finishedJobs++;
+
+        // The cached object was built by the same command, so it's recorded like one built here
+        const BuildRecord* previous = m_buildState->GetRecord(job.output);
+
+        BuildRecord record = previous != nullptr ? *previous : BuildRecord();
+        record.signature = job.signature;
+        record.command = job.commandKey;
+        record.sourceHash = job.sourceHash;
+        record.placedTime = std::filesystem::file_time_type::clock::now().time_since_epoch().count();
+
+        m_buildState->SetRecord(job.output, record);
+        m_metrics->AddCachedUnit();
+
+        Logger::Info("[{}/{}] Fetched {} from the cache", m_finishedJobs, m_jobs.size(), job.source);
+
+        ReleaseDependents(index);
+    }
+}
+
+void JobScheduler::QueueJob(std::size_t index)
+{
+    const Job& job = m_jobs[index];
+
+    if (m_cache == nullptr || m_isRebuilding || job.type != JobType::Compile || !job.isCacheable || job.depfile.empty())
+    {
+        m_readyJobs.insert(index);
+        return;
+    }
+
+    m_lookupJobs.insert(index);
+    m_cache->StartLookup(GetCacheRequest(index));
+}
+
+void JobScheduler::ReleaseDependents(std::size_t index)
+{
+    for (std::size_t dependent : m_dependents[index])
+    {
+        if (--m_pendingDependencies[dependent] == 0)
+            QueueJob(dependent);
+    }
+}
+
+CacheRequest JobScheduler::GetCacheRequest(std::size_t index) const
+{
+    const Job& job = m_jobs[index];
+
+    return { index, job.signature, job.source, job.output, job.depfile };
+}
+
+void JobScheduler::UpdateStatus()
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    std::uint64_t remainingWork = 0;
+    std::uint64_t longestPath = 0;
+
+    std::vector<bool> isStarted(m_jobs.size(), false);
+
+    for (const RunningJob& runningJob : m_runningJobs)
+    {
+        const std::uint64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - runningJob.startTime).count();
+        const std::uint64_t expected = GetExpectedDuration(runningJob.index);
+
+        // Jobs running longer than predicted are assumed to be almost done
+        const std::uint64_t left = expected > elapsed ? expected - elapsed : 0;
+
+        remainingWork += left;
+        longestPath = std::max(longestPath, m_priorities[runningJob.index] - expected + left);
+
+        isStarted[runningJob.index] = true;
+    }
+
+    // Finished jobs never take part again, the jobs still waiting are the ones with unmet dependencies or ready ones
+    for (std::size_t i = 0; i < m_jobs.size(); i++)
+    {
+        const bool isWaiting = m_readyJobs.contains(i) || m_lookupJobs.contains(i);
+
+        if (isStarted[i] || (m_pendingDependencies[i] == 0 && !isWaiting)) continue;
+
+        remainingWork += GetExpectedDuration(i);
+        longestPath = std::max(longestPath, m_priorities[i]);
+    }
+
+    const std::size_t parallelism = std::max<std::size_t>(m_maxJobs != 0 ? m_maxJobs : m_runningJobs.size(), 1);
+    const std::uint64_t estimate = std::max(remainingWork / parallelism, longestPath);
+
+    std::string status = fmt::format("[{}/{}] {} running, about {}s left", m_finishedJobs, m_jobs.size(), m_runningJobs.size(), (estimate + 999) / 1000);
+
+    // The line only changes every now and then, no need to redraw it after every poll
+    if (status == m_status) return;
+
+    m_status = std::move(status);
+    Logger::Status(m_status);
+}
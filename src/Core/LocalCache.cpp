@@ -0,0 +1,478 @@
+#include "Core/LocalCache.hpp"
+#include "Utils/Compression.hpp"
+#include "Utils/FileSystem.hpp"
+#include "Utils/Hash.hpp"
+#include "Utils/Logger/Logger.hpp"
+#include "Utils/SystemResources.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <chrono>
+#include <thread>
+#include <map>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+
+namespace fs = std::filesystem;
+
+// NOTE: The index of every shard ('<shard>/index') is a log, only ever appended to between evictions:
+// put TAB <key> TAB <size> TAB <original size> TAB <time>
+// hit TAB <key> TAB <time>
+// The statistics ('stats') hold one 'name TAB value' line per counter.
+
+namespace
+{
+    const std::vector<std::string> statNames = {
+        "lookups",
+        "local_hits",
+        "remote_hits",
+        "evicted_entries",
+        "evicted_size",
+    };
+
+    // Holds an flock for as long as it lives
+    class FileLock
+    {
+    public:
+        FileLock(const std::string& path, bool wait)
+        {
+            m_descriptor = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (m_descriptor == -1) return;
+
+            if (flock(m_descriptor, wait ? LOCK_EX : LOCK_EX | LOCK_NB) == -1)
+            {
+                close(m_descriptor);
+                m_descriptor = -1;
+            }
+        }
+
+        ~FileLock()
+        {
+            if (m_descriptor != -1)
+                close(m_descriptor);
+        }
+
+        bool IsLocked() const { return m_descriptor != -1; }
+        int GetDescriptor() const { return m_descriptor; }
+
+    private:
+        int m_descriptor = -1;
+    };
+}
+
+LocalCache::LocalCache(std::string directory, std::uint64_t maxSize, std::optional<int> compressionLevel)
+    : m_directory(directory), m_maxSize(maxSize), m_compressionLevel(compressionLevel)
+{
+}
+
+std::unique_ptr<LocalCache> LocalCache::Create(std::shared_ptr<BuildConfig> config)
+{
+    const std::string& directory = config->cache.at("local");
+    if (directory.empty()) return nullptr;
+
+    const std::string& compressionLevel = config->cache.at("compression_level");
+
+    return std::make_unique<LocalCache>(
+        directory,
+        SystemResources::ParseMemorySize(config->cache.at("max_size")),
+        compressionLevel.empty() ? std::nullopt : std::optional<int>(std::stoi(compressionLevel))
+    );
+}
+
+bool LocalCache::Get(const std::string& key, std::string& data)
+{
+    const std::size_t shard = GetShardIndex(key);
+    const fs::path path = fs::path(GetShardDirectory(shard)) / key;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    const std::string compressed((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    // The entry was stored while compression was turned off
+    if (!Compression::IsCompressed(compressed))
+        data = compressed;
+    else if (!Compression::Decompress(compressed, data))
+    {
+        Logger::Warning("Removing the corrupted cache entry '{}'", path.string());
+
+        std::error_code error;
+        fs::remove(path, error);
+
+        return false;
+    }
+
+    AppendToIndex(shard, fmt::format("hit\t{}\t{}\n", key, GetCurrentTime()));
+    return true;
+}
+
+bool LocalCache::Put(const std::string& key, const std::string& data)
+{
+    std::string compressed;
+
+    if (!m_compressionLevel.has_value())
+        compressed = data;
+    else if (!Compression::Compress(data, *m_compressionLevel, compressed))
+        return false;
+
+    return Store(key, compressed, data.size());
+}
+
+bool LocalCache::Store(const std::string& key, const std::string& compressed, std::size_t originalSize)
+{
+    const std::size_t shard = GetShardIndex(key);
+    const fs::path path = fs::path(GetShardDirectory(shard)) / key;
+
+    std::error_code error;
+    fs::create_directories(path.parent_path(), error);
+
+    const std::size_t threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+    const fs::path temporaryPath = fmt::format("{}.{}.{:x}.tmp", path.string(), getpid(), threadId);
+
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    file.write(compressed.data(), compressed.size());
+    file.close();
+
+    // NOTE: Read-only, so a tool writing to a hard link of the entry fails instead of changing it
+    if (file)
+        fs::permissions(temporaryPath, fs::perms::owner_read | fs::perms::group_read | fs::perms::others_read, error);
+
+    // NOTE: An entry that's put again replaces the previous one, whose size is no longer taken up
+    std::error_code sizeError;
+    const std::uintmax_t replacedSize = fs::file_size(path, sizeError);
+
+    if (file && !error)
+        fs::rename(temporaryPath, path, error);
+
+    if (!file || error)
+    {
+        fs::remove(temporaryPath, error);
+        return false;
+    }
+
+    std::lock_guard lock(m_shards[shard].mutex);
+
+    if (!m_shards[shard].isLoaded)
+    {
+        for (const auto& [entryKey, entry] : ReadIndex(shard))
+            m_shards[shard].size += entry.size;
+
+        m_shards[shard].isLoaded = true;
+    }
+
+    if (!sizeError)
+        m_shards[shard].size -= std::min<std::uint64_t>(m_shards[shard].size, replacedSize);
+
+    AppendToIndex(shard, fmt::format("put\t{}\t{}\t{}\t{}\n", key, compressed.size(), originalSize, GetCurrentTime()));
+    m_shards[shard].size += compressed.size();
+
+    if (m_maxSize != 0 && m_shards[shard].size > m_maxSize / m_shardCount)
+        Evict(shard);
+
+    return true;
+}
+
+bool LocalCache::Place(const std::string& key, const std::string& destination)
+{
+    const std::size_t shard = GetShardIndex(key);
+    const std::string path = (fs::path(GetShardDirectory(shard)) / key).string();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    std::string header(4, '\0');
+    file.read(header.data(), header.size());
+    header.resize(file.gcount());
+
+    // NOTE: A hit on a compressed entry stores it uncompressed in its place, so every later hit is linked instead of copied.
+    // The entry then takes up its full size, which counts against the size limit like any other.
+    if (Compression::IsCompressed(header))
+    {
+        std::string compressed = header;
+        compressed.append((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        std::string data;
+
+        if (!Compression::Decompress(compressed, data) || !Store(key, data, data.size()))
+            return false;
+
+        Logger::Debug("Stored '{}' uncompressed, so it can be linked", key);
+    }
+
+    file.close();
+
+    FileSystem::PlacementMethod method;
+
+    if (!FileSystem::PlaceFile(path, destination, true, &method))
+        return false;
+
+    if (method == FileSystem::PlacementMethod::Copy)
+        Logger::Debug("Copied '{}' from the cache, it can't be linked", destination);
+
+    AppendToIndex(shard, fmt::format("hit\t{}\t{}\n", key, GetCurrentTime()));
+    return true;
+}
+
+void LocalCache::RecordStats(std::uint64_t lookups, std::uint64_t localHits, std::uint64_t remoteHits)
+{
+    const std::vector<std::uint64_t> increments = {
+        lookups,
+        localHits,
+        remoteHits,
+        m_evictedEntries.exchange(0),
+        m_evictedSize.exchange(0),
+    };
+
+    std::error_code error;
+    fs::create_directories(m_directory, error);
+
+    // NOTE: Builds finishing at the same time would otherwise overwrite each others' counts
+    const FileLock lock((fs::path(m_directory) / "stats").string(), true);
+    if (!lock.IsLocked()) return;
+
+    std::string text;
+    char buffer[4096];
+    ssize_t count;
+
+    while ((count = read(lock.GetDescriptor(), buffer, sizeof(buffer))) > 0)
+        text.append(buffer, count);
+
+    std::map<std::string, std::uint64_t> values;
+    std::istringstream stream(text);
+    std::string line;
+
+    while (std::getline(stream, line))
+    {
+        const std::size_t separator = line.find('\t');
+        if (separator == std::string::npos) continue;
+
+        values[line.substr(0, separator)] = std::strtoull(line.c_str() + separator + 1, nullptr, 10);
+    }
+
+    text.clear();
+
+    for (std::size_t i = 0; i < statNames.size(); i++)
+        text += fmt::format("{}\t{}\n", statNames[i], values[statNames[i]] + increments[i]);
+
+    if (ftruncate(lock.GetDescriptor(), 0) == -1 || pwrite(lock.GetDescriptor(), text.data(), text.size(), 0) != static_cast<ssize_t>(text.size()))
+        Logger::Debug("Failed to write the statistics of the cache");
+}
+
+LocalCacheStats LocalCache::GetStats()
+{
+    LocalCacheStats stats;
+
+    std::ifstream file(fs::path(m_directory) / "stats");
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        const std::size_t separator = line.find('\t');
+        if (separator == std::string::npos) continue;
+
+        const std::string name = line.substr(0, separator);
+        const std::uint64_t value = std::strtoull(line.c_str() + separator + 1, nullptr, 10);
+
+        if (name == "lookups") stats.lookups = value;
+        else if (name == "local_hits") stats.localHits = value;
+        else if (name == "remote_hits") stats.remoteHits = value;
+        else if (name == "evicted_entries") stats.evictedEntries = value;
+        else if (name == "evicted_size") stats.evictedSize = value;
+    }
+
+    for (std::size_t shard = 0; shard < m_shardCount; shard++)
+    {
+        for (const auto& [key, entry] : ReadIndex(shard))
+        {
+            stats.entries++;
+            stats.size += entry.size;
+            stats.originalSize += entry.originalSize;
+        }
+    }
+
+    return stats;
+}
+
+std::string LocalCache::GetDefaultDirectory()
+{
+    const char* cacheHome = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+
+    fs::path cacheDirectory;
+
+    if (cacheHome != nullptr && cacheHome[0] != '\0')
+        cacheDirectory = cacheHome;
+    else if (home != nullptr && home[0] != '\0')
+        cacheDirectory = fs::path(home) / ".cache";
+    else
+        cacheDirectory = fs::temp_directory_path();
+
+    return (cacheDirectory / "kole" / "objects").string();
+}
+
+std::size_t LocalCache::GetShardIndex(const std::string& key) const
+{
+    // Keys end with a hash ('objects/<hash>'), its first character is as random as it gets
+    const std::size_t separator = key.rfind('/');
+    const char c = separator != std::string::npos && separator + 1 < key.size() ? key[separator + 1] : '\0';
+
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+
+    return Hash::Fnv1a(key) % m_shardCount;
+}
+
+std::string LocalCache::GetShardDirectory(std::size_t shard) const
+{
+    return (fs::path(m_directory) / fmt::format("{:x}", shard)).string();
+}
+
+void LocalCache::AppendToIndex(std::size_t shard, const std::string& line)
+{
+    const std::string path = (fs::path(GetShardDirectory(shard)) / "index").string();
+
+    const int descriptor = open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (descriptor == -1) return;
+
+    if (write(descriptor, line.data(), line.size()) != static_cast<ssize_t>(line.size()))
+        Logger::Debug("Failed to append to '{}'", path);
+
+    close(descriptor);
+}
+
+std::unordered_map<std::string, LocalCache::IndexEntry> LocalCache::ReadIndex(std::size_t shard) const
+{
+    std::unordered_map<std::string, IndexEntry> entries;
+
+    std::ifstream file(fs::path(GetShardDirectory(shard)) / "index");
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+
+        std::string type;
+        std::string key;
+        std::getline(stream, type, '\t');
+        std::getline(stream, key, '\t');
+
+        if (type == "put")
+        {
+            IndexEntry entry;
+            stream >> entry.size >> entry.originalSize >> entry.lastAccess;
+
+            if (stream.fail()) continue;
+
+            entries[key] = entry;
+        }
+        else if (type == "hit")
+        {
+            std::uint64_t time = 0;
+            stream >> time;
+
+            auto it = entries.find(key);
+
+            if (it != entries.end())
+                it->second.lastAccess = std::max(it->second.lastAccess, time);
+        }
+    }
+
+    return entries;
+}
+
+void LocalCache::Evict(std::size_t shard)
+{
+    const fs::path shardDirectory = GetShardDirectory(shard);
+
+    // Another build is already evicting this shard
+    const FileLock lock((shardDirectory / "lock").string(), false);
+    if (!lock.IsLocked()) return;
+
+    std::unordered_map<std::string, IndexEntry> entries = ReadIndex(shard);
+
+    std::vector<std::pair<std::string, IndexEntry>> files;
+    std::error_code error;
+
+    for (auto it = fs::recursive_directory_iterator(shardDirectory, error); it != fs::recursive_directory_iterator(); it.increment(error))
+    {
+        if (error) break;
+        if (!it->is_regular_file(error)) continue;
+
+        const fs::path path = it->path();
+        const std::string key = path.lexically_relative(shardDirectory).generic_string();
+
+        if (key == "index" || key == "lock" || path.extension() == ".tmp") continue;
+
+        auto entry = entries.find(key);
+
+        if (entry != entries.end())
+        {
+            files.push_back(*entry);
+            continue;
+        }
+
+        IndexEntry missingEntry;
+        missingEntry.size = it->file_size(error);
+        missingEntry.originalSize = missingEntry.size;
+        missingEntry.lastAccess = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::file_clock::to_sys(it->last_write_time(error)).time_since_epoch()
+        ).count();
+
+        files.push_back({ key, missingEntry });
+    }
+
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.second.lastAccess < b.second.lastAccess; });
+
+    std::uint64_t size = 0;
+    for (const auto& [key, entry] : files)
+        size += entry.size;
+
+    const std::uint64_t targetSize = static_cast<std::uint64_t>(m_maxSize / m_shardCount * m_evictionTarget);
+
+    std::size_t evicted = 0;
+
+    while (evicted < files.size() && size > targetSize)
+    {
+        const auto& [key, entry] = files[evicted++];
+
+        fs::remove(shardDirectory / key, error);
+        size -= entry.size;
+
+        m_evictedEntries++;
+        m_evictedSize += entry.size;
+    }
+
+    Logger::Debug("Evicted {} entries from cache shard '{}', {} left", evicted, shardDirectory.string(), files.size() - evicted);
+
+    // The index only keeps the entries that are left, so it doesn't keep growing
+    const fs::path indexPath = shardDirectory / "index";
+    const fs::path temporaryPath = fmt::format("{}.{}.tmp", indexPath.string(), getpid());
+
+    std::ofstream file(temporaryPath, std::ios::trunc);
+    if (!file.is_open()) return;
+
+    for (std::size_t i = evicted; i < files.size(); i++)
+    {
+        const auto& [key, entry] = files[i];
+        file << fmt::format("put\t{}\t{}\t{}\t{}\n", key, entry.size, entry.originalSize, entry.lastAccess);
+    }
+
+    file.close();
+    fs::rename(temporaryPath, indexPath, error);
+
+    m_shards[shard].size = size;
+}
+
+std::uint64_t LocalCache::GetCurrentTime()
+{
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
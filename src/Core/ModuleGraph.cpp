@@ -0,0 +1,267 @@
+#include "Core/ModuleGraph.hpp"
+#include "Utils/FileSystem.hpp"
+#include "Utils/Hash.hpp"
+#include "Utils/Logger/Logger.hpp"
+#include "Utils/Process.hpp"
+
+#include <set>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// NOTE: The scans are a plain text file with one source per line:
+// <source> TAB <key>=<value> TAB <key>=<value> ...
+// Imports are separated by commas, which module names can't contain.
+
+void ModuleGraph::Load()
+{
+    m_records.clear();
+
+    std::ifstream file(m_cachePath);
+    if (!file.is_open()) return;
+
+    std::string line;
+    std::getline(file, line);
+
+    if (line != fmt::format("kole-modules {}", m_version))
+    {
+        Logger::Debug("Module scans are from a different version of kole. Ignoring...");
+        return;
+    }
+
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+
+        std::string source;
+        if (!std::getline(stream, source, '\t') || source.empty())
+            continue;
+
+        ScanRecord record;
+        std::string field;
+
+        while (std::getline(stream, field, '\t'))
+        {
+            const std::size_t separator = field.find('=');
+            if (separator == std::string::npos) continue;
+
+            const std::string key = field.substr(0, separator);
+            const std::string value = field.substr(separator + 1);
+
+            try
+            {
+                if (key == "modified")
+                    record.modified = std::stoll(value);
+                else if (key == "signature")
+                    record.signature = value;
+                else if (key == "provides")
+                    record.unit.provides = value;
+                else if (key == "interface")
+                    record.unit.isInterface = value == "1";
+                else if (key == "imports")
+                {
+                    std::istringstream imports(value);
+                    std::string name;
+
+                    while (std::getline(imports, name, ','))
+                        record.unit.imports.push_back(name);
+                }
+            }
+            catch (const std::exception&)
+            {
+                Logger::Debug("Invalid value '{}' for '{}' in the module scans", value, key);
+            }
+        }
+
+        m_records[source] = record;
+    }
+}
+
+void ModuleGraph::Save()
+{
+    if (!m_isChanged) return;
+
+    try
+    {
+        const fs::path cachePath = m_cachePath;
+        fs::create_directories(cachePath.parent_path());
+
+        // Write to a temporary file first, so an interrupted save doesn't lose the old scans
+        const fs::path temporaryPath = cachePath.string() + ".tmp";
+
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::Warning("Failed to open '{}' for writing the module scans", temporaryPath.string());
+            return;
+        }
+
+        file << fmt::format("kole-modules {}\n", m_version);
+
+        for (const auto& [source, record] : m_records)
+        {
+            std::string imports;
+
+            for (const auto& name : record.unit.imports)
+                imports += (imports.empty() ? "" : ",") + name;
+
+            file << source;
+            file << "\tmodified=" << record.modified;
+            file << "\tsignature=" << record.signature;
+            file << "\tprovides=" << record.unit.provides;
+            file << "\tinterface=" << (record.unit.isInterface ? 1 : 0);
+            file << "\timports=" << imports;
+            file << '\n';
+        }
+
+        file.close();
+        fs::rename(temporaryPath, cachePath);
+    }
+    catch (const std::exception& e)
+    {
+        Logger::Warning("Failed to save the module scans: {}", e.what());
+    }
+}
+
+const ModuleUnit& ModuleGraph::Scan(const std::string& source, const std::string& scanCommand, const std::string& scanOutput)
+{
+    std::error_code error;
+    const std::int64_t modified = fs::last_write_time(source, error).time_since_epoch().count();
+
+    const std::string signature = scanCommand.empty() ? "text" : Hash::ToHex(Hash::Fnv1a(scanCommand));
+
+    auto it = m_records.find(source);
+
+    if (it != m_records.end() && it->second.modified == modified && it->second.signature == signature)
+        return it->second.unit;
+
+    ScanRecord record = { modified, signature, {} };
+    bool isScanned = false;
+
+    if (!scanCommand.empty())
+    {
+        std::string output;
+        fs::create_directories(fs::path(scanOutput).parent_path());
+
+        if (Process::Run(scanCommand, output) == 0 && ModuleScanner::ReadP1689(scanOutput, record.unit))
+            isScanned = true;
+        else
+            Logger::Debug("Failed to scan '{}' with the compiler, reading its declarations instead: {}", source, output);
+
+        fs::remove(scanOutput, error);
+    }
+
+    if (!isScanned && !ModuleScanner::Scan(source, record.unit))
+        Logger::Warning("Failed to read '{}' for its module declarations", source);
+
+    Logger::Debug(
+        "Scanned '{}'{}{}",
+        source,
+        record.unit.provides.empty() ? "" : fmt::format(", provides '{}'", record.unit.provides),
+        record.unit.imports.empty() ? "" : fmt::format(", imports {} module(s)", record.unit.imports.size())
+    );
+
+    m_isChanged = true;
+    m_records[source] = std::move(record);
+
+    return m_records[source].unit;
+}
+
+bool ModuleGraph::Sort(const std::vector<std::string>& sources, std::vector<std::size_t>& order) const
+{
+    static const ModuleUnit emptyUnit;
+
+    auto GetUnit = [&](std::size_t index) -> const ModuleUnit&
+    {
+        auto it = m_records.find(sources[index]);
+        return it != m_records.end() ? it->second.unit : emptyUnit;
+    };
+
+    std::map<std::string, std::size_t> providers;
+
+    for (std::size_t i = 0; i < sources.size(); i++)
+    {
+        const ModuleUnit& unit = GetUnit(i);
+
+        if (unit.provides.empty()) continue;
+
+        if (providers.contains(unit.provides))
+            Logger::Warning("Module '{}' is provided by both '{}' and '{}'", unit.provides, sources[providers.at(unit.provides)], sources[i]);
+
+        providers[unit.provides] = i;
+    }
+
+    // NOTE: Kahn's algorithm, with the ready sources taken in their original order
+    std::vector<std::vector<std::size_t>> importers(sources.size());
+    std::vector<std::size_t> pendingImports(sources.size(), 0);
+
+    std::set<std::string> missingModules;
+
+    for (std::size_t i = 0; i < sources.size(); i++)
+    {
+        for (const auto& name : GetUnit(i).imports)
+        {
+            if (!providers.contains(name))
+            {
+                if (missingModules.insert(name).second)
+                    Logger::Warning("Module '{}' imported by '{}' isn't provided by any source", name, sources[i]);
+
+                continue;
+            }
+
+            const std::size_t provider = providers.at(name);
+            if (provider == i) continue;
+
+            importers[provider].push_back(i);
+            pendingImports[i]++;
+        }
+    }
+
+    std::set<std::size_t> ready;
+
+    for (std::size_t i = 0; i < sources.size(); i++)
+    {
+        if (pendingImports[i] == 0)
+            ready.insert(i);
+    }
+
+    order.clear();
+
+    while (!ready.empty())
+    {
+        const std::size_t index = *ready.begin();
+        ready.erase(ready.begin());
+
+        order.push_back(index);
+
+        for (std::size_t importer : importers[index])
+        {
+            if (--pendingImports[importer] == 0)
+                ready.insert(importer);
+        }
+    }
+
+    if (order.size() == sources.size())
+        return true;
+
+    for (std::size_t i = 0; i < sources.size(); i++)
+    {
+        if (pendingImports[i] != 0)
+            Logger::Error("'{}' is part of an import cycle", sources[i]);
+    }
+
+    return false;
+}
+
+void ModuleGraph::WriteMapper(const std::string& path, const std::map<std::string, std::string>& interfaces)
+{
+    std::string contents;
+
+    for (const auto& [name, interfacePath] : interfaces)
+        contents += fmt::format("{} {}\n", name, interfacePath);
+
+    if (!FileSystem::WriteFileIfChanged(path, contents))
+        Logger::Fatal("Failed to write module mapper '{}'", path);
+}
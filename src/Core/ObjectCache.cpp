@@ -0,0 +1,426 @@
+#include "Core/ObjectCache.hpp"
+#include "Utils/Depfile.hpp"
+#include "Utils/Hash.hpp"
+#include "Utils/Logger/Logger.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <iterator>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// NOTE: Manifests are plain text:
+// kole-manifest <version>
+// object TAB <hash>
+// dependency TAB <hash> TAB <path>   (one line per file the object was compiled from)
+
+namespace
+{
+    bool ReadFile(const std::string& path, std::string& data)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+
+        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+        return !file.bad();
+    }
+}
+
+ObjectCache::ObjectCache(std::unique_ptr<LocalCache> localCache, std::unique_ptr<CacheBackend> remoteCache, bool isUploading)
+    : m_localCache(std::move(localCache)), m_remoteCache(std::move(remoteCache)), m_isUploading(isUploading)
+{
+    if (pipe2(m_completionPipe, O_CLOEXEC | O_NONBLOCK) == -1)
+        Logger::Fatal("Failed to create the pipe of the object cache");
+
+    for (std::size_t i = 0; i < m_workerCount; i++)
+        m_workers.emplace_back(&ObjectCache::RunWorker, this);
+
+    if (m_localCache != nullptr)
+        Logger::Debug("Using the local object cache at '{}'", m_localCache->GetDescription());
+
+    if (m_remoteCache != nullptr)
+        Logger::Debug("Using the remote object cache at '{}'{}", m_remoteCache->GetDescription(), m_isUploading ? "" : " (read only)");
+}
+
+ObjectCache::~ObjectCache()
+{
+    Finish();
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_isStopping = true;
+    }
+
+    m_condition.notify_all();
+
+    for (std::thread& worker : m_workers)
+        worker.join();
+
+    close(m_completionPipe[0]);
+    close(m_completionPipe[1]);
+}
+
+void ObjectCache::StartLookup(CacheRequest request)
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_lookups.push_back(std::move(request));
+    }
+
+    m_condition.notify_all();
+}
+
+void ObjectCache::StartUpload(CacheRequest request)
+{
+    if (m_localCache == nullptr && !m_isUploading) return;
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_uploads.push_back(std::move(request));
+    }
+
+    m_condition.notify_all();
+}
+
+std::vector<CacheLookup> ObjectCache::TakeCompletedLookups()
+{
+    char buffer[256];
+    while (read(m_completionPipe[0], buffer, sizeof(buffer)) > 0);
+
+    std::lock_guard lock(m_mutex);
+    return std::exchange(m_completedLookups, {});
+}
+
+void ObjectCache::Finish()
+{
+    {
+        std::unique_lock lock(m_mutex);
+
+        const std::size_t remainingUploads = m_uploads.size() + m_activeUploads;
+
+        if (remainingUploads != 0)
+        {
+            Logger::Info("Waiting for {} upload(s) to the cache...", remainingUploads);
+            m_condition.wait(lock, [this] { return m_uploads.empty() && m_activeUploads == 0; });
+        }
+    }
+
+    if (m_localCache != nullptr)
+        m_localCache->RecordStats(m_lookupCount.exchange(0), m_localHits.exchange(0), m_remoteHits.exchange(0));
+}
+
+void ObjectCache::RunWorker()
+{
+    std::unique_lock lock(m_mutex);
+
+    while (true)
+    {
+        m_condition.wait(lock, [this] { return m_isStopping || !m_lookups.empty() || !m_uploads.empty(); });
+
+        if (!m_lookups.empty())
+        {
+            CacheRequest request = std::move(m_lookups.front());
+            m_lookups.pop_front();
+
+            lock.unlock();
+
+            bool isHit = false;
+
+            try
+            {
+                isHit = Lookup(request);
+            }
+            catch (const std::exception& e)
+            {
+                Logger::Debug("Cache lookup of '{}' failed: {}", request.source, e.what());
+            }
+
+            lock.lock();
+            m_completedLookups.push_back({ request.id, isHit });
+
+            // The pipe only wakes up the scheduler, if it's full there's already a wake up pending
+            [[maybe_unused]] const ssize_t written = write(m_completionPipe[1], "", 1);
+            continue;
+        }
+
+        if (!m_uploads.empty())
+        {
+            CacheRequest request = std::move(m_uploads.front());
+            m_uploads.pop_front();
+            m_activeUploads++;
+
+            lock.unlock();
+
+            try
+            {
+                Upload(request);
+            }
+            catch (const std::exception& e)
+            {
+                Logger::Debug("Cache upload of '{}' failed: {}", request.output, e.what());
+            }
+
+            lock.lock();
+            m_activeUploads--;
+
+            // Finish might be waiting for the last upload
+            m_condition.notify_all();
+            continue;
+        }
+
+        if (m_isStopping) return;
+    }
+}
+
+bool ObjectCache::Lookup(const CacheRequest& request)
+{
+    m_lookupCount++;
+
+    const std::string manifestKey = GetManifestKey(request);
+    if (manifestKey.empty()) return false;
+
+    Manifest manifest;
+    std::string object;
+
+    if (m_localCache != nullptr && FindManifest(*m_localCache, request, manifestKey, manifest))
+    {
+        // NOTE: The local cache checked the hash of the object when it was stored,
+        // so an uncompressed one is placed without reading it at all
+        if (WriteDepfile(request, manifest) && m_localCache->Place("objects/" + manifest.objectHash, request.output))
+        {
+            m_localHits++;
+            return true;
+        }
+
+        if (GetObject(*m_localCache, request, manifest, object) && WriteObject(request, manifest, object))
+        {
+            m_localHits++;
+            return true;
+        }
+    }
+
+    if (m_remoteCache == nullptr) return false;
+    if (!FindManifest(*m_remoteCache, request, manifestKey, manifest)) return false;
+    if (!GetObject(*m_remoteCache, request, manifest, object)) return false;
+
+    m_remoteHits++;
+
+    // The next build on this machine doesn't have to download it again
+    if (m_localCache != nullptr && m_localCache->Put("objects/" + manifest.objectHash, object))
+    {
+        m_localCache->Put("manifests/" + manifestKey, FormatManifest(manifest));
+
+        if (WriteDepfile(request, manifest) && m_localCache->Place("objects/" + manifest.objectHash, request.output))
+            return true;
+    }
+
+    return WriteObject(request, manifest, object);
+}
+
+bool ObjectCache::FindManifest(CacheBackend& cache, const CacheRequest& request, const std::string& manifestKey, Manifest& manifest)
+{
+    std::string data;
+    if (!cache.Get("manifests/" + manifestKey, data)) return false;
+
+    manifest = Manifest();
+
+    if (!ParseManifest(data, manifest))
+    {
+        Logger::Debug("Ignoring the invalid cache manifest of '{}' in '{}'", request.source, cache.GetDescription());
+        return false;
+    }
+
+    for (const Dependency& dependency : manifest.dependencies)
+    {
+        if (GetFileHash(dependency.path) != dependency.hash)
+        {
+            Logger::Debug("Cached object of '{}' was compiled with a different '{}'", request.source, dependency.path);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ObjectCache::GetObject(CacheBackend& cache, const CacheRequest& request, const Manifest& manifest, std::string& object)
+{
+    if (!cache.Get("objects/" + manifest.objectHash, object)) return false;
+
+    // NOTE: A truncated upload or a corrupted disk would otherwise be linked into the binary
+    if (Hash::Sha256(object) != manifest.objectHash)
+    {
+        Logger::Warning("Cached object of '{}' in '{}' doesn't match its hash, ignoring it", request.source, cache.GetDescription());
+        return false;
+    }
+
+    return true;
+}
+
+bool ObjectCache::WriteDepfile(const CacheRequest& request, const Manifest& manifest)
+{
+    std::vector<std::string> dependencies;
+    for (const Dependency& dependency : manifest.dependencies)
+        dependencies.push_back(dependency.path);
+
+    if (!Depfile::Write(request.depfile, request.output, dependencies))
+    {
+        Logger::Debug("Failed to write the dependency file of '{}'", request.source);
+        return false;
+    }
+
+    return true;
+}
+
+bool ObjectCache::WriteObject(const CacheRequest& request, const Manifest& manifest, const std::string& object)
+{
+    // The dependency file goes first, an object without one would be up to date no matter which header changes
+    if (!WriteDepfile(request, manifest) || !WriteFile(request.output, object))
+    {
+        Logger::Debug("Failed to write the cached object of '{}'", request.source);
+        return false;
+    }
+
+    return true;
+}
+
+void ObjectCache::Upload(const CacheRequest& request)
+{
+    const std::string manifestKey = GetManifestKey(request);
+    if (manifestKey.empty()) return;
+
+    std::vector<std::string> dependencies;
+
+    if (!Depfile::Read(request.depfile, dependencies))
+    {
+        Logger::Debug("Not uploading '{}', its dependency file couldn't be read", request.output);
+        return;
+    }
+
+    Manifest manifest;
+
+    for (const auto& path : dependencies)
+    {
+        const std::string hash = GetFileHash(path);
+        if (hash.empty()) return;
+
+        manifest.dependencies.push_back({ path, hash });
+    }
+
+    std::string object;
+    if (!ReadFile(request.output, object)) return;
+
+    manifest.objectHash = Hash::Sha256(object);
+
+    const std::string manifestData = FormatManifest(manifest);
+
+    // The object goes first, so a manifest never points to an object that isn't there
+    if (m_localCache != nullptr && m_localCache->Put("objects/" + manifest.objectHash, object))
+        m_localCache->Put("manifests/" + manifestKey, manifestData);
+
+    if (m_remoteCache == nullptr || !m_isUploading) return;
+
+    if (!m_remoteCache->Put("objects/" + manifest.objectHash, object)) return;
+    if (!m_remoteCache->Put("manifests/" + manifestKey, manifestData)) return;
+
+    Logger::Debug("Uploaded '{}' to the cache", request.output);
+}
+
+std::string ObjectCache::GetManifestKey(const CacheRequest& request)
+{
+    const std::string sourceHash = GetFileHash(request.source);
+    if (sourceHash.empty()) return "";
+
+    return Hash::Sha256(fmt::format("kole-cache {}\n{}\n{}\n{}", m_version, request.signature, request.source, sourceHash));
+}
+
+std::string ObjectCache::GetFileHash(const std::string& path)
+{
+    {
+        std::lock_guard lock(m_hashMutex);
+
+        auto it = m_fileHashes.find(path);
+        if (it != m_fileHashes.end()) return it->second;
+    }
+
+    // Hashed without the lock, two workers hashing the same header just do it twice
+    const std::string hash = Hash::Sha256File(path);
+
+    std::lock_guard lock(m_hashMutex);
+    m_fileHashes[path] = hash;
+
+    return hash;
+}
+
+bool ObjectCache::ParseManifest(const std::string& data, Manifest& manifest)
+{
+    std::istringstream stream(data);
+
+    std::string line;
+    std::getline(stream, line);
+
+    if (line != fmt::format("kole-manifest {}", m_version))
+        return false;
+
+    while (std::getline(stream, line))
+    {
+        std::istringstream lineStream(line);
+
+        std::string key;
+        std::getline(lineStream, key, '\t');
+
+        if (key == "object")
+        {
+            std::getline(lineStream, manifest.objectHash, '\t');
+        }
+        else if (key == "dependency")
+        {
+            Dependency dependency;
+            std::getline(lineStream, dependency.hash, '\t');
+            std::getline(lineStream, dependency.path);
+
+            manifest.dependencies.push_back(dependency);
+        }
+    }
+
+    return manifest.objectHash.length() == 64;
+}
+
+std::string ObjectCache::FormatManifest(const Manifest& manifest)
+{
+    std::string data = fmt::format("kole-manifest {}\n", m_version);
+    data += fmt::format("object\t{}\n", manifest.objectHash);
+
+    for (const Dependency& dependency : manifest.dependencies)
+        data += fmt::format("dependency\t{}\t{}\n", dependency.hash, dependency.path);
+
+    return data;
+}
+
+bool ObjectCache::WriteFile(const std::string& path, const std::string& data)
+{
+    const std::string temporaryPath = fmt::format("{}.{}.tmp", path, getpid());
+
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    file.write(data.data(), data.size());
+    file.close();
+
+    std::error_code error;
+
+    if (file)
+        fs::rename(temporaryPath, path, error);
+
+    if (!file || error)
+    {
+        fs::remove(temporaryPath, error);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,39 @@
+#include "Utils/Compression.hpp"
+
+#include <zstd.h>
+
+bool Compression::Compress(std::string_view data, int level, std::string& compressed)
+{
+    compressed.resize(ZSTD_compressBound(data.size()));
+
+    const std::size_t size = ZSTD_compress(compressed.data(), compressed.size(), data.data(), data.size(), level);
+
+    if (ZSTD_isError(size))
+        return false;
+
+    compressed.resize(size);
+    return true;
+}
+
+bool Compression::IsCompressed(std::string_view data)
+{
+    // The magic number is little-endian, like everything else in a frame
+    const unsigned char magic[] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+    return data.size() >= sizeof(magic) && data.substr(0, sizeof(magic)) == std::string_view(reinterpret_cast<const char*>(magic), sizeof(magic));
+}
+
+bool Compression::Decompress(std::string_view data, std::string& decompressed)
+{
+    // Compress always records the size in the frame, anything else wasn't written by kole
+    const unsigned long long size = ZSTD_getFrameContentSize(data.data(), data.size());
+
+    if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN)
+        return false;
+
+    decompressed.resize(size);
+
+    const std::size_t result = ZSTD_decompress(decompressed.data(), decompressed.size(), data.data(), data.size());
+
+    return !ZSTD_isError(result) && result == size;
+}
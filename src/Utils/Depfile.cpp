@@ -0,0 +1,139 @@
+#include "Utils/Depfile.hpp"
+
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+#include <filesystem>
+#include <fmt/core.h>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::string Escape(const std::string& path)
+    {
+        std::string escaped;
+
+        for (char c : path)
+        {
+            if (c == ' ' || c == '#' || c == '\\')
+                escaped += '\\';
+            else if (c == '$')
+                escaped += '$';
+
+            escaped += c;
+        }
+
+        return escaped;
+    }
+}
+
+bool Depfile::Read(const std::string& path, std::vector<std::string>& dependencies)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    dependencies.clear();
+
+    std::string word;
+    bool hasTarget = false;
+
+    auto EndWord = [&]()
+    {
+        if (word.empty()) return;
+
+        if (hasTarget)
+            dependencies.push_back(word);
+
+        word.clear();
+    };
+
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        const char c = text[i];
+
+        if (c == '\\' && i + 1 < text.size())
+        {
+            const char next = text[i + 1];
+
+            // A backslash at the end of a line continues the rule on the next one
+            if (next == '\n' || (next == '\r' && i + 2 < text.size() && text[i + 2] == '\n'))
+            {
+                EndWord();
+                i += next == '\r' ? 2 : 1;
+                continue;
+            }
+
+            if (next == ' ' || next == '#' || next == '\\')
+            {
+                word += next;
+                i++;
+                continue;
+            }
+        }
+
+        if (c == '$' && i + 1 < text.size() && text[i + 1] == '$')
+        {
+            word += '$';
+            i++;
+            continue;
+        }
+
+        // The target ends at the first colon followed by whitespace (so 'C:/path' on Windows isn't split)
+        if (!hasTarget && c == ':' && (i + 1 == text.size() || isspace(static_cast<unsigned char>(text[i + 1]))))
+        {
+            word.clear();
+            hasTarget = true;
+            continue;
+        }
+
+        if (c == '\n' && hasTarget)
+        {
+            // Only the first rule is read, '-MP' adds empty rules for every header after it
+            EndWord();
+            break;
+        }
+
+        if (isspace(static_cast<unsigned char>(c)))
+        {
+            EndWord();
+            continue;
+        }
+
+        word += c;
+    }
+
+    EndWord();
+
+    return hasTarget;
+}
+
+bool Depfile::Write(const std::string& path, const std::string& target, const std::vector<std::string>& dependencies)
+{
+    const std::string temporaryPath = fmt::format("{}.{}.tmp", path, getpid());
+
+    std::ofstream file(temporaryPath, std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    file << Escape(target) << ':';
+
+    for (const auto& dependency : dependencies)
+        file << " \\\n  " << Escape(dependency);
+
+    file << '\n';
+    file.close();
+
+    std::error_code error;
+    fs::rename(temporaryPath, path, error);
+
+    if (error)
+    {
+        fs::remove(temporaryPath, error);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,176 @@
+#include "Utils/FileSystem.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <cerrno>
+#include <thread>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <functional>
+#include <filesystem>
+#include <fmt/core.h>
+
+namespace
+{
+    bool CopyData(int sourceDescriptor, int destinationDescriptor)
+    {
+        // copy_file_range keeps the data in the kernel, and some filesystems share it instead of copying
+        while (true)
+        {
+            const ssize_t count = copy_file_range(sourceDescriptor, nullptr, destinationDescriptor, nullptr, 1 << 30, 0);
+
+            if (count == 0) return true;
+            if (count > 0) continue;
+            if (errno == EINTR) continue;
+
+            // Not supported between these files, the data has to go through userspace
+            if (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP) break;
+
+            return false;
+        }
+
+        char buffer[65536];
+
+        while (true)
+        {
+            const ssize_t count = read(sourceDescriptor, buffer, sizeof(buffer));
+
+            if (count == 0) return true;
+
+            if (count < 0)
+            {
+                if (errno == EINTR) continue;
+                return false;
+            }
+
+            for (ssize_t written = 0; written < count;)
+            {
+                const ssize_t result = write(destinationDescriptor, buffer + written, count - written);
+
+                if (result < 0)
+                {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+
+                written += result;
+            }
+        }
+    }
+}
+
+bool FileSystem::PlaceFile(const std::string& source, const std::string& destination, bool allowHardlink, PlacementMethod* method)
+{
+    const std::size_t threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+    const std::string temporaryPath = fmt::format("{}.{}.{:x}.tmp", destination, getpid(), threadId);
+
+    const int sourceDescriptor = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (sourceDescriptor == -1) return false;
+
+    PlacementMethod placementMethod = PlacementMethod::Copy;
+    bool isPlaced = false;
+
+    unlink(temporaryPath.c_str());
+
+    int destinationDescriptor = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+
+    if (destinationDescriptor != -1 && ioctl(destinationDescriptor, FICLONE, sourceDescriptor) == 0)
+    {
+        placementMethod = PlacementMethod::Reflink;
+        isPlaced = true;
+    }
+
+    if (!isPlaced && allowHardlink)
+    {
+        if (destinationDescriptor != -1)
+        {
+            close(destinationDescriptor);
+            destinationDescriptor = -1;
+            unlink(temporaryPath.c_str());
+        }
+
+        if (link(source.c_str(), temporaryPath.c_str()) == 0)
+        {
+            placementMethod = PlacementMethod::Hardlink;
+            isPlaced = true;
+        }
+    }
+
+    if (!isPlaced)
+    {
+        if (destinationDescriptor == -1)
+            destinationDescriptor = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+        isPlaced = destinationDescriptor != -1 && CopyData(sourceDescriptor, destinationDescriptor);
+    }
+
+    if (destinationDescriptor != -1)
+        close(destinationDescriptor);
+
+    close(sourceDescriptor);
+
+    if (!isPlaced || rename(temporaryPath.c_str(), destination.c_str()) != 0)
+    {
+        unlink(temporaryPath.c_str());
+        return false;
+    }
+
+    if (method != nullptr)
+        *method = placementMethod;
+
+    return true;
+}
+
+void FileSystem::UnlinkIfShared(const std::string& path)
+{
+    struct stat status;
+
+    if (stat(path.c_str(), &status) == 0 && S_ISREG(status.st_mode) && status.st_nlink > 1)
+        unlink(path.c_str());
+}
+
+bool FileSystem::WriteFileIfChanged(const std::string& path, const std::string& contents, bool* isWritten)
+{
+    if (isWritten != nullptr)
+        *isWritten = false;
+
+    {
+        std::ifstream existingFile(path, std::ios::binary);
+        const std::string existing((std::istreambuf_iterator<char>(existingFile)), std::istreambuf_iterator<char>());
+
+        if (existingFile.is_open() && existing == contents)
+            return true;
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+    // Another process (or thread) may be writing the same file, every writer gets its own temporary name
+    const std::size_t threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+    const std::string temporaryPath = fmt::format("{}.{}.{:x}.tmp", path, getpid(), threadId);
+
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+
+        if (!file.is_open() || !(file << contents).flush())
+        {
+            unlink(temporaryPath.c_str());
+            return false;
+        }
+    }
+
+    if (rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        unlink(temporaryPath.c_str());
+        return false;
+    }
+
+    if (isWritten != nullptr)
+        *isWritten = true;
+
+    return true;
+}
@@ -1,4 +1,10 @@
 #include "Utils/FlagManager.hpp"
+#include "Utils/RegexHelper.hpp"
+
+#include <unistd.h>
+#include <filesystem>
+
+namespace fs = std::filesystem;
 
 std::string FlagManager::GetFlags()
 {
@@ -6,13 +12,9 @@ std::string FlagManager::GetFlags()
 
     Logger::Debug("Generating flags for the first time...");
 
-    const std::string optimization = GetOptimization();
-    const std::string commonFlags = m_config->flags.at("common");
-    const std::string platformFlags = GetPlatformFlags();
-
-    m_flags = fmt::format("{} {} {}", optimization, commonFlags, platformFlags);
+    m_flags = ComposeFlags(m_config->optimization, m_config->flags.at("common"));
 
-    Logger::Debug(fmt::format("Generated flags: '{}'", m_flags));
+    Logger::Debug("Generated flags: '{}'", m_flags);
 
     return m_flags;
 }
@@ -28,36 +30,119 @@ std::string FlagManager::GetIncludePaths()
 
     // Add directories holding compiled ui files to include paths
     if (m_config->qtSupport.at("compile_ui") == ConfigConstants::TRUE)
-        m_includePaths += " -I{}" + m_config->qtSupport.at("ui_output_dir");
+        m_includePaths += " -I" + m_config->qtSupport.at("ui_output_dir");
+
+    // The project includes the headers of its dependencies, which are built on their own
+    for (const auto& [name, dependency] : m_config->dependencies)
+    {
+        for (const auto& includeDir : dependency.include)
+            m_includePaths += " -I" + (fs::path(dependency.path) / includeDir).lexically_normal().string();
+    }
 
-    Logger::Debug(fmt::format("Include paths are '{}'", m_includePaths));
+    Logger::Debug("Include paths are '{}'", m_includePaths);
 
     return m_includePaths;
 }
 
-std::string FlagManager::GetOptimization()
+std::string FlagManager::GetFlags(const std::string& source)
+{
+    if (m_config->overrides.empty()) return GetFlags();
+
+    // NOTE: A directory pattern matches everything in it, so the parents of the source are matched as well
+    std::vector<std::size_t> matches;
+
+    for (std::size_t i = 0; i < m_config->overrides.size(); i++)
+    {
+        for (fs::path path = fs::path(source).lexically_normal(); !path.empty() && path != path.root_path(); path = path.parent_path())
+        {
+            if (RegexHelper::MatchesRegex(path, m_config->overrides[i].match))
+            {
+                matches.push_back(i);
+                break;
+            }
+        }
+    }
+
+    if (matches.empty()) return GetFlags();
+
+    auto it = m_overrideFlags.find(matches);
+    if (it != m_overrideFlags.end()) return it->second;
+
+    // Later overrides win over earlier ones, like they would if their flags were given later
+    std::string optimizationLevel = m_config->optimization;
+    std::string commonFlags = m_config->flags.at("common");
+
+    for (std::size_t index : matches)
+    {
+        const FlagOverride& flagOverride = m_config->overrides[index];
+
+        if (!flagOverride.optimization.empty())
+            optimizationLevel = flagOverride.optimization;
+
+        if (flagOverride.replaceFlags)
+            commonFlags = flagOverride.flags;
+        else if (!flagOverride.flags.empty())
+            commonFlags += " " + flagOverride.flags;
+    }
+
+    const std::string flags = ComposeFlags(optimizationLevel, commonFlags);
+
+    Logger::Debug("Generated flags for '{}' (matching {} override(s)): '{}'", source, matches.size(), flags);
+
+    m_overrideFlags[matches] = flags;
+    return flags;
+}
+
+std::string FlagManager::ComposeFlags(const std::string& optimizationLevel, const std::string& commonFlags)
+{
+    std::string flags = fmt::format("{} {} {}", GetOptimization(optimizationLevel), commonFlags, GetPlatformFlags());
+
+    // Objects linked into shared libraries have to be position independent
+    if (m_config->link.at("dev_shared") == ConfigConstants::TRUE)
+        flags += " -fPIC";
+
+    return flags;
+}
+
+std::string FlagManager::GetOptimization(const std::string& level)
 {
     // Set default optimization to 'debug'
     std::string optimization = m_optimizationLevels.at("debug");
 
-    std::string optimizationLowercase = m_config->optimization;
+    std::string optimizationLowercase = level;
     transform(optimizationLowercase.begin(), optimizationLowercase.end(), optimizationLowercase.begin(), ::tolower);
 
     // Check if user-given optimization is valid and present in optimizations map
     if (m_optimizationLevels.find(optimizationLowercase) != m_optimizationLevels.end())
     {
         optimization = m_optimizationLevels.at(optimizationLowercase);
-        Logger::Debug(fmt::format("Setting optimization level to '{}' ({})", optimizationLowercase, optimization));
+        Logger::Debug("Setting optimization level to '{}' ({})", optimizationLowercase, optimization);
     }
     else
     {
-        Logger::Warning(fmt::format("Optimization level '{}' not recognized", optimizationLowercase));
+        Logger::Warning("Optimization level '{}' not recognized", optimizationLowercase);
         Logger::Debug("Defaulting to debug optimization level");
     }
 
     return optimization;
 }
 
+std::string FlagManager::GetDiagnosticFlags()
+{
+    if (m_diagnosticFlags.has_value()) return m_diagnosticFlags.value();
+
+    m_diagnosticFlags = "";
+
+    // The user's own choice wins
+    if (GetFlags().find("diagnostics-color") != std::string::npos)
+        return "";
+
+    if (isatty(STDOUT_FILENO) && m_compiler->SupportsOption("-fdiagnostics-color=always"))
+        m_diagnosticFlags = "-fdiagnostics-color=always";
+
+    return m_diagnosticFlags.value();
+}
+
 std::string FlagManager::GetPlatformFlags()
 {
     std::string platformName = Platform::GetPlatformName();
@@ -65,11 +150,11 @@ std::string FlagManager::GetPlatformFlags()
 
     if (m_config->flags.contains(platformName))
     {
-        return m_config->flags.at(platformName);
+        return ProcessPlatformFlags(m_config->flags.at(platformName));
     }
     else
     {
-        Logger::Warning(fmt::format("Configuration for platform '{}' was not found", platformName));
+        Logger::Warning("Configuration for platform '{}' was not found", platformName);
         Logger::Info("Applying only common (platform-independent) flags");
     }
 
@@ -79,8 +164,10 @@ std::string FlagManager::GetPlatformFlags()
 std::string FlagManager::ProcessPlatformFlags(const std::string& flags)
 {
     const char special = '$';
-    std::string pkg = "`pkg-config --libs --cflags`";
+    std::vector<std::string> packages;
 
+    // NOTE: Packages ('$qt5') used to be passed to the shell as a `pkg-config` substitution,
+    // which ran pkg-config again for every single command. They're resolved once here instead.
     std::string newFlags = "";
     for (std::size_t i = 0; i < flags.length(); i++)
     {
@@ -91,17 +178,28 @@ std::string FlagManager::ProcessPlatformFlags(const std::string& flags)
             std::size_t end = flags.find(' ', start);
             if (end == std::string::npos)
                 end = flags.length();
-            
-            std::string flag = flags.substr(start, end - start);
 
-            pkg.insert(pkg.length() - 1, ' ' + flag);
+            std::string package = flags.substr(start, end - start);
 
-            i += end - start + 1;
+            if (!package.empty())
+                packages.push_back(package);
+
+            i = end;
             continue;
         }
 
         newFlags += flags[i];
     }
 
-    return newFlags + ' ' + pkg;
+    if (packages.empty())
+        return newFlags;
+
+    std::string packageFlags;
+    if (!m_packageConfig->Resolve(packages, packageFlags))
+    {
+        Logger::Warning("Building without the flags of the packages");
+        return newFlags;
+    }
+
+    return newFlags + ' ' + packageFlags;
 }
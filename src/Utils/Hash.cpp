@@ -0,0 +1,136 @@
+#include "Utils/Hash.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <fmt/core.h>
+
+std::uint64_t Hash::Fnv1a(std::string_view data, std::uint64_t seed)
+{
+    std::uint64_t hash = seed;
+
+    for (unsigned char c : data)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+std::string Hash::ToHex(std::uint64_t hash)
+{
+    return fmt::format("{:016x}", hash);
+}
+
+namespace
+{
+    constexpr std::uint32_t sha256Constants[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    std::uint32_t RotateRight(std::uint32_t value, int count)
+    {
+        return (value >> count) | (value << (32 - count));
+    }
+
+    void ProcessSha256Block(std::uint32_t state[8], const unsigned char* block)
+    {
+        std::uint32_t words[64];
+
+        for (int i = 0; i < 16; i++)
+        {
+            words[i] = (std::uint32_t(block[i * 4]) << 24) | (std::uint32_t(block[i * 4 + 1]) << 16)
+                | (std::uint32_t(block[i * 4 + 2]) << 8) | std::uint32_t(block[i * 4 + 3]);
+        }
+
+        for (int i = 16; i < 64; i++)
+        {
+            const std::uint32_t s0 = RotateRight(words[i - 15], 7) ^ RotateRight(words[i - 15], 18) ^ (words[i - 15] >> 3);
+            const std::uint32_t s1 = RotateRight(words[i - 2], 17) ^ RotateRight(words[i - 2], 19) ^ (words[i - 2] >> 10);
+
+            words[i] = words[i - 16] + s0 + words[i - 7] + s1;
+        }
+
+        std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int i = 0; i < 64; i++)
+        {
+            const std::uint32_t s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+            const std::uint32_t choice = (e & f) ^ (~e & g);
+            const std::uint32_t temp1 = h + s1 + choice + sha256Constants[i] + words[i];
+
+            const std::uint32_t s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+            const std::uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+            const std::uint32_t temp2 = s0 + majority;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+std::string Hash::Sha256(std::string_view data)
+{
+    std::uint32_t state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    const std::size_t fullBlocks = data.size() / 64;
+
+    for (std::size_t i = 0; i < fullBlocks; i++)
+        ProcessSha256Block(state, reinterpret_cast<const unsigned char*>(data.data()) + i * 64);
+
+    // The last block(s) hold the rest of the data, a 1 bit, zeros and the length in bits
+    unsigned char tail[128] = {};
+    const std::size_t rest = data.size() - fullBlocks * 64;
+
+    std::copy(data.begin() + fullBlocks * 64, data.end(), tail);
+    tail[rest] = 0x80;
+
+    const std::size_t tailLength = rest < 56 ? 64 : 128;
+    const std::uint64_t bitLength = static_cast<std::uint64_t>(data.size()) * 8;
+
+    for (int i = 0; i < 8; i++)
+        tail[tailLength - 1 - i] = static_cast<unsigned char>(bitLength >> (i * 8));
+
+    for (std::size_t offset = 0; offset < tailLength; offset += 64)
+        ProcessSha256Block(state, tail + offset);
+
+    std::string hash;
+    hash.reserve(64);
+
+    for (std::uint32_t word : state)
+        hash += fmt::format("{:08x}", word);
+
+    return hash;
+}
+
+std::string Hash::Sha256File(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return "";
+
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (file.bad()) return "";
+
+    return Sha256(data);
+}
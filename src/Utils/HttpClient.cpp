@@ -0,0 +1,252 @@
+#include "Utils/HttpClient.hpp"
+#include "Utils/Logger/Logger.hpp"
+
+#include <poll.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+#include <sys/socket.h>
+
+namespace
+{
+    struct Url
+    {
+        std::string host;
+        std::string port = "80";
+        std::string path = "/";
+    };
+
+    bool ParseUrl(const std::string& text, Url& url)
+    {
+        const std::string scheme = "http://";
+        if (text.rfind(scheme, 0) != 0) return false;
+
+        const std::size_t hostStart = scheme.length();
+        const std::size_t pathStart = text.find('/', hostStart);
+
+        const std::string authority = text.substr(hostStart, pathStart - hostStart);
+
+        if (pathStart != std::string::npos)
+            url.path = text.substr(pathStart);
+
+        const std::size_t portStart = authority.rfind(':');
+
+        if (portStart != std::string::npos)
+        {
+            url.host = authority.substr(0, portStart);
+            url.port = authority.substr(portStart + 1);
+        }
+        else
+        {
+            url.host = authority;
+        }
+
+        return !url.host.empty() && !url.port.empty();
+    }
+
+    // Connects without blocking longer than the timeout, an unreachable server would otherwise stall the build for minutes
+    int Connect(const Url& url, int timeout)
+    {
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo* addresses = nullptr;
+
+        if (getaddrinfo(url.host.c_str(), url.port.c_str(), &hints, &addresses) != 0)
+            return -1;
+
+        int descriptor = -1;
+
+        for (addrinfo* address = addresses; address != nullptr; address = address->ai_next)
+        {
+            descriptor = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK, address->ai_protocol);
+            if (descriptor == -1) continue;
+
+            if (connect(descriptor, address->ai_addr, address->ai_addrlen) == 0)
+                break;
+
+            if (errno == EINPROGRESS)
+            {
+                pollfd pollDescriptor = { descriptor, POLLOUT, 0 };
+
+                int error = 0;
+                socklen_t length = sizeof(error);
+
+                if (poll(&pollDescriptor, 1, timeout) == 1
+                    && getsockopt(descriptor, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0)
+                    break;
+            }
+
+            close(descriptor);
+            descriptor = -1;
+        }
+
+        freeaddrinfo(addresses);
+        return descriptor;
+    }
+
+    bool SendAll(int descriptor, const std::string& data, int timeout)
+    {
+        std::size_t sent = 0;
+
+        while (sent < data.size())
+        {
+            const ssize_t count = send(descriptor, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+
+            if (count > 0)
+            {
+                sent += count;
+                continue;
+            }
+
+            if (count == -1 && errno == EINTR) continue;
+            if (count == -1 && errno != EAGAIN && errno != EWOULDBLOCK) return false;
+
+            pollfd pollDescriptor = { descriptor, POLLOUT, 0 };
+            if (poll(&pollDescriptor, 1, timeout) != 1) return false;
+        }
+
+        return true;
+    }
+
+    bool ReceiveAll(int descriptor, std::string& data, int timeout)
+    {
+        char buffer[65536];
+
+        while (true)
+        {
+            const ssize_t count = recv(descriptor, buffer, sizeof(buffer), 0);
+
+            if (count > 0)
+            {
+                data.append(buffer, count);
+                continue;
+            }
+
+            if (count == 0) return true;
+
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+
+            pollfd pollDescriptor = { descriptor, POLLIN, 0 };
+            if (poll(&pollDescriptor, 1, timeout) != 1) return false;
+        }
+    }
+
+    bool DecodeChunked(const std::string& data, std::size_t position, std::string& body)
+    {
+        while (true)
+        {
+            const std::size_t lineEnd = data.find("\r\n", position);
+            if (lineEnd == std::string::npos) return false;
+
+            const std::size_t size = std::strtoull(data.substr(position, lineEnd - position).c_str(), nullptr, 16);
+            position = lineEnd + 2;
+
+            if (size == 0) return true;
+            if (position + size > data.size()) return false;
+
+            body.append(data, position, size);
+            position += size + 2;
+        }
+    }
+
+    bool ParseResponse(const std::string& data, HttpClient::Response& response)
+    {
+        const std::size_t headerEnd = data.find("\r\n\r\n");
+        if (headerEnd == std::string::npos) return false;
+
+        // 'HTTP/1.1 200 OK'
+        const std::size_t statusStart = data.find(' ');
+        if (statusStart == std::string::npos || statusStart > headerEnd) return false;
+
+        response.status = std::atoi(data.c_str() + statusStart + 1);
+
+        bool isChunked = false;
+        std::size_t contentLength = std::string::npos;
+
+        std::size_t lineStart = data.find("\r\n") + 2;
+
+        while (lineStart < headerEnd)
+        {
+            const std::size_t lineEnd = data.find("\r\n", lineStart);
+            const std::string line = data.substr(lineStart, lineEnd - lineStart);
+
+            const std::size_t separator = line.find(':');
+
+            if (separator != std::string::npos)
+            {
+                const std::string name = line.substr(0, separator);
+                const std::size_t valueStart = line.find_first_not_of(' ', separator + 1);
+                const std::string value = valueStart != std::string::npos ? line.substr(valueStart) : "";
+
+                if (strcasecmp(name.c_str(), "Content-Length") == 0)
+                    contentLength = std::strtoull(value.c_str(), nullptr, 10);
+                else if (strcasecmp(name.c_str(), "Transfer-Encoding") == 0 && strcasecmp(value.c_str(), "chunked") == 0)
+                    isChunked = true;
+            }
+
+            lineStart = lineEnd + 2;
+        }
+
+        const std::size_t bodyStart = headerEnd + 4;
+
+        if (isChunked)
+            return DecodeChunked(data, bodyStart, response.body);
+
+        if (contentLength != std::string::npos)
+        {
+            // A short body means the connection was cut
+            if (data.size() - bodyStart < contentLength) return false;
+
+            response.body = data.substr(bodyStart, contentLength);
+            return true;
+        }
+
+        response.body = data.substr(bodyStart);
+        return true;
+    }
+}
+
+bool HttpClient::Request(const std::string& method, const std::string& url, const std::string& body, Response& response, int timeout)
+{
+    Url parsedUrl;
+
+    if (!ParseUrl(url, parsedUrl))
+    {
+        Logger::Debug("'{}' is not a valid 'http://' URL", url);
+        return false;
+    }
+
+    const int descriptor = Connect(parsedUrl, timeout);
+
+    if (descriptor == -1)
+    {
+        Logger::Debug("Failed to connect to '{}:{}'", parsedUrl.host, parsedUrl.port);
+        return false;
+    }
+
+    std::string request = fmt::format(
+        "{} {} HTTP/1.1\r\nHost: {}:{}\r\nUser-Agent: kole\r\nConnection: close\r\nContent-Length: {}\r\n\r\n",
+        method,
+        parsedUrl.path,
+        parsedUrl.host,
+        parsedUrl.port,
+        body.size()
+    );
+
+    request += body;
+
+    std::string data;
+    const bool success = SendAll(descriptor, request, timeout) && ReceiveAll(descriptor, data, timeout);
+
+    close(descriptor);
+
+    response = Response();
+    return success && ParseResponse(data, response);
+}
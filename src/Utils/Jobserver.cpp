@@ -0,0 +1,200 @@
+#include "Utils/Jobserver.hpp"
+#include "Utils/Logger/Logger.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <sstream>
+
+Jobserver::~Jobserver()
+{
+    // Return any tokens that are still held, otherwise they are lost for the whole group
+    while (!m_tokens.empty())
+        Release();
+
+    for (int fd : m_ownedDescriptors)
+        close(fd);
+}
+
+std::unique_ptr<Jobserver> Jobserver::Connect()
+{
+    const char* makeFlags = std::getenv("MAKEFLAGS");
+    if (makeFlags == nullptr) return nullptr;
+
+    const std::string flags = makeFlags;
+
+    // Newer versions of make use '--jobserver-auth', older ones '--jobserver-fds'.
+    // If both are present (or the option is repeated), the last one wins.
+    std::string auth;
+    for (const std::string option : { "--jobserver-fds=", "--jobserver-auth=" })
+    {
+        std::size_t position = flags.rfind(option);
+        if (position == std::string::npos) continue;
+
+        position += option.length();
+        auth = flags.substr(position, flags.find(' ', position) - position);
+    }
+
+    if (auth.empty()) return nullptr;
+
+    std::unique_ptr<Jobserver> jobserver(new Jobserver());
+
+    const std::string fifoPrefix = "fifo:";
+
+    if (auth.rfind(fifoPrefix, 0) == 0)
+    {
+        const std::string path = auth.substr(fifoPrefix.length());
+
+        int fd = open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0)
+        {
+            Logger::Warning("Failed to open jobserver fifo '{}'. Ignoring the jobserver...", path);
+            return nullptr;
+        }
+
+        jobserver->m_readFd = fd;
+        jobserver->m_writeFd = fd;
+        jobserver->m_ownedDescriptors.push_back(fd);
+
+        Logger::Debug("Connected to jobserver fifo '{}'", path);
+        return jobserver;
+    }
+
+    int readFd = -1;
+    int writeFd = -1;
+
+    if (sscanf(auth.c_str(), "%d,%d", &readFd, &writeFd) != 2 || readFd < 0 || writeFd < 0)
+    {
+        Logger::Warning("Jobserver '{}' in MAKEFLAGS is not recognized. Ignoring the jobserver...", auth);
+        return nullptr;
+    }
+
+    // Make only passes the descriptors down to commands it knows are recursive
+    if (fcntl(readFd, F_GETFD) < 0 || fcntl(writeFd, F_GETFD) < 0)
+    {
+        Logger::Warning("Jobserver descriptors in MAKEFLAGS are closed. Prefix the recipe calling kole with '+' to share the jobserver");
+        return nullptr;
+    }
+
+    jobserver->OpenNonBlockingReader(readFd);
+    jobserver->m_writeFd = writeFd;
+
+    Logger::Debug("Connected to jobserver pipe ({}, {})", readFd, writeFd);
+    return jobserver;
+}
+
+std::unique_ptr<Jobserver> Jobserver::Create(std::size_t jobs)
+{
+    int fds[2];
+
+    // NOTE: The descriptors are intentionally not close-on-exec, children need to inherit them
+    if (pipe(fds) != 0)
+    {
+        Logger::Warning("Failed to create a pipe for the jobserver");
+        return nullptr;
+    }
+
+    std::unique_ptr<Jobserver> jobserver(new Jobserver());
+    jobserver->m_isServer = true;
+    jobserver->m_writeFd = fds[1];
+    jobserver->m_ownedDescriptors = { fds[0], fds[1] };
+    jobserver->OpenNonBlockingReader(fds[0]);
+
+    // Kole itself holds the implicit token, so one less is put in the pipe
+    const std::string tokens(jobs > 0 ? jobs - 1 : 0, '+');
+
+    if (!tokens.empty() && write(fds[1], tokens.data(), tokens.size()) != static_cast<ssize_t>(tokens.size()))
+    {
+        Logger::Warning("Failed to fill the jobserver pipe");
+        return nullptr;
+    }
+
+    // Keep the other flags, but drop any stale job limit or jobserver that couldn't be used.
+    // Variable overrides come after '--', so the new flags have to be inserted before them.
+    std::string existingFlags = "";
+    std::string variableOverrides = "";
+
+    if (const char* makeFlags = std::getenv("MAKEFLAGS"))
+    {
+        std::istringstream stream(makeFlags);
+        std::string word;
+
+        while (stream >> word)
+        {
+            if (word == "--")
+            {
+                std::getline(stream, variableOverrides);
+                variableOverrides = " --" + variableOverrides;
+                break;
+            }
+
+            if (word.rfind("-j", 0) == 0 || word.rfind("--jobserver-", 0) == 0)
+                continue;
+
+            existingFlags += word + " ";
+        }
+    }
+
+    // A leading space tells make that there are no single-letter flags
+    const std::string makeFlags = fmt::format(
+        "{} -j{} --jobserver-auth={},{}{}",
+        existingFlags,
+        jobs,
+        fds[0],
+        fds[1],
+        variableOverrides
+    );
+
+    setenv("MAKEFLAGS", makeFlags.c_str(), 1);
+
+    Logger::Debug("Started jobserver with {} job(s), MAKEFLAGS is '{}'", jobs, makeFlags);
+    return jobserver;
+}
+
+bool Jobserver::TryAcquire()
+{
+    if (m_blockingReader)
+    {
+        pollfd descriptor = { m_readFd, POLLIN, 0 };
+        if (poll(&descriptor, 1, 0) <= 0) return false;
+    }
+
+    char token;
+    if (read(m_readFd, &token, 1) != 1) return false;
+
+    m_tokens += token;
+    return true;
+}
+
+void Jobserver::Release()
+{
+    if (m_tokens.empty())
+    {
+        Logger::Warning("Tried to release a jobserver token that wasn't acquired");
+        return;
+    }
+
+    const char token = m_tokens.back();
+    m_tokens.pop_back();
+
+    if (write(m_writeFd, &token, 1) != 1)
+        Logger::Warning("Failed to return a token to the jobserver");
+}
+
+void Jobserver::OpenNonBlockingReader(int inheritedFd)
+{
+    const std::string path = fmt::format("/proc/self/fd/{}", inheritedFd);
+
+    int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+
+    if (fd >= 0)
+    {
+        m_readFd = fd;
+        m_ownedDescriptors.push_back(fd);
+        return;
+    }
+
+    m_readFd = inheritedFd;
+    m_blockingReader = true;
+}
@@ -5,12 +5,23 @@ void LogTypes::EnableDebug()
     LogTypeStatuses[LogType::Debug] = true;
 }
 
+bool LogTypes::IsEnabled(LogType type)
+{
+    // Fatal and Assert can't be stopped from logging
+    if (type == LogType::Fatal || type == LogType::Assert)
+        return true;
+
+    // NOTE: find is used instead of [], which would insert into the map (and this can be called from any thread)
+    auto it = LogTypeStatuses.find(type);
+    return it != LogTypeStatuses.end() && it->second;
+}
+
 // NAMESPACE VARIABLES
 
 // This variable is used to disable any log types
 // Debug is disabled by default, it can be enabled using the '--debug' flag
 std::map<LogTypes::LogType, bool> LogTypes::LogTypeStatuses = {
-    { LogType::Debug,          true },
+    { LogType::Debug,          false },
     { LogType::Info,           true  },
     { LogType::Warning,        true  },
     { LogType::Error,          true  },
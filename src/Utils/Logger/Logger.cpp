@@ -1,48 +1,225 @@
 #include "Utils/Logger/Logger.hpp"
 
+#include <atomic>
+#include <thread>
+#include <cstdio>
+#include <cstdint>
+#include <unistd.h>
+
 using namespace Logger;
 
-void Logger::Log(LogTypes::LogType type, std::string message)
+namespace
 {
-    // Fatal and Assert can't be stopped from logging
-    if (!LogTypes::LogTypeStatuses[type] && type != LogTypes::LogType::Fatal && type != LogTypes::LogType::Assert)
-        return;
+    enum class EntryKind
+    {
+        Text,
+        Status,
+    };
+
+    struct Entry
+    {
+        EntryKind kind;
+        std::string text;
+
+        std::atomic<Entry*> next = nullptr;
+    };
+
+    /**
+     * @brief Writes log entries to stdout from a background thread.
+     *
+     * Entries are passed through an intrusive multiple-producer, single-consumer queue:
+     * producers swap their entry in as the new head without locking,
+     * and the writer thread follows the links from the tail.
+     */
+    class AsyncWriter
+    {
+    public:
+        AsyncWriter()
+        {
+            m_isTerminal = isatty(STDOUT_FILENO);
+            m_thread = std::thread(&AsyncWriter::Run, this);
+        }
+
+        ~AsyncWriter()
+        {
+            Flush();
+
+            m_stopping.store(true);
+            m_signal.fetch_add(1);
+            m_signal.notify_one();
+
+            m_thread.join();
+        }
+
+        void Push(EntryKind kind, std::string text)
+        {
+            Entry* entry = new Entry{ kind, std::move(text) };
+
+            Entry* previous = m_head.exchange(entry, std::memory_order_acq_rel);
+            previous->next.store(entry, std::memory_order_release);
+
+            // NOTE: The count is increased only after the entry is linked,
+            // so the writer never sees a count it can't follow the links for
+            m_pushed.fetch_add(1, std::memory_order_release);
+            m_signal.fetch_add(1, std::memory_order_release);
+            m_signal.notify_one();
+        }
+
+        void Flush()
+        {
+            const std::uint64_t target = m_pushed.load(std::memory_order_acquire);
+
+            std::uint64_t written = m_written.load(std::memory_order_acquire);
+            while (written < target)
+            {
+                m_written.wait(written);
+                written = m_written.load(std::memory_order_acquire);
+            }
+        }
+
+    private:
+        void Run()
+        {
+            std::uint64_t consumed = 0;
+
+            while (true)
+            {
+                const std::uint64_t signal = m_signal.load(std::memory_order_acquire);
+
+                if (consumed == m_pushed.load(std::memory_order_acquire))
+                {
+                    Publish(consumed);
+
+                    if (m_stopping.load()) break;
+
+                    m_signal.wait(signal);
+                    continue;
+                }
+
+                Entry* next = m_tail->next.load(std::memory_order_acquire);
+
+                Write(*next);
+
+                if (m_tail != &m_stub)
+                    delete m_tail;
 
-    printf("%s: %s\n", LogTypes::LogTypePrefixes[type].c_str(), message.c_str());
+                m_tail = next;
+                consumed++;
+
+                // Waiters are woken up in batches, so a burst of messages is written at once
+                if (consumed % 64 == 0)
+                    Publish(consumed);
+            }
+
+            // Leave the terminal on a clean line
+            if (m_isTerminal && !m_status.empty())
+            {
+                fputs("\r\033[K", stdout);
+                fflush(stdout);
+            }
+        }
+
+        void Write(const Entry& entry)
+        {
+            if (entry.kind == EntryKind::Status)
+            {
+                if (!m_isTerminal) return;
+
+                m_status = entry.text;
+                fputs("\r\033[K", stdout);
+                fputs(m_status.c_str(), stdout);
+                return;
+            }
+
+            // The status line is redrawn after the text, so it always stays at the bottom
+            if (m_isTerminal && !m_status.empty())
+                fputs("\r\033[K", stdout);
+
+            fwrite(entry.text.data(), 1, entry.text.size(), stdout);
+
+            if (m_isTerminal && !m_status.empty())
+                fputs(m_status.c_str(), stdout);
+        }
+
+        void Publish(std::uint64_t consumed)
+        {
+            fflush(stdout);
+
+            m_written.store(consumed, std::memory_order_release);
+            m_written.notify_all();
+        }
+
+    private:
+        Entry m_stub;
+
+        std::atomic<Entry*> m_head = &m_stub;
+        Entry* m_tail = &m_stub;
+
+        std::atomic<std::uint64_t> m_pushed = 0;
+        std::atomic<std::uint64_t> m_written = 0;
+
+        // Bumped for every entry and on shutdown, the writer thread sleeps on it
+        std::atomic<std::uint64_t> m_signal = 0;
+        std::atomic<bool> m_stopping = false;
+
+        bool m_isTerminal = false;
+        std::string m_status;
+
+        std::thread m_thread;
+    };
+
+    AsyncWriter& GetWriter()
+    {
+        static AsyncWriter writer;
+        return writer;
+    }
+
+    std::function<void(int)>& GetExitHandler()
+    {
+        static std::function<void(int)> handler;
+        return handler;
+    }
 }
 
-void Logger::Info(std::string message)
+void Logger::Log(LogTypes::LogType type, const std::string& message)
 {
-    Log(LogTypes::LogType::Info, message);
+    if (!LogTypes::IsEnabled(type))
+        return;
+
+    GetWriter().Push(EntryKind::Text, fmt::format("{}: {}\n", LogTypes::LogTypePrefixes.at(type), message));
 }
 
-void Logger::Debug(std::string message)
+void Logger::Output(const std::string& output)
 {
-    Log(LogTypes::LogType::Debug, message);
+    if (output.empty()) return;
+
+    GetWriter().Push(EntryKind::Text, output.back() == '\n' ? output : output + '\n');
 }
 
-void Logger::Warning(std::string message)
+void Logger::Status(const std::string& status)
 {
-    Log(LogTypes::LogType::Warning, message);
+    GetWriter().Push(EntryKind::Status, status);
 }
 
-void Logger::Error(std::string message)
+void Logger::Flush()
 {
-    Log(LogTypes::LogType::Error, message);
+    GetWriter().Flush();
 }
 
-void Logger::Fatal(std::string message)
+void Logger::SetExitHandler(std::function<void(int)> handler)
 {
-    Log(LogTypes::LogType::Fatal, message);
-    Log(LogTypes::LogType::Fatal, "Exiting program...");
-    exit(1);
+    GetExitHandler() = std::move(handler);
 }
 
-void Logger::Assert(bool condition, std::string message)
+void Logger::Exit(int code)
 {
-    if (condition) return;
+    // Taken out first, so an exit from inside the handler doesn't run it again
+    if (std::function<void(int)> handler = std::move(GetExitHandler()); handler)
+    {
+        GetExitHandler() = nullptr;
+        handler(code);
+    }
 
-    Log(LogTypes::LogType::Assert, message);
-    Log(LogTypes::LogType::Assert, "Exiting program...");
-    exit(1);
-}
\ No newline at end of file
+    Flush();
+    exit(code);
+}
@@ -0,0 +1,425 @@
+#include "Utils/ModuleScanner.hpp"
+#include "Utils/Logger/Logger.hpp"
+
+#include <cctype>
+#include <fstream>
+#include <tuple>
+#include <iterator>
+#include <string_view>
+
+namespace
+{
+    bool IsIdentifierCharacter(char c)
+    {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    // Replaces comments with spaces and empties string and character literals, keeping the newlines
+    std::string StripComments(const std::string& text)
+    {
+        std::string result;
+        result.reserve(text.size());
+
+        std::size_t i = 0;
+
+        while (i < text.size())
+        {
+            const char c = text[i];
+            const char next = i + 1 < text.size() ? text[i + 1] : '\0';
+
+            if (c == '/' && next == '/')
+            {
+                while (i < text.size() && text[i] != '\n')
+                    i++;
+
+                continue;
+            }
+
+            if (c == '/' && next == '*')
+            {
+                const std::size_t end = text.find("*/", i + 2);
+                const std::size_t stop = end == std::string::npos ? text.size() : end + 2;
+
+                for (; i < stop; i++)
+                    result += text[i] == '\n' ? '\n' : ' ';
+
+                continue;
+            }
+
+            // Raw strings end at ')delimiter"', they can hold anything else
+            if (c == '"' && i > 0 && text[i - 1] == 'R')
+            {
+                const std::size_t open = text.find('(', i);
+
+                if (open != std::string::npos)
+                {
+                    const std::string terminator = ")" + text.substr(i + 1, open - i - 1) + "\"";
+                    const std::size_t end = text.find(terminator, open);
+                    const std::size_t stop = end == std::string::npos ? text.size() : end + terminator.size();
+
+                    result += "\"\"";
+
+                    for (; i < stop; i++)
+                    {
+                        if (text[i] == '\n')
+                            result += '\n';
+                    }
+
+                    continue;
+                }
+            }
+
+            // The quotes are kept, so that header units ('import "a.hpp";') can still be told apart
+            if (c == '"' || (c == '\'' && !(i > 0 && std::isxdigit(static_cast<unsigned char>(text[i - 1])))))
+            {
+                result += c;
+                i++;
+
+                while (i < text.size() && text[i] != c && text[i] != '\n')
+                    i += text[i] == '\\' ? 2 : 1;
+
+                if (i < text.size() && text[i] == c)
+                    result += c;
+
+                i++;
+                continue;
+            }
+
+            result += c;
+            i++;
+        }
+
+        return result;
+    }
+
+    // Removes attributes ('[[...]]') and whitespace from a module name
+    std::string NormalizeName(const std::string& name)
+    {
+        std::string result;
+
+        for (std::size_t i = 0; i < name.size(); i++)
+        {
+            if (name.compare(i, 2, "[[") == 0)
+            {
+                const std::size_t end = name.find("]]", i);
+                if (end == std::string::npos) break;
+
+                i = end + 1;
+                continue;
+            }
+
+            if (!std::isspace(static_cast<unsigned char>(name[i])))
+                result += name[i];
+        }
+
+        return result;
+    }
+
+    // NOTE: P1689 is JSON, but only a few of its values are needed,
+    // so this is just enough of a parser to find them.
+    struct JsonValue
+    {
+        enum class Type { Null, Boolean, Number, String, Array, Object };
+
+        Type type = Type::Null;
+
+        bool boolean = false;
+        std::string string;
+
+        std::vector<JsonValue> array;
+        std::vector<std::pair<std::string, JsonValue>> object;
+
+        const JsonValue* Get(const std::string& key) const
+        {
+            for (const auto& [name, value] : object)
+            {
+                if (name == key)
+                    return &value;
+            }
+
+            return nullptr;
+        }
+    };
+
+    void SkipWhitespace(const std::string& text, std::size_t& position)
+    {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position])))
+            position++;
+    }
+
+    bool ParseString(const std::string& text, std::size_t& position, std::string& value)
+    {
+        if (position >= text.size() || text[position] != '"') return false;
+        position++;
+
+        while (position < text.size() && text[position] != '"')
+        {
+            char c = text[position++];
+
+            if (c == '\\')
+            {
+                if (position >= text.size()) return false;
+
+                const char escaped = text[position++];
+
+                switch (escaped)
+                {
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case 'r': c = '\r'; break;
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    case 'u':
+                        // Module names and paths are ASCII in practice, other characters are replaced
+                        position += 4;
+                        c = '?';
+                        break;
+                    default: c = escaped; break;
+                }
+            }
+
+            value += c;
+        }
+
+        if (position >= text.size()) return false;
+
+        position++;
+        return true;
+    }
+
+    bool ParseValue(const std::string& text, std::size_t& position, JsonValue& value, int depth = 0)
+    {
+        if (depth > 64) return false;
+
+        SkipWhitespace(text, position);
+        if (position >= text.size()) return false;
+
+        const char c = text[position];
+
+        if (c == '"')
+        {
+            value.type = JsonValue::Type::String;
+            return ParseString(text, position, value.string);
+        }
+
+        if (c == '{' || c == '[')
+        {
+            const bool isObject = c == '{';
+            const char end = isObject ? '}' : ']';
+
+            value.type = isObject ? JsonValue::Type::Object : JsonValue::Type::Array;
+            position++;
+
+            SkipWhitespace(text, position);
+
+            if (position < text.size() && text[position] == end)
+            {
+                position++;
+                return true;
+            }
+
+            while (true)
+            {
+                std::string key;
+
+                if (isObject)
+                {
+                    SkipWhitespace(text, position);
+                    if (!ParseString(text, position, key)) return false;
+
+                    SkipWhitespace(text, position);
+                    if (position >= text.size() || text[position++] != ':') return false;
+                }
+
+                JsonValue element;
+                if (!ParseValue(text, position, element, depth + 1)) return false;
+
+                if (isObject)
+                    value.object.emplace_back(std::move(key), std::move(element));
+                else
+                    value.array.push_back(std::move(element));
+
+                SkipWhitespace(text, position);
+                if (position >= text.size()) return false;
+
+                if (text[position] == ',')
+                {
+                    position++;
+                    continue;
+                }
+
+                if (text[position] != end) return false;
+
+                position++;
+                return true;
+            }
+        }
+
+        for (const auto& [literal, type, boolean] : { std::tuple{ "true", JsonValue::Type::Boolean, true }, { "false", JsonValue::Type::Boolean, false }, { "null", JsonValue::Type::Null, false } })
+        {
+            if (text.compare(position, std::char_traits<char>::length(literal), literal) == 0)
+            {
+                value.type = type;
+                value.boolean = boolean;
+                position += std::char_traits<char>::length(literal);
+                return true;
+            }
+        }
+
+        // Numbers are only skipped, none of the needed values are numbers
+        const std::size_t start = position;
+
+        while (position < text.size() && (std::isdigit(static_cast<unsigned char>(text[position])) || std::string_view("+-.eE").find(text[position]) != std::string_view::npos))
+            position++;
+
+        value.type = JsonValue::Type::Number;
+        return position > start;
+    }
+}
+
+bool ModuleScanner::Scan(const std::string& path, ModuleUnit& unit)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    const std::string text = StripComments(std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()));
+
+    unit = ModuleUnit();
+
+    // The module the source belongs to, which partitions ('import :detail;') are relative to
+    std::string currentModule;
+    bool isLineStart = true;
+
+    for (std::size_t i = 0; i < text.size(); i++)
+    {
+        const char c = text[i];
+
+        if (c == '\n')
+        {
+            isLineStart = true;
+            continue;
+        }
+
+        if (std::isspace(static_cast<unsigned char>(c))) continue;
+
+        if (!isLineStart) continue;
+        isLineStart = false;
+
+        // Module declarations can only start a line (preprocessor lines are skipped as well)
+        std::size_t position = i;
+        bool isExported = false;
+
+        auto MatchWord = [&](const char* word)
+        {
+            const std::size_t length = std::char_traits<char>::length(word);
+
+            if (text.compare(position, length, word) != 0) return false;
+            if (position + length < text.size() && IsIdentifierCharacter(text[position + length])) return false;
+
+            position += length;
+            while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) position++;
+
+            return true;
+        };
+
+        if (MatchWord("export"))
+            isExported = true;
+
+        const bool isModule = MatchWord("module");
+        const bool isImport = !isModule && MatchWord("import");
+
+        if (!isModule && !isImport) continue;
+
+        const std::size_t end = text.find(';', position);
+        if (end == std::string::npos) break;
+
+        const std::string name = NormalizeName(text.substr(position, end - position));
+
+        // Anything that isn't a name (e.g. 'import(x);' calling a function named 'import') isn't a declaration
+        if (name.find_first_of("(){}=,") != std::string::npos) continue;
+
+        i = end;
+
+        if (isModule)
+        {
+            // 'module;' starts the global module fragment, 'module :private;' the private one
+            if (name.empty() || name == ":private") continue;
+
+            currentModule = name.substr(0, name.find(':'));
+
+            if (isExported || name.find(':') != std::string::npos)
+            {
+                unit.provides = name;
+                unit.isInterface = isExported;
+            }
+            else
+            {
+                // An implementation unit implicitly imports the interface of its module
+                unit.imports.push_back(name);
+            }
+
+            continue;
+        }
+
+        if (name.starts_with('<') || name.starts_with('"'))
+        {
+            Logger::Warning("Header unit '{}' imported in '{}' isn't supported, include it instead", name, path);
+            continue;
+        }
+
+        unit.imports.push_back(name.starts_with(':') ? currentModule + name : name);
+    }
+
+    return true;
+}
+
+bool ModuleScanner::ReadP1689(const std::string& path, ModuleUnit& unit)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    JsonValue root;
+    std::size_t position = 0;
+
+    if (!ParseValue(text, position, root) || root.type != JsonValue::Type::Object)
+        return false;
+
+    const JsonValue* rules = root.Get("rules");
+
+    if (rules == nullptr || rules->type != JsonValue::Type::Array || rules->array.empty())
+        return false;
+
+    const JsonValue& rule = rules->array.front();
+
+    unit = ModuleUnit();
+
+    if (const JsonValue* provides = rule.Get("provides"); provides != nullptr && !provides->array.empty())
+    {
+        const JsonValue& provided = provides->array.front();
+
+        if (const JsonValue* name = provided.Get("logical-name"))
+            unit.provides = name->string;
+
+        // NOTE: 'is-interface' defaults to true
+        const JsonValue* isInterface = provided.Get("is-interface");
+        unit.isInterface = isInterface == nullptr || isInterface->boolean;
+    }
+
+    if (const JsonValue* requirements = rule.Get("requires"))
+    {
+        for (const JsonValue& required : requirements->array)
+        {
+            const JsonValue* name = required.Get("logical-name");
+
+            // Header units have a lookup method, and they aren't supported
+            if (name == nullptr || required.Get("lookup-method") != nullptr)
+                continue;
+
+            unit.imports.push_back(name->string);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,280 @@
+#include "Utils/PackageConfig.hpp"
+#include "Utils/Logger/Logger.hpp"
+#include "Utils/Process.hpp"
+
+#include <set>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// NOTE: The cache is a plain text file:
+// kole-pkg-config <version>
+// environment TAB <variables>
+// packages TAB <names>
+// file TAB <path> TAB <modification time>   (one line per file)
+// flags TAB <flags>
+
+namespace
+{
+    const std::vector<std::string> environmentVariables = {
+        "PKG_CONFIG_PATH",
+        "PKG_CONFIG_LIBDIR",
+        "PKG_CONFIG_SYSROOT_DIR",
+    };
+
+    std::vector<std::string> SplitPath(const std::string& path)
+    {
+        std::vector<std::string> directories;
+        std::istringstream stream(path);
+
+        std::string directory;
+        while (std::getline(stream, directory, ':'))
+        {
+            if (!directory.empty())
+                directories.push_back(directory);
+        }
+
+        return directories;
+    }
+
+    std::string Trim(const std::string& text)
+    {
+        const std::size_t start = text.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos) return "";
+
+        return text.substr(start, text.find_last_not_of(" \t\r\n") - start + 1);
+    }
+}
+
+bool PackageConfig::Resolve(const std::vector<std::string>& packages, std::string& flags)
+{
+    if (packages.empty())
+    {
+        flags = "";
+        return true;
+    }
+
+    std::string packageList;
+    for (const auto& package : packages)
+        packageList += (packageList.empty() ? "" : " ") + package;
+
+    const std::string environment = GetEnvironment();
+
+    if (LoadCache(environment, packageList, flags))
+    {
+        Logger::Debug("Using cached flags for package(s) '{}'", packageList);
+        return true;
+    }
+
+    // NOTE: Only stdout holds the flags, warnings on stderr would otherwise be passed to the compiler
+    std::string output;
+    std::string errorOutput;
+    const int exitCode = Process::Run(fmt::format("pkg-config --cflags --libs {}", packageList), output, errorOutput);
+
+    if (exitCode != 0)
+    {
+        Logger::Error("Failed to resolve package(s) '{}' with pkg-config", packageList);
+
+        if (!errorOutput.empty())
+            Logger::Output(errorOutput);
+
+        return false;
+    }
+
+    if (!Trim(errorOutput).empty())
+        Logger::Debug("pkg-config reported for package(s) '{}': {}", packageList, Trim(errorOutput));
+
+    flags = Trim(output);
+    Logger::Debug("Resolved package(s) '{}' to '{}'", packageList, flags);
+
+    SaveCache({ environment, packageList, GetDependencyFiles(packages), flags });
+    return true;
+}
+
+bool PackageConfig::LoadCache(const std::string& environment, const std::string& packages, std::string& flags)
+{
+    std::ifstream file(m_cachePath);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    std::getline(file, line);
+
+    if (line != fmt::format("kole-pkg-config {}", m_version))
+        return false;
+
+    bool hasFlags = false;
+
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+
+        std::string key;
+        std::getline(stream, key, '\t');
+
+        std::string value;
+        std::getline(stream, value, '\t');
+
+        if (key == "environment" && value != environment)
+            return false;
+
+        if (key == "packages" && value != packages)
+            return false;
+
+        if (key == "file")
+        {
+            std::string modificationTime;
+            std::getline(stream, modificationTime, '\t');
+
+            if (GetModificationTime(value) != modificationTime)
+            {
+                Logger::Debug("'{}' changed since the packages were resolved", value);
+                return false;
+            }
+        }
+
+        if (key == "flags")
+        {
+            flags = value;
+            hasFlags = true;
+        }
+    }
+
+    return hasFlags;
+}
+
+void PackageConfig::SaveCache(const CacheEntry& entry)
+{
+    try
+    {
+        const fs::path cachePath = m_cachePath;
+        fs::create_directories(cachePath.parent_path());
+
+        // Write to a temporary file first, so an interrupted save doesn't leave half of a cache behind
+        const fs::path temporaryPath = cachePath.string() + ".tmp";
+
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::Warning("Failed to open '{}' for writing the package cache", temporaryPath.string());
+            return;
+        }
+
+        file << fmt::format("kole-pkg-config {}\n", m_version);
+        file << "environment\t" << entry.environment << '\n';
+        file << "packages\t" << entry.packages << '\n';
+
+        for (const auto& [path, modificationTime] : entry.files)
+            file << "file\t" << path << '\t' << modificationTime << '\n';
+
+        file << "flags\t" << entry.flags << '\n';
+
+        file.close();
+        fs::rename(temporaryPath, cachePath);
+    }
+    catch (const std::exception& e)
+    {
+        Logger::Warning("Failed to save the package cache: {}", e.what());
+    }
+}
+
+std::vector<std::pair<std::string, std::string>> PackageConfig::GetDependencyFiles(const std::vector<std::string>& packages)
+{
+    const char* configPath = getenv("PKG_CONFIG_PATH");
+    const char* libraryDirectory = getenv("PKG_CONFIG_LIBDIR");
+
+    std::vector<std::string> directories = SplitPath(configPath != nullptr ? configPath : "");
+
+    // PKG_CONFIG_LIBDIR replaces the directories pkg-config was built with
+    if (libraryDirectory != nullptr)
+    {
+        const auto libraryDirectories = SplitPath(libraryDirectory);
+        directories.insert(directories.end(), libraryDirectories.begin(), libraryDirectories.end());
+    }
+    else
+    {
+        std::string output;
+        std::string errorOutput;
+        if (Process::Run("pkg-config --variable pc_path pkg-config", output, errorOutput) == 0)
+        {
+            const auto defaultDirectories = SplitPath(Trim(output));
+            directories.insert(directories.end(), defaultDirectories.begin(), defaultDirectories.end());
+        }
+    }
+
+    std::vector<std::pair<std::string, std::string>> files;
+
+    for (const auto& directory : directories)
+        files.push_back({ directory, GetModificationTime(directory) });
+
+    // NOTE: The flags of a package include the ones of the packages it requires,
+    // so their .pc files can change the flags just as well
+    std::set<std::string> visitedPackages;
+    std::vector<std::string> pendingPackages = packages;
+
+    while (!pendingPackages.empty())
+    {
+        const std::string package = pendingPackages.back();
+        pendingPackages.pop_back();
+
+        if (!visitedPackages.insert(package).second) continue;
+
+        for (const auto& directory : directories)
+        {
+            const std::string path = (fs::path(directory) / (package + ".pc")).string();
+
+            if (!fs::exists(path)) continue;
+
+            files.push_back({ path, GetModificationTime(path) });
+            break;
+        }
+
+        // One required package per line, possibly followed by a version ('glib-2.0 >= 2.50')
+        std::string output;
+        std::string errorOutput;
+
+        if (Process::Run(fmt::format("pkg-config --print-requires {0} && pkg-config --print-requires-private {0}", package), output, errorOutput) != 0)
+            continue;
+
+        std::istringstream lines(output);
+        std::string line;
+
+        while (std::getline(lines, line))
+        {
+            std::istringstream words(line);
+            std::string requiredPackage;
+
+            if (words >> requiredPackage)
+                pendingPackages.push_back(requiredPackage);
+        }
+    }
+
+    return files;
+}
+
+std::string PackageConfig::GetModificationTime(const std::string& path)
+{
+    std::error_code error;
+    const auto time = fs::last_write_time(path, error);
+
+    if (error) return "-";
+
+    return std::to_string(time.time_since_epoch().count());
+}
+
+std::string PackageConfig::GetEnvironment()
+{
+    std::string environment;
+
+    for (const auto& variable : environmentVariables)
+    {
+        const char* value = getenv(variable.c_str());
+
+        if (!environment.empty()) environment += ' ';
+        environment += fmt::format("{}={}", variable, value != nullptr ? value : "");
+    }
+
+    return environment;
+}
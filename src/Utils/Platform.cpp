@@ -16,14 +16,14 @@ void Platform::SetPlatform(std::string platformName)
 
         if (platformName == mapPlatformName)
         {
-            Logger::Debug(fmt::format("Platform '{}' specified. Adjusting build settings.", platformName));
+            Logger::Debug("Platform '{}' specified. Adjusting build settings.", platformName);
             
             savedPlatform = key;
             return;
         }
     }
 
-    Logger::Warning(fmt::format("Platform '{}' not recognized. Defaulting to '{}'.", platformName, GetPlatformName()));
+    Logger::Warning("Platform '{}' not recognized. Defaulting to '{}'.", platformName, GetPlatformName());
 }
 
 int Platform::GetPlatform()
@@ -47,7 +47,7 @@ int Platform::GetPlatform()
 
     savedPlatform = platform;
 
-    Logger::Debug(fmt::format("Operating system is {}", GetPlatformName()));
+    Logger::Debug("Operating system is {}", GetPlatformName());
     return platform;
 }
 
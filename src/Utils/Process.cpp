@@ -0,0 +1,324 @@
+#include "Utils/Process.hpp"
+
+#include <spawn.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <cerrno>
+
+extern char** environ;
+
+namespace
+{
+    // Self-pipe written to by the SIGCHLD handler
+    int childSignalPipe[2] = { -1, -1 };
+
+    // Self-pipe the SIGINT and SIGTERM handler writes the signal number to
+    int interruptPipe[2] = { -1, -1 };
+
+    void HandleChildSignal(int)
+    {
+        const int savedErrno = errno;
+
+        const char byte = 0;
+        [[maybe_unused]] ssize_t written = write(childSignalPipe[1], &byte, 1);
+
+        errno = savedErrno;
+    }
+
+    void HandleInterrupt(int signal)
+    {
+        const int savedErrno = errno;
+
+        const char byte = static_cast<char>(signal);
+        [[maybe_unused]] ssize_t written = write(interruptPipe[1], &byte, 1);
+
+        errno = savedErrno;
+    }
+
+    void SetInterruptHandler(void (*handler)(int))
+    {
+        struct sigaction action = {};
+        action.sa_handler = handler;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+    }
+
+    bool WaitForChild(pid_t pid, int options, Process::ProcessResult& result)
+    {
+        int status;
+        struct rusage usage = {};
+
+        // NOTE: wait4 reports the usage of the child together with the children it waited for,
+        // so the peak memory of the shell includes the compiler it ran
+        pid_t waited;
+        do
+        {
+            waited = wait4(pid, &status, options, &usage);
+        }
+        while (waited < 0 && errno == EINTR);
+
+        if (waited == 0) return false;
+
+        if (waited < 0)
+        {
+            result.exitCode = -1;
+            return true;
+        }
+
+        if (WIFEXITED(status))
+            result.exitCode = WEXITSTATUS(status);
+        else if (WIFSIGNALED(status))
+            result.exitCode = 128 + WTERMSIG(status);
+        else
+            result.exitCode = -1;
+
+        // ru_maxrss is in kilobytes on Linux
+        result.peakMemory = static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+
+        result.userTime = static_cast<std::uint64_t>(usage.ru_utime.tv_sec) * 1000000 + usage.ru_utime.tv_usec;
+        result.systemTime = static_cast<std::uint64_t>(usage.ru_stime.tv_sec) * 1000000 + usage.ru_stime.tv_usec;
+
+        result.blockInputs = static_cast<std::uint64_t>(usage.ru_inblock);
+        result.blockOutputs = static_cast<std::uint64_t>(usage.ru_oublock);
+
+        result.voluntarySwitches = static_cast<std::uint64_t>(usage.ru_nvcsw);
+        result.involuntarySwitches = static_cast<std::uint64_t>(usage.ru_nivcsw);
+
+        return true;
+    }
+}
+
+pid_t Process::Spawn(const std::string& command, int* outputDescriptor, bool isGroupLeader, int* errorDescriptor)
+{
+    // Make sure the handler is installed before the child can exit
+    GetChildSignalDescriptor();
+
+    const char* argv[] = { "sh", "-c", command.c_str(), nullptr };
+
+    // NOTE: A process group of 0 makes the child the leader of a new group with its own id
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+
+    if (isGroupLeader)
+    {
+        posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+        posix_spawnattr_setpgroup(&attributes, 0);
+    }
+
+    if (outputDescriptor == nullptr)
+    {
+        pid_t pid;
+        const int error = posix_spawn(&pid, "/bin/sh", nullptr, &attributes, const_cast<char**>(argv), environ);
+
+        posix_spawnattr_destroy(&attributes);
+
+        return error == 0 ? pid : -1;
+    }
+
+    // NOTE: Both ends are close-on-exec, dup2 clears the flag on the copies the child gets
+    int outputPipe[2];
+    if (pipe2(outputPipe, O_CLOEXEC) != 0)
+    {
+        posix_spawnattr_destroy(&attributes);
+        return -1;
+    }
+
+    // Without a pipe of its own, stderr shares the one of stdout
+    int errorPipe[2] = { outputPipe[0], outputPipe[1] };
+    if (errorDescriptor != nullptr && pipe2(errorPipe, O_CLOEXEC) != 0)
+    {
+        close(outputPipe[0]);
+        close(outputPipe[1]);
+        posix_spawnattr_destroy(&attributes);
+        return -1;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, outputPipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, errorPipe[1], STDERR_FILENO);
+
+    pid_t pid;
+    const int error = posix_spawn(&pid, "/bin/sh", &actions, &attributes, const_cast<char**>(argv), environ);
+
+    posix_spawn_file_actions_destroy(&actions);
+    posix_spawnattr_destroy(&attributes);
+    close(outputPipe[1]);
+
+    if (errorDescriptor != nullptr)
+        close(errorPipe[1]);
+
+    if (error != 0)
+    {
+        close(outputPipe[0]);
+
+        if (errorDescriptor != nullptr)
+            close(errorPipe[0]);
+
+        return -1;
+    }
+
+    fcntl(outputPipe[0], F_SETFL, fcntl(outputPipe[0], F_GETFL) | O_NONBLOCK);
+    *outputDescriptor = outputPipe[0];
+
+    if (errorDescriptor != nullptr)
+    {
+        fcntl(errorPipe[0], F_SETFL, fcntl(errorPipe[0], F_GETFL) | O_NONBLOCK);
+        *errorDescriptor = errorPipe[0];
+    }
+
+    return pid;
+}
+
+void Process::Kill(pid_t pid, int signal)
+{
+    // The child isn't a group leader if it wasn't spawned as one (or it already exited)
+    if (kill(-pid, signal) != 0)
+        kill(pid, signal);
+}
+
+bool Process::ReadAvailable(int descriptor, std::string& output)
+{
+    char buffer[4096];
+
+    while (true)
+    {
+        const ssize_t count = read(descriptor, buffer, sizeof(buffer));
+
+        if (count > 0)
+        {
+            output.append(buffer, count);
+            continue;
+        }
+
+        if (count < 0 && errno == EINTR) continue;
+
+        // Nothing to read right now, but the child might still write more
+        return count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+int Process::Run(const std::string& command, std::string& output, ProcessResult* result)
+{
+    int outputDescriptor = -1;
+    const pid_t pid = Spawn(command, &outputDescriptor);
+
+    if (pid < 0) return -1;
+
+    struct pollfd descriptor = { outputDescriptor, POLLIN, 0 };
+
+    // Read until the child closes its end, it might not fit in the pipe otherwise
+    while (ReadAvailable(outputDescriptor, output))
+        poll(&descriptor, 1, -1);
+
+    close(outputDescriptor);
+
+    ProcessResult childResult;
+    WaitForChild(pid, 0, childResult);
+
+    if (result != nullptr)
+        *result = childResult;
+
+    return childResult.exitCode;
+}
+
+int Process::Run(const std::string& command, std::string& output, std::string& errorOutput)
+{
+    int outputDescriptor = -1;
+    int errorDescriptor = -1;
+    const pid_t pid = Spawn(command, &outputDescriptor, false, &errorDescriptor);
+
+    if (pid < 0) return -1;
+
+    struct pollfd descriptors[] = { { outputDescriptor, POLLIN, 0 }, { errorDescriptor, POLLIN, 0 } };
+
+    // Both pipes are read together, the child could block on a full one otherwise.
+    // A negative descriptor is ignored by poll, so a closed pipe drops out.
+    while (descriptors[0].fd >= 0 || descriptors[1].fd >= 0)
+    {
+        if (descriptors[0].fd >= 0 && !ReadAvailable(outputDescriptor, output))
+            descriptors[0].fd = -1;
+
+        if (descriptors[1].fd >= 0 && !ReadAvailable(errorDescriptor, errorOutput))
+            descriptors[1].fd = -1;
+
+        if (descriptors[0].fd >= 0 || descriptors[1].fd >= 0)
+            poll(descriptors, 2, -1);
+    }
+
+    close(outputDescriptor);
+    close(errorDescriptor);
+
+    ProcessResult result;
+    WaitForChild(pid, 0, result);
+
+    return result.exitCode;
+}
+
+void Process::Wait(pid_t pid, ProcessResult& result)
+{
+    WaitForChild(pid, 0, result);
+}
+
+bool Process::TryWait(pid_t pid, ProcessResult& result)
+{
+    return WaitForChild(pid, WNOHANG, result);
+}
+
+int Process::GetChildSignalDescriptor()
+{
+    if (childSignalPipe[0] != -1) return childSignalPipe[0];
+
+    if (pipe2(childSignalPipe, O_CLOEXEC | O_NONBLOCK) != 0)
+        return -1;
+
+    struct sigaction action = {};
+    action.sa_handler = HandleChildSignal;
+    action.sa_flags = SA_RESTART | SA_NOCLDSTOP;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGCHLD, &action, nullptr);
+
+    return childSignalPipe[0];
+}
+
+void Process::DrainChildSignals()
+{
+    char buffer[64];
+    while (read(childSignalPipe[0], buffer, sizeof(buffer)) > 0) {}
+}
+
+int Process::CatchInterrupts()
+{
+    if (interruptPipe[0] == -1 && pipe2(interruptPipe, O_CLOEXEC | O_NONBLOCK) != 0)
+        return -1;
+
+    SetInterruptHandler(HandleInterrupt);
+
+    return interruptPipe[0];
+}
+
+void Process::ReleaseInterrupts()
+{
+    SetInterruptHandler(SIG_DFL);
+}
+
+int Process::TakeInterrupt()
+{
+    if (interruptPipe[0] == -1) return 0;
+
+    char buffer[64];
+    int signal = 0;
+
+    ssize_t count;
+    while ((count = read(interruptPipe[0], buffer, sizeof(buffer))) > 0)
+        signal = buffer[count - 1];
+
+    return signal;
+}
@@ -85,7 +85,7 @@ bool RegexHelper::MatchesRegex(const std::string& string, const std::vector<std:
         }
         catch (const std::regex_error& e)
         {
-            Logger::Error(fmt::format("Invalid exclude pattern '{}': {}", excludePattern, e.what()));
+            Logger::Error("Invalid exclude pattern '{}': {}", excludePattern, e.what());
         }
     }
 
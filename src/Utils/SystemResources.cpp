@@ -0,0 +1,217 @@
+#include "Utils/SystemResources.hpp"
+#include "Utils/Logger/Logger.hpp"
+
+#include <fstream>
+#include <thread>
+#include <map>
+#include <limits>
+#include <algorithm>
+#include <filesystem>
+
+#ifdef __linux__
+    #include <sched.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const std::string cgroupRoot = "/sys/fs/cgroup";
+
+    /**
+     * @brief Find the cgroup v2 directory of this process (empty if there is none).
+     */
+    const std::string& GetCgroupPath()
+    {
+        static bool resolved = false;
+
+        if (resolved) return SystemResources::cgroupPath;
+        resolved = true;
+
+        std::ifstream file("/proc/self/cgroup");
+        std::string line;
+
+        // The unified (v2) hierarchy is the entry with the id 0 and no controllers, e.g. '0::/user.slice'
+        while (std::getline(file, line))
+        {
+            if (line.rfind("0::", 0) != 0) continue;
+
+            const fs::path path = cgroupRoot + line.substr(3);
+
+            if (fs::exists(path / "cgroup.controllers"))
+                SystemResources::cgroupPath = path.string();
+
+            break;
+        }
+
+        return SystemResources::cgroupPath;
+    }
+
+    /**
+     * @brief Read the first line of a cgroup file in every cgroup up to the root.
+     *
+     * Limits are inherited, so the effective one is the smallest along the way.
+     *
+     * @return The smallest value parsed by the parser, or the maximum value if no limit is set.
+     */
+    template<typename Parser>
+    std::uint64_t ReadCgroupLimit(const std::string& fileName, Parser parse)
+    {
+        std::uint64_t limit = std::numeric_limits<std::uint64_t>::max();
+
+        const std::string& cgroup = GetCgroupPath();
+        if (cgroup.empty()) return limit;
+
+        for (fs::path path = cgroup; path.string().length() >= cgroupRoot.length(); path = path.parent_path())
+        {
+            std::ifstream file(path / fileName);
+            std::string line;
+
+            if (std::getline(file, line))
+                limit = std::min(limit, parse(line));
+
+            if (path == cgroupRoot) break;
+        }
+
+        return limit;
+    }
+
+    /**
+     * @brief Read a field (in bytes) from /proc/meminfo (0 if it's missing).
+     */
+    std::uint64_t ReadMemoryInfo(const std::string& field)
+    {
+        std::ifstream file("/proc/meminfo");
+        std::string name;
+        std::uint64_t value;
+        std::string unit;
+
+        while (file >> name >> value)
+        {
+            std::getline(file, unit);
+
+            if (name == field + ":")
+                return value * 1024;
+        }
+
+        return 0;
+    }
+
+    std::uint64_t ParseLimit(const std::string& value)
+    {
+        if (value.empty() || value == "max")
+            return std::numeric_limits<std::uint64_t>::max();
+
+        return std::stoull(value);
+    }
+}
+
+std::size_t SystemResources::GetCpuLimit()
+{
+    std::size_t limit = std::max(1u, std::thread::hardware_concurrency());
+
+#ifdef __linux__
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        limit = std::min<std::size_t>(limit, std::max(1, CPU_COUNT(&set)));
+#endif
+
+    // 'cpu.max' holds the quota and the period, e.g. '200000 100000' for 2 CPUs
+    const std::uint64_t quota = ReadCgroupLimit("cpu.max", [](const std::string& line) -> std::uint64_t
+    {
+        const std::size_t separator = line.find(' ');
+        const std::uint64_t quota = ParseLimit(line.substr(0, separator));
+
+        if (quota == std::numeric_limits<std::uint64_t>::max() || separator == std::string::npos)
+            return quota;
+
+        const std::uint64_t period = std::max<std::uint64_t>(ParseLimit(line.substr(separator + 1)), 1);
+
+        return std::max<std::uint64_t>((quota + period - 1) / period, 1);
+    });
+
+    limit = std::min<std::uint64_t>(limit, quota);
+
+    Logger::Debug("CPU limit is {}", limit);
+    return limit;
+}
+
+std::uint64_t SystemResources::GetMemoryLimit()
+{
+    const std::uint64_t total = ReadMemoryInfo("MemTotal");
+    const std::uint64_t cgroupLimit = ReadCgroupLimit("memory.max", ParseLimit);
+
+    if (total == 0) return cgroupLimit;
+
+    return std::min(total, cgroupLimit);
+}
+
+std::uint64_t SystemResources::GetAvailableMemory()
+{
+    std::uint64_t available = ReadMemoryInfo("MemAvailable");
+
+    if (available == 0)
+        available = std::numeric_limits<std::uint64_t>::max();
+
+    const std::uint64_t cgroupLimit = ReadCgroupLimit("memory.max", ParseLimit);
+
+    if (cgroupLimit != std::numeric_limits<std::uint64_t>::max())
+    {
+        std::ifstream file(fs::path(GetCgroupPath()) / "memory.current");
+        std::uint64_t current = 0;
+        file >> current;
+
+        available = std::min(available, cgroupLimit > current ? cgroupLimit - current : 0);
+    }
+
+    return available;
+}
+
+std::uint64_t SystemResources::ParseMemorySize(const std::string& size)
+{
+    std::size_t end = 0;
+    double value = 0;
+
+    try
+    {
+        value = std::stod(size, &end);
+    }
+    catch (const std::exception&)
+    {
+        return 0;
+    }
+
+    std::string unit = size.substr(end);
+    transform(unit.begin(), unit.end(), unit.begin(), ::tolower);
+
+    const std::map<std::string, std::uint64_t> multipliers = {
+        { "",      1                     },
+        { "b",     1                     },
+        { "k",     1ull << 10            },
+        { "kb",    1ull << 10            },
+        { "m",     1ull << 20            },
+        { "mb",    1ull << 20            },
+        { "g",     1ull << 30            },
+        { "gb",    1ull << 30            },
+    };
+
+    if (!multipliers.contains(unit) || value < 0)
+        return 0;
+
+    return static_cast<std::uint64_t>(value * multipliers.at(unit));
+}
+
+std::string SystemResources::FormatMemorySize(std::uint64_t bytes)
+{
+    if (bytes >= (1ull << 30))
+        return fmt::format("{:.1f}G", bytes / static_cast<double>(1ull << 30));
+
+    if (bytes >= (1ull << 20))
+        return fmt::format("{:.1f}M", bytes / static_cast<double>(1ull << 20));
+
+    return fmt::format("{}K", bytes >> 10);
+}
+
+// NAMESPACE VARIABLES
+
+std::string SystemResources::cgroupPath = "";
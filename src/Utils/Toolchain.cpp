@@ -0,0 +1,274 @@
+#include "Utils/Toolchain.hpp"
+#include "Utils/Logger/Logger.hpp"
+#include "Utils/Process.hpp"
+#include "Utils/Hash.hpp"
+
+#include <map>
+#include <set>
+#include <fstream>
+#include <unistd.h>
+#include <sstream>
+#include <cstdlib>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// NOTE: Every cache file holds one binary:
+// kole-toolchain <version>
+// <key> TAB <value>   (path, size, modified, version, target and defines)
+// option TAB <option> TAB <1 if the tool accepts it, 0 if it doesn't>
+
+namespace
+{
+    // Tools that run the compiler given after them, and produce what it would
+    const std::set<std::string> compilerWrappers = { "ccache", "sccache", "distcc", "icecc", "buildcache" };
+
+    std::string FirstLine(const std::string& text)
+    {
+        const std::size_t end = text.find('\n');
+        return text.substr(0, end);
+    }
+}
+
+Toolchain::Toolchain(std::string command, ToolKind kind) : m_command(command), m_kind(kind)
+{
+    m_path = FindExecutable(GetToolName(command));
+
+    if (m_path.empty())
+    {
+        // A compiler that isn't known leaves every feature it has to support off, which shouldn't go unnoticed
+        if (m_kind == ToolKind::Compiler)
+            Logger::Warning("'{}' wasn't found in the PATH, so what it supports can't be probed", command);
+        else
+            Logger::Debug("'{}' wasn't found in the PATH, it can't be probed", command);
+
+        return;
+    }
+
+    std::error_code error;
+    m_size = std::to_string(fs::file_size(m_path, error));
+    m_modificationTime = std::to_string(fs::last_write_time(m_path, error).time_since_epoch().count());
+
+    m_cachePath = GetCachePath(m_path);
+
+    if (LoadCache())
+    {
+        Logger::Debug("Using cached probe of '{}' ({})", m_path, m_version);
+        return;
+    }
+
+    Probe();
+    SaveCache();
+}
+
+bool Toolchain::SupportsOption(const std::string& option, const std::string& probeArguments)
+{
+    if (m_path.empty() || m_kind != ToolKind::Compiler)
+        return false;
+
+    auto it = m_options.find(option);
+    if (it != m_options.end()) return it->second;
+
+    std::string output;
+
+    // NOTE: -Werror makes compilers that only warn about unknown options (like clang) fail as well
+    const std::string command = fmt::format("{} -Werror {} -x c++ -E /dev/null -o /dev/null", m_command, probeArguments.empty() ? option : probeArguments);
+    const bool isSupported = Process::Run(command, output) == 0;
+
+    Logger::Debug("'{}' {} '{}'", m_command, isSupported ? "supports" : "doesn't support", option);
+
+    m_options[option] = isSupported;
+    SaveCache();
+
+    return isSupported;
+}
+
+std::string Toolchain::GetFingerprint() const
+{
+    if (!IsFound())
+        return m_command;
+
+    return fmt::format("{} {} {} {}", m_path, m_version, m_target, m_definesHash);
+}
+
+std::string Toolchain::GetToolName(const std::string& command)
+{
+    std::istringstream stream(command);
+    std::string word;
+
+    while (stream >> word)
+    {
+        // Variables set for the tool ('CCACHE_DIR=/tmp/ccache ccache g++')
+        if (word.find('=') != std::string::npos && word.find('/') > word.find('='))
+            continue;
+
+        if (compilerWrappers.contains(fs::path(word).filename().string()))
+            continue;
+
+        return word;
+    }
+
+    return "";
+}
+
+std::string Toolchain::FindExecutable(const std::string& command)
+{
+    std::error_code error;
+
+    if (command.empty())
+        return "";
+
+    if (command.find('/') != std::string::npos)
+    {
+        const fs::path path = fs::canonical(command, error);
+        return error ? "" : path.string();
+    }
+
+    const char* pathVariable = getenv("PATH");
+    if (pathVariable == nullptr) return "";
+
+    std::istringstream stream(pathVariable);
+    std::string directory;
+
+    while (std::getline(stream, directory, ':'))
+    {
+        if (directory.empty()) directory = ".";
+
+        const fs::path candidate = fs::path(directory) / command;
+
+        if (!fs::is_regular_file(candidate, error)) continue;
+
+        const fs::path path = fs::canonical(candidate, error);
+        if (!error) return path.string();
+    }
+
+    return "";
+}
+
+std::string Toolchain::GetCachePath(const std::string& path)
+{
+    const char* cacheHome = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+
+    fs::path cacheDirectory;
+
+    if (cacheHome != nullptr && cacheHome[0] != '\0')
+        cacheDirectory = cacheHome;
+    else if (home != nullptr && home[0] != '\0')
+        cacheDirectory = fs::path(home) / ".cache";
+    else
+        cacheDirectory = fs::temp_directory_path();
+
+    return (cacheDirectory / "kole" / "toolchains" / Hash::ToHex(Hash::Fnv1a(path))).string();
+}
+
+void Toolchain::Probe()
+{
+    Logger::Debug("Probing '{}'...", m_path);
+
+    std::string output;
+
+    if (m_kind == ToolKind::QtTool)
+    {
+        // moc and uic only have a version
+        if (Process::Run(fmt::format("{} -v", m_command), output) == 0)
+            m_version = FirstLine(output);
+
+        return;
+    }
+
+    if (Process::Run(fmt::format("{} --version", m_command), output) == 0)
+        m_version = FirstLine(output);
+
+    output.clear();
+    if (Process::Run(fmt::format("{} -dumpmachine", m_command), output) == 0)
+        m_target = FirstLine(output);
+
+    output.clear();
+    if (Process::Run(fmt::format("{} -dM -E -x c++ /dev/null", m_command), output) == 0)
+        m_definesHash = Hash::ToHex(Hash::Fnv1a(output));
+
+    Logger::Debug("'{}' is '{}' targeting '{}'", m_command, m_version, m_target);
+}
+
+bool Toolchain::LoadCache()
+{
+    std::ifstream file(m_cachePath);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    std::getline(file, line);
+
+    if (line != fmt::format("kole-toolchain {}", m_cacheVersion))
+        return false;
+
+    std::map<std::string, std::string> values;
+    std::map<std::string, bool> options;
+
+    while (std::getline(file, line))
+    {
+        const std::size_t separator = line.find('\t');
+        if (separator == std::string::npos) continue;
+
+        const std::string key = line.substr(0, separator);
+        const std::string value = line.substr(separator + 1);
+
+        if (key == "option")
+        {
+            const std::size_t resultSeparator = value.rfind('\t');
+
+            if (resultSeparator != std::string::npos)
+                options[value.substr(0, resultSeparator)] = value.substr(resultSeparator + 1) == "1";
+        }
+        else
+            values[key] = value;
+    }
+
+    // The binary changed (e.g. the compiler was upgraded), so everything has to be probed again
+    if (values["path"] != m_path || values["size"] != m_size || values["modified"] != m_modificationTime)
+        return false;
+
+    m_version = values["version"];
+    m_target = values["target"];
+    m_definesHash = values["defines"];
+    m_options = options;
+
+    return true;
+}
+
+void Toolchain::SaveCache()
+{
+    try
+    {
+        const fs::path path = m_cachePath;
+        fs::create_directories(path.parent_path());
+
+        // NOTE: Several builds can probe the same compiler at once, so every one writes its own temporary file
+        const fs::path temporaryPath = fmt::format("{}.{}.tmp", m_cachePath, getpid());
+
+        std::ofstream file(temporaryPath, std::ios::trunc);
+        if (!file.is_open())
+        {
+            Logger::Debug("Failed to open '{}' for caching the probe", temporaryPath.string());
+            return;
+        }
+
+        file << fmt::format("kole-toolchain {}\n", m_cacheVersion);
+        file << "path\t" << m_path << '\n';
+        file << "size\t" << m_size << '\n';
+        file << "modified\t" << m_modificationTime << '\n';
+        file << "version\t" << m_version << '\n';
+        file << "target\t" << m_target << '\n';
+        file << "defines\t" << m_definesHash << '\n';
+
+        for (const auto& [option, isSupported] : m_options)
+            file << "option\t" << option << '\t' << (isSupported ? 1 : 0) << '\n';
+
+        file.close();
+        fs::rename(temporaryPath, path);
+    }
+    catch (const std::exception& e)
+    {
+        Logger::Debug("Failed to cache the probe of '{}': {}", m_path, e.what());
+    }
+}
@@ -0,0 +1,125 @@
+#include "Utils/VariantLauncher.hpp"
+
+#include <utility>
+#include <algorithm>
+#include <fmt/core.h>
+
+namespace
+{
+    // NOTE: The features every level adds to the previous one, as far as the compiler's CPU checks know them
+    // (e.g. LZCNT and MOVBE of x86-64-v3 can't be asked for). CPUs don't have the newer features without the older ones in practice.
+    const std::vector<std::pair<std::string, std::vector<std::string>>> levels = {
+        { "x86-64",    {} },
+        { "x86-64-v2", { "popcnt", "sse3", "ssse3", "sse4.1", "sse4.2" } },
+        { "x86-64-v3", { "avx", "avx2", "bmi", "bmi2", "fma" } },
+        { "x86-64-v4", { "avx512f", "avx512bw", "avx512cd", "avx512dq", "avx512vl" } },
+    };
+
+    std::size_t GetLevelIndex(const std::string& variant)
+    {
+        for (std::size_t i = 0; i < levels.size(); i++)
+        {
+            if (levels[i].first == variant)
+                return i;
+        }
+
+        return levels.size();
+    }
+
+    // Quotes a string as a C++ string literal
+    std::string Quote(const std::string& string)
+    {
+        std::string quoted = "\"";
+
+        for (char c : string)
+        {
+            if (c == '"' || c == '\\')
+                quoted += '\\';
+
+            quoted += c;
+        }
+
+        return quoted + "\"";
+    }
+
+    const char* launcherMain = R"(
+int main(int argc, char** argv)
+{
+    __builtin_cpu_init();
+
+    // The variants are next to the launcher, which finds itself through '/proc' where there is one
+    std::string directory = argc > 0 ? argv[0] : "";
+    char path[PATH_MAX];
+
+    const ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+
+    if (length > 0)
+        directory.assign(path, length);
+
+    const std::size_t separator = directory.rfind('/');
+    directory = separator == std::string::npos ? "." : directory.substr(0, separator);
+
+    for (const Variant& variant : variants)
+    {
+        if (!variant.isSupported())
+            continue;
+
+        const std::string binary = directory + "/" + variant.binary;
+        execv(binary.c_str(), argv);
+
+        std::fprintf(stderr, "Failed to run '%s': %s\n", binary.c_str(), std::strerror(errno));
+        return 127;
+    }
+
+    std::fprintf(stderr, "The CPU doesn't support any of the variants this program was built for\n");
+    return 1;
+}
+)";
+}
+
+bool VariantLauncher::IsKnownLevel(const std::string& variant)
+{
+    return GetLevelIndex(variant) < levels.size();
+}
+
+void VariantLauncher::SortLevels(std::vector<std::string>& variants)
+{
+    std::sort(variants.begin(), variants.end(), [](const auto& a, const auto& b) { return GetLevelIndex(a) < GetLevelIndex(b); });
+}
+
+std::string VariantLauncher::GetBinaryName(const std::string& name, const std::string& extension, const std::string& variant)
+{
+    return fmt::format("{}-{}{}{}", name, variant, extension.empty() ? "" : ".", extension);
+}
+
+std::string VariantLauncher::GetSource(const std::string& name, const std::string& extension, const std::vector<std::string>& variants)
+{
+    std::string table;
+
+    // Newest level first, the first one the CPU supports is run
+    for (auto it = variants.rbegin(); it != variants.rend(); ++it)
+    {
+        std::string checks;
+
+        for (std::size_t i = 1; i <= GetLevelIndex(*it) && i < levels.size(); i++)
+        {
+            for (const auto& feature : levels[i].second)
+                checks += fmt::format("{}__builtin_cpu_supports({})", checks.empty() ? "" : " && ", Quote(feature));
+        }
+
+        table += fmt::format(
+            "    {{ {}, []() -> bool {{ return {}; }} }},\n",
+            Quote(GetBinaryName(name, extension, *it)),
+            checks.empty() ? "true" : checks
+        );
+    }
+
+    std::string source = fmt::format("// Generated by kole, runs the best variant of '{}' the CPU supports\n\n", name);
+
+    source += "#include <cerrno>\n#include <climits>\n#include <cstdio>\n#include <cstring>\n#include <string>\n#include <unistd.h>\n\n";
+    source += "struct Variant\n{\n    const char* binary;\n    bool (*isSupported)();\n};\n\n";
+    source += "const Variant variants[] = {\n" + table + "};\n";
+    source += launcherMain;
+
+    return source;
+}
@@ -1,4 +1,6 @@
 #include "Core/ArgumentManager.hpp"
+#include "Core/BuildMetrics.hpp"
+#include "Core/Commands.hpp"
 #include "Core/DirectoryManager.hpp"
 #include "Core/FileCompiler.hpp"
 
@@ -13,6 +15,22 @@ int main(int argc, char** argv)
     if (argumentManager->GetArgumentState(Argument::Debug))
         LogTypes::EnableDebug();
 
+    std::shared_ptr<BuildMetrics> metrics = std::make_shared<BuildMetrics>();
+    const std::string metricsPath = argumentManager->GetArgumentValue(Argument::MetricsJson);
+
+    // NOTE: A build that stops early (e.g. an invalid config) still leaves a record of its failure behind,
+    // a build that got as far as writing the metrics itself already did
+    if (!metricsPath.empty())
+    {
+        Logger::SetExitHandler([metrics, metricsPath](int code)
+        {
+            if (code == 0 || metrics->IsWritten()) return;
+
+            metrics->SetSuccess(false);
+            metrics->Write(metricsPath);
+        });
+    }
+
     const std::string configPath = "./config.kole";
     std::shared_ptr<ConfigReader> configReader = std::make_shared<ConfigReader>(configPath);
 
@@ -22,6 +40,13 @@ int main(int argc, char** argv)
     std::shared_ptr<BuildConfig> config = configReader->GetBuildConfig();
     configReader->PostProcess();
 
+    metrics->AddPhaseTime(BuildPhase::Config, metrics->GetElapsed());
+
+    const std::string command = argumentManager->GetCommand();
+
+    if (!command.empty())
+        Logger::Exit(Commands::Run(command, config, argumentManager));
+
     std::shared_ptr<DirectoryManager> directoryManager = std::make_shared<DirectoryManager>(config);
 
     if (argumentManager->GetArgumentState(Argument::Initialize))
@@ -32,15 +57,38 @@ int main(int argc, char** argv)
     if (argumentManager->GetArgumentState(Argument::Config) || argumentManager->GetArgumentState(Argument::Initialize))
         return 0;
 
-    std::shared_ptr<FileCompiler> fileCompiler = std::make_shared<FileCompiler>(config);
+    BuildOptions options;
+    options.rebuild = argumentManager->GetArgumentState(Argument::Rebuild);
+    options.test = argumentManager->GetArgumentState(Argument::Test);
+    options.explain = argumentManager->GetArgumentState(Argument::Explain);
+
+    if (argumentManager->GetArgumentState(Argument::KeepGoing))
+        options.maxFailures = 0;
+
+    if (argumentManager->GetArgumentState(Argument::MaxFailures))
+        options.maxFailures = argumentManager->GetArgumentNumber(Argument::MaxFailures, 1);
+    options.jobs = argumentManager->GetArgumentNumber(Argument::Jobs, 0);
+    options.metricsPath = metricsPath;
+    options.benchmarkRuns = argumentManager->GetArgumentNumber(Argument::BenchRun, 0);
+    options.benchmarkWarmups = argumentManager->GetArgumentNumber(Argument::BenchWarmup, 1);
+
+    if (argumentManager->GetArgumentState(Argument::BenchCpu))
+        options.benchmarkCpu = static_cast<int>(argumentManager->GetArgumentNumber(Argument::BenchCpu, 0));
+
+    if (argumentManager->GetArgumentState(Argument::Variant))
+        options.variant = argumentManager->GetArgumentValue(Argument::Variant);
+
+    std::shared_ptr<FileCompiler> fileCompiler = std::make_shared<FileCompiler>(config, options, metrics);
 
-    bool rebuild = argumentManager->GetArgumentState(Argument::Rebuild);
-    if (rebuild)
+    if (options.rebuild)
         Logger::Info("Rebuilding all files...");
 
-    fileCompiler->CompileObjectFiles(rebuild);
+    fileCompiler->CompileObjectFiles();
     fileCompiler->LinkObjectFiles();
 
-    if (argumentManager->GetArgumentState(Argument::Autorun))
+    // NOTE: The arguments for the binary come after '--autorun', so a benchmark uses them as well
+    if (options.benchmarkRuns > 0)
+        fileCompiler->BenchmarkBinaryExecutable(argumentManager->GetAutorunArguments());
+    else if (argumentManager->GetArgumentState(Argument::Autorun))
         fileCompiler->RunBinaryExecutable(argumentManager->GetAutorunArguments());
 }
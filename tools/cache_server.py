@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""A minimal object cache server for trying out and testing kole's HTTP cache.
+
+Entries are stored as files under a directory. GET reads one (404 if it's missing),
+PUT replaces one. It isn't meant for production use: there's no authentication,
+and every request is handled on its own thread.
+
+Usage: cache_server.py [--port PORT] [--directory DIRECTORY]
+"""
+
+import argparse
+import os
+import tempfile
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+
+class CacheHandler(BaseHTTPRequestHandler):
+    directory = "."
+
+    def get_path(self):
+        key = self.path.lstrip("/")
+        path = os.path.realpath(os.path.join(self.directory, key))
+
+        # Keys are never allowed to point outside of the directory
+        if not path.startswith(os.path.realpath(self.directory) + os.sep):
+            return None
+
+        return path
+
+    def do_GET(self):
+        path = self.get_path()
+
+        if path is None or not os.path.isfile(path):
+            self.send_error(404)
+            return
+
+        with open(path, "rb") as file:
+            data = file.read()
+
+        self.send_response(200)
+        self.send_header("Content-Length", str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def do_PUT(self):
+        path = self.get_path()
+
+        if path is None:
+            self.send_error(400)
+            return
+
+        data = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+
+        # Written to a temporary file first, so readers never see half of an entry
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        descriptor, temporary_path = tempfile.mkstemp(dir=os.path.dirname(path))
+
+        with os.fdopen(descriptor, "wb") as file:
+            file.write(data)
+
+        os.replace(temporary_path, path)
+
+        self.send_response(201)
+        self.send_header("Content-Length", "0")
+        self.end_headers()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Serves a kole object cache over HTTP")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--directory", default="kole-cache")
+    arguments = parser.parse_args()
+
+    os.makedirs(arguments.directory, exist_ok=True)
+    CacheHandler.directory = arguments.directory
+
+    server = ThreadingHTTPServer(("", arguments.port), CacheHandler)
+    print(f"Serving '{arguments.directory}' on port {arguments.port}")
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()